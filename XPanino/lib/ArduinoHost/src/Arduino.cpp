@@ -0,0 +1,299 @@
+/*********************************************************************************************************//**
+ * @file Arduino.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Implementierung der Nachbildung der Arduino-Funktionen für die Unit-Tests auf dem PC.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#include <Arduino.h>
+
+HardwareSerial Serial;
+
+namespace {
+    const uint8_t PORT_B = 2;   ///< Pins 8 bis 13
+    const uint8_t PORT_C = 3;   ///< Pins 14 bis 19 (A0 bis A5)
+    const uint8_t PORT_D = 4;   ///< Pins 0 bis 7
+
+    unsigned long long hostMicros = 0;              ///< Simulierte Uhr in Mikrosekunden
+    uint8_t pinModes[NUM_DIGITAL_PINS];             ///< Mit pinMode() eingestellte Betriebsart
+    uint8_t pinLevels[NUM_DIGITAL_PINS];            ///< Mit digitalWrite() gesetzter Pegel
+    bool contacts[NUM_DIGITAL_PINS][NUM_DIGITAL_PINS];  ///< Geschlossene Schalter zwischen zwei Pins
+    volatile uint8_t portRegister;                  ///< Zuletzt von portInputRegister() gelesener Port
+    HostPinHook pinHook = nullptr;                  ///< Wird bei jedem digitalWrite() aufgerufen
+
+    /// Zahl im angegebenen Zahlensystem als Text.
+    std::string toText(unsigned long value, const int base) {
+        char digits[sizeof(unsigned long) * 8 + 1];
+        char *pos = &digits[sizeof(digits) - 1];
+        *pos = '\0';
+        do {
+            const unsigned long digit = value % static_cast<unsigned long>(base);
+            *--pos = static_cast<char>((digit < 10) ? '0' + digit : 'A' + digit - 10);
+            value /= static_cast<unsigned long>(base);
+        } while (value > 0);
+        return std::string(pos);
+    }
+
+    std::string toText(const long value, const int base) {
+        if ((value < 0) && (base == DEC)) {
+            return "-" + toText(static_cast<unsigned long>(-value), base);
+        }
+        return toText(static_cast<unsigned long>(value), base);
+    }
+}
+
+
+/*********************************************************************************************************//**
+ * Zeit und Pins
+ ************************************************************************************************************/
+unsigned long millis() { return static_cast<unsigned long>(hostMicros / 1000); }
+
+unsigned long micros() { return static_cast<unsigned long>(hostMicros); }
+
+void delay(const unsigned long ms) { hostAdvanceMillis(ms); }
+
+void delayMicroseconds(const unsigned int us) { hostAdvanceMicros(us); }
+
+
+void pinMode(const uint8_t pin, const uint8_t mode) {
+    if (pin < NUM_DIGITAL_PINS) {
+        pinModes[pin] = mode;
+        if (mode == INPUT_PULLUP) {
+            pinLevels[pin] = HIGH;
+        }
+    }
+}
+
+
+void digitalWrite(const uint8_t pin, const uint8_t level) {
+    if (pin < NUM_DIGITAL_PINS) {
+        pinLevels[pin] = (level == LOW) ? LOW : HIGH;
+    }
+    if (pinHook != nullptr) {
+        pinHook(pin, level);
+    }
+}
+
+
+/**
+ * @brief Ein Eingang liest LOW, wenn er über einen geschlossenen Schalter mit einem Ausgang auf LOW verbunden ist;
+ *        sonst zieht ihn der Pull-up auf HIGH. Ein Ausgang liest seinen eigenen Pegel.
+ */
+int digitalRead(const uint8_t pin) {
+    if (pin >= NUM_DIGITAL_PINS) {
+        return LOW;
+    }
+    if (pinModes[pin] == OUTPUT) {
+        return pinLevels[pin];
+    }
+    for (uint8_t other = 0; other < NUM_DIGITAL_PINS; ++other) {
+        if (contacts[pin][other] && (pinModes[other] == OUTPUT) && (pinLevels[other] == LOW)) {
+            return LOW;
+        }
+    }
+    return (pinModes[pin] == INPUT_PULLUP) ? HIGH : LOW;
+}
+
+
+uint8_t digitalPinToPort(const uint8_t pin) {
+    if (pin < 8) {
+        return PORT_D;
+    }
+    return (pin < 14) ? PORT_B : PORT_C;
+}
+
+
+uint8_t digitalPinToBitMask(const uint8_t pin) {
+    if (pin < 8) {
+        return static_cast<uint8_t>(1U << pin);
+    }
+    return static_cast<uint8_t>(1U << ((pin < 14) ? pin - 8 : pin - 14));
+}
+
+
+/**
+ * @brief Das Eingangsregister eines Ports: die Pegel aller Pins des Ports, beim Aufruf ermittelt.
+ */
+volatile uint8_t *portInputRegister(const uint8_t port) {
+    uint8_t levels = 0;
+    for (uint8_t pin = 0; pin < NUM_DIGITAL_PINS; ++pin) {
+        if ((digitalPinToPort(pin) == port) && (digitalRead(pin) == HIGH)) {
+            levels |= digitalPinToBitMask(pin);
+        }
+    }
+    portRegister = levels;
+    return &portRegister;
+}
+
+
+/*********************************************************************************************************//**
+ * String
+ ************************************************************************************************************/
+String::String(const int value, const unsigned char base) : text(toText(static_cast<long>(value), base)) {}
+
+String::String(const unsigned int value, const unsigned char base)
+    : text(toText(static_cast<unsigned long>(value), base)) {}
+
+String::String(const long value, const unsigned char base) : text(toText(value, base)) {}
+
+String::String(const unsigned long value, const unsigned char base) : text(toText(value, base)) {}
+
+String::String(const double value, const unsigned char decimalPlaces) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.*f", decimalPlaces, value);
+    text = buffer;
+}
+
+
+String String::substring(const unsigned int from) const { return substring(from, length()); }
+
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if (from > to) {
+        const unsigned int swap = from;
+        from = to;
+        to = swap;
+    }
+    if (from >= length()) {
+        return String();
+    }
+    return String(text.substr(from, min(to, length()) - from).c_str());
+}
+
+
+/*********************************************************************************************************//**
+ * HardwareSerial
+ ************************************************************************************************************/
+void HardwareSerial::begin(const unsigned long newBaudRate, const uint8_t) { baudRate = newBaudRate; }
+
+void HardwareSerial::end() {}
+
+int HardwareSerial::available() { return static_cast<int>(input.size()); }
+
+
+int HardwareSerial::read() {
+    if (input.empty()) {
+        return -1;
+    }
+    const int value = static_cast<uint8_t>(input[0]);
+    input.erase(0, 1);
+    return value;
+}
+
+
+int HardwareSerial::availableForWrite() {
+    return (txPending < SERIAL_TX_BUFFER_SIZE - 1) ? static_cast<int>(SERIAL_TX_BUFFER_SIZE - 1 - txPending) : 0;
+}
+
+
+/// Auf dem Arduino wartet flush(), bis alles gesendet ist; hier gilt der Sendepuffer damit als leer.
+void HardwareSerial::flush() { txPending = 0; }
+
+
+size_t HardwareSerial::write(const uint8_t value) {
+    if (availableForWrite() == 0) {
+        ++blockedWrites;
+    } else {
+        ++txPending;
+    }
+    output += static_cast<char>(value);
+    return 1;
+}
+
+
+size_t HardwareSerial::write(const uint8_t *buffer, const size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        write(buffer[i]);
+    }
+    return size;
+}
+
+
+size_t HardwareSerial::print(const char *text) { return write(reinterpret_cast<const uint8_t *>(text), strlen(text)); }
+
+size_t HardwareSerial::print(const __FlashStringHelper *text) { return print(reinterpret_cast<const char *>(text)); }
+
+size_t HardwareSerial::print(const String &text) { return print(text.c_str()); }
+
+size_t HardwareSerial::print(const char c) { return write(static_cast<uint8_t>(c)); }
+
+size_t HardwareSerial::print(const long value, const int base) { return print(toText(value, base).c_str()); }
+
+size_t HardwareSerial::print(const unsigned long value, const int base) { return print(toText(value, base).c_str()); }
+
+size_t HardwareSerial::println() { return print("\r\n"); }
+
+
+void HardwareSerial::hostReset() {
+    input.clear();
+    output.clear();
+    txPending = 0;
+    baudRate = 0;
+    blockedWrites = 0;
+}
+
+
+void HardwareSerial::hostReceive(const uint8_t *data, const size_t size) {
+    input.append(reinterpret_cast<const char *>(data), size);
+}
+
+
+void HardwareSerial::hostReceive(const char *text) { input += text; }
+
+
+std::string HardwareSerial::hostTakeOutput() {
+    std::string sent;
+    sent.swap(output);
+    txPending = 0;
+    return sent;
+}
+
+
+/*********************************************************************************************************//**
+ * Steuerung der Simulation
+ ************************************************************************************************************/
+void hostReset() {
+    hostMicros = 0;
+    memset(pinModes, INPUT, sizeof(pinModes));
+    memset(pinLevels, LOW, sizeof(pinLevels));
+    memset(contacts, 0, sizeof(contacts));
+    pinHook = nullptr;
+    Serial.hostReset();
+}
+
+
+void hostSetMillis(const unsigned long ms) { hostMicros = static_cast<unsigned long long>(ms) * 1000; }
+
+void hostAdvanceMillis(const unsigned long ms) { hostMicros += static_cast<unsigned long long>(ms) * 1000; }
+
+void hostAdvanceMicros(const unsigned long us) { hostMicros += us; }
+
+
+void hostSetContact(const uint8_t pinA, const uint8_t pinB, const bool isClosed) {
+    if ((pinA < NUM_DIGITAL_PINS) && (pinB < NUM_DIGITAL_PINS)) {
+        contacts[pinA][pinB] = isClosed;
+        contacts[pinB][pinA] = isClosed;
+    }
+}
+
+
+uint8_t hostGetPinLevel(const uint8_t pin) { return (pin < NUM_DIGITAL_PINS) ? pinLevels[pin] : LOW; }
+
+void hostSetPinHook(const HostPinHook hook) { pinHook = hook; }
+
+
+/*********************************************************************************************************//**
+ * new und delete wie im Arduino-Core (new.cpp) über malloc() und free(), damit die Zähler der
+ * MemoryMonitorClass (-Wl,--wrap=malloc -Wl,--wrap=free) auch auf dem PC jede Anforderung sehen.
+ ************************************************************************************************************/
+void *operator new(const size_t size) { return malloc(size); }
+
+void *operator new[](const size_t size) { return malloc(size); }
+
+void operator delete(void *ptr) noexcept { free(ptr); }
+
+void operator delete[](void *ptr) noexcept { free(ptr); }
@@ -0,0 +1,191 @@
+/*********************************************************************************************************//**
+ * @file Arduino.h
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Nachbildung der von XPanino benutzten Arduino-Funktionen für die Unit-Tests auf dem PC.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ * Wird nur im Environment @em native gebaut (siehe platformio.ini und library.json). Nachgebildet wird
+ * nur, was die Firmware tatsächlich verwendet. Die Tests steuern die Simulation über die Funktionen
+ * @em host...() und die Methoden @em host...() von @em Serial:
+ * * eine simulierte Uhr für millis() und micros(),
+ * * Pins mit Pull-up und Schalterkontakten zwischen zwei Pins (z.B. Matrixzeile und -spalte),
+ * * eine serielle Schnittstelle, deren Sendepuffer erst durch hostTakeOutput() geleert wird.
+ *
+ ************************************************************************************************************/
+
+#pragma once
+
+#include <ctype.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <type_traits>
+
+/*********************************************************************************************************//**
+ * Konstanten und Makros wie im Arduino-Core
+ ************************************************************************************************************/
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define DEC 10
+#define HEX 16
+#define SERIAL_8N1 0x06
+#define SERIAL_TX_BUFFER_SIZE 64
+#define LED_BUILTIN 13
+#define NUM_DIGITAL_PINS 20
+#define PIN2 2     // Bitnummern der Port-Register wie in <avr/io.h>
+#define PIN3 3
+#define PIN4 4
+#define PIN5 5
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+#define pgm_read_byte(addr) (*reinterpret_cast<const uint8_t *>(addr))
+#define pgm_read_word(addr) (*reinterpret_cast<const uint16_t *>(addr))
+#define pgm_read_dword(addr) (*reinterpret_cast<const uint32_t *>(addr))
+#define pgm_read_ptr(addr) (*reinterpret_cast<void * const *>(addr))
+#define memcpy_P memcpy
+#define strncpy_P strncpy
+#define strcmp_P strcmp
+#define strlen_P strlen
+#define bit(b) (1UL << (b))
+
+typedef uint8_t byte;
+class __FlashStringHelper;
+
+/// min() als Template statt als Makro, damit die Standard-Header (std::min) weiter übersetzt werden.
+template <typename T, typename U> inline typename std::common_type<T, U>::type min(const T &a, const U &b) {
+    return (b < a) ? b : a;
+}
+
+/// max() als Template statt als Makro, damit die Standard-Header (std::max) weiter übersetzt werden.
+template <typename T, typename U> inline typename std::common_type<T, U>::type max(const T &a, const U &b) {
+    return (a < b) ? b : a;
+}
+
+inline bool isAlphaNumeric(const int c) { return isalnum(c) != 0; }
+inline bool isPunct(const int c) { return ispunct(c) != 0; }
+
+
+/*********************************************************************************************************//**
+ * Zeit, Pins und Interrupts
+ ************************************************************************************************************/
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalRead(uint8_t pin);
+uint8_t digitalPinToPort(uint8_t pin);
+uint8_t digitalPinToBitMask(uint8_t pin);
+volatile uint8_t *portInputRegister(uint8_t port);
+
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+
+/*********************************************************************************************************//**
+ * @brief Zeichenkette wie die Klasse @em String des Arduino-Core, intern mit std::string.
+ ************************************************************************************************************/
+class String {
+public:
+    String(const char *text = "") : text(text) {}
+    explicit String(int value, unsigned char base = DEC);
+    explicit String(unsigned int value, unsigned char base = DEC);
+    explicit String(long value, unsigned char base = DEC);
+    explicit String(unsigned long value, unsigned char base = DEC);
+    explicit String(double value, unsigned char decimalPlaces = 2);
+
+    inline const char *c_str() const { return text.c_str(); }
+    inline unsigned int length() const { return static_cast<unsigned int>(text.length()); }
+    inline const char *begin() const { return text.c_str(); }
+    inline const char *end() const { return text.c_str() + text.length(); }
+    inline char operator[](const unsigned int index) const { return (index < text.length()) ? text[index] : '\0'; }
+    inline bool operator==(const char *other) const { return text == other; }
+    inline String &operator+=(const String &other) { text += other.text; return *this; }
+    inline String &operator+=(const char c) { text += c; return *this; }
+    inline String operator+(const String &other) const { String result(*this); result += other; return result; }
+    inline void reserve(unsigned int size) { text.reserve(size); }
+    String substring(unsigned int from) const;
+    String substring(unsigned int from, unsigned int to) const;
+    inline long toInt() const { return atol(text.c_str()); }
+
+private:
+    std::string text;   ///< Inhalt
+};
+
+
+/*********************************************************************************************************//**
+ * @brief Serielle Schnittstelle mit Mitschnitt der gesendeten und Einspeisung der empfangenen Bytes.
+ *
+ * Der Sendepuffer hat wie auf dem Arduino Uno @em SERIAL_TX_BUFFER_SIZE - 1 Bytes. Er wird erst geleert,
+ * wenn der Test die Ausgabe mit hostTakeOutput() abholt. Schreibt die Firmware in den vollen Puffer, würde
+ * sie auf dem Arduino warten; das zählt hostGetBlockedWrites().
+ ************************************************************************************************************/
+class HardwareSerial {
+public:
+    void begin(unsigned long baudRate, uint8_t config = SERIAL_8N1);
+    void end();
+    int available();
+    int read();
+    int availableForWrite();
+    void flush();
+    size_t write(uint8_t value);
+    size_t write(const uint8_t *buffer, size_t size);
+    size_t print(const char *text);
+    size_t print(const __FlashStringHelper *text);
+    size_t print(const String &text);
+    size_t print(char c);
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    inline size_t print(int value, int base = DEC) { return print(static_cast<long>(value), base); }
+    inline size_t print(unsigned int value, int base = DEC) { return print(static_cast<unsigned long>(value), base); }
+    inline size_t print(unsigned char value, int base = DEC) { return print(static_cast<unsigned long>(value), base); }
+    size_t println();
+    template <typename T> inline size_t println(const T &value) { return print(value) + println(); }
+    template <typename T> inline size_t println(const T &value, int base) { return print(value, base) + println(); }
+    inline explicit operator bool() const { return true; }
+
+    // Steuerung der Simulation
+    void hostReset();                                   ///< Puffer, Zähler und Baudrate zurücksetzen
+    void hostReceive(const uint8_t *data, size_t size); ///< Bytes für read() bereitstellen
+    void hostReceive(const char *text);                 ///< Text (ohne '\0') für read() bereitstellen
+    std::string hostTakeOutput();                       ///< Gesendete Bytes abholen und den Sendepuffer leeren
+    inline unsigned long hostGetBaudRate() const { return baudRate; }           ///< Zuletzt eingestellte Baudrate
+    inline unsigned long hostGetBlockedWrites() const { return blockedWrites; } ///< Bytes, auf die gewartet würde
+
+private:
+    std::string input;          ///< Empfangene, noch nicht gelesene Bytes
+    std::string output;         ///< Gesendete, vom Test noch nicht abgeholte Bytes
+    size_t txPending = 0;       ///< Belegung des Sendepuffers
+    unsigned long baudRate = 0; ///< Eingestellte Baudrate
+    unsigned long blockedWrites = 0;    ///< Bytes, die in den vollen Sendepuffer geschrieben wurden
+};
+
+extern HardwareSerial Serial;
+
+
+/*********************************************************************************************************//**
+ * Steuerung der Simulation
+ ************************************************************************************************************/
+void hostReset();                                   ///< Uhr, Pins, Kontakte und Serial zurücksetzen
+void hostSetMillis(unsigned long ms);               ///< Die Uhr auf ms Millisekunden stellen
+void hostAdvanceMillis(unsigned long ms);           ///< Die Uhr um ms Millisekunden weiterlaufen lassen
+void hostAdvanceMicros(unsigned long us);           ///< Die Uhr um us Mikrosekunden weiterlaufen lassen
+void hostSetContact(uint8_t pinA, uint8_t pinB, bool isClosed);    ///< Schalter zwischen zwei Pins schließen/öffnen
+uint8_t hostGetPinLevel(uint8_t pin);               ///< Zuletzt per digitalWrite() gesetzter Pegel
+
+/// Wird bei jedem digitalWrite() aufgerufen, z.B. um die Schieberegister der LED-Matrix nachzubilden.
+using HostPinHook = void (*)(uint8_t pin, uint8_t level);
+void hostSetPinHook(HostPinHook hook);              ///< Hook setzen; @em nullptr = keiner
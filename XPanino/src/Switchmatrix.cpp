@@ -12,6 +12,38 @@
 
 #include <Arduino.h>
 #include <Switchmatrix.hpp>
+#include <devices.hpp>
+#include <txqueue.hpp>
+
+extern TxQueueClass txQueue;
+
+/*********************************************************************************************************//**
+ * Methoden für ScanScheduler
+ *
+ ************************************************************************************************************/
+
+bool ScanScheduler::isScanDue(const unsigned long &now) {
+    burstActive = (now - lastActivityTime) < burstWindow;
+    if ((now - lastScanTime) >= (burstActive ? burstInterval : idleInterval)) {
+        lastScanTime = now;
+        return true;
+    }
+    return false;
+}
+
+
+void ScanScheduler::notifyActivity(const unsigned long &now) {
+    lastActivityTime = now;
+    burstActive = true;
+}
+
+
+void ScanScheduler::setRates(const uint16_t idleInterval, const uint16_t burstInterval, const uint16_t burstWindow) {
+    this->idleInterval = idleInterval;
+    this->burstInterval = burstInterval;
+    this->burstWindow = burstWindow;
+}
+
 
 /*********************************************************************************************************//**
  * Methoden für SwitchMatrix
@@ -32,90 +64,340 @@ void SwitchMatrix::initHardware() {
 
 
 /******************************************************************************/
-void SwitchMatrix::scanSwitchPins() {
-    uint8_t pinStatus = 0;
-    size_t matrixRow = 0;
-    size_t matrixCol = 0;
+void SwitchMatrix::scanSwitchPins(const unsigned long &now) {
+    scanColumns(ALL_MATRIX_COLS, now);
+}
+
+
+bool SwitchMatrix::scanIfDue(const unsigned long &now) {
+    if (! scanScheduler.isScanDue(now)) {
+        return false;
+    }
+    if (scanColumns(ALL_MATRIX_COLS, now)) {
+        scanScheduler.notifyActivity(now);
+    }
+    return true;
+}
+
+
+void SwitchMatrix::enableInterruptMode(const bool enable) {
+    interruptMode = enable;
+    if (interruptMode) {
+        /// Alle Matrixzeilen auf LOW legen, damit jeder Tastendruck sofort eine Flanke an seiner Spalte erzeugt.
+        setAllRows(LOW);
+        lastColLevels = readColumnLevels();
+        setPinChangeInterrupts(true);
+    } else {
+        setPinChangeInterrupts(false);
+        setAllRows(HIGH);
+        pendingCols = 0;
+    }
+}
+
+
+bool SwitchMatrix::scanPendingColumns(const unsigned long &now) {
+    noInterrupts();
+    uint8_t colMask = pendingCols;
+    pendingCols = 0;
+    interrupts();
+    if (colMask == 0) {
+        return false;
+    }
+    scanColumns(colMask, now);
+    scanScheduler.notifyActivity(now);     // auch eine (evtl. prellende) Flanke startet die schnelle Abfrage
+    return true;
+}
+
+
+void SwitchMatrix::onPinChange() {
+    uint8_t levels = readColumnLevels();
+    onColumnEdge(levels ^ lastColLevels);
+    lastColLevels = levels;
+}
+
+
+bool SwitchMatrix::transmitStatus(const bool changedOnly) {
+    if (! transmitPendingSnapshot()) {
+        return false;   // erst muss die Momentaufnahme in die Sendewarteschlange passen
+    }
+    for (uint8_t row = 0; row < SWITCH_MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < SWITCH_MATRIX_COLS; col++) {
+            if (! txQueue.canAddSwitchEvent()) {
+                return false;   // Rest bleibt als geändert markiert und wird beim nächsten Aufruf übertragen
+            }
+            if (changedOnly && switchMatrix[row][col].isChanged()) {
+                switchMatrix[row][col].transmitStatus(row, col, timestampsEnabled, sessionEpoch);  // Methode eines einzelnen Switches
+           } else {
+                if (! changedOnly) {
+                    switchMatrix[row][col].transmitStatus(row, col, timestampsEnabled, sessionEpoch);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+
+void SwitchMatrix::feedDevices(const unsigned long &now) {
+    for (uint8_t row = 0; row < SWITCH_MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < SWITCH_MATRIX_COLS; col++) {
+            const uint8_t switchState = (switchMatrix[row][col].getStatusNoChange() == LOW) ? 1 : 0;
+            devices.onSwitch(row, col, switchState, now);
+        }
+    }
+}
+
+
+void SwitchMatrix::transmitSnapshot() {
+    isSnapshotPending = true;
+    transmitPendingSnapshot();
+}
+
+
+void SwitchMatrix::enableTimestamps(const bool enable, const unsigned long &now) {
+    timestampsEnabled = enable;
+    if (timestampsEnabled) {
+        sessionEpoch = now;
+        transmitTimeSync(now);
+    }
+}
+
+
+void SwitchMatrix::syncTimeIfDue(const unsigned long &now) {
+    if (timestampsEnabled && ((now - lastTimeSync) >= TIME_SYNC_INTERVAL)) {
+        transmitTimeSync(now);
+    }
+}
+
+
+/*********************************************************************************************************//**
+ * ab hier die privaten Methoden
+*************************************************************************************************************/
+
+/**
+ * @brief Eine angeforderte Momentaufnahme in die Sendewarteschlange stellen.
+ *
+ * Die Bitmap wird aus getStatusNoChange() gebildet; noch nicht übertragene Änderungen einzelner Schalter
+ * bleiben dadurch erhalten. Schalter, die ein Gerät selbst verarbeitet (z.B. die Tasten des Transponders),
+ * sind immer 0. Ist die Sendewarteschlange voll, bleibt die Momentaufnahme angefordert und wird
+ * beim nächsten transmitStatus() erneut versucht.
+ *
+ * @return @em true falls keine Momentaufnahme mehr aussteht, sonst @em false.
+ */
+bool SwitchMatrix::transmitPendingSnapshot() {
+    if (! isSnapshotPending) {
+        return true;
+    }
+    if (txQueue.isFull()) {
+        return false;
+    }
+    uint8_t rowBits[SWITCH_MATRIX_ROWS] = {0};
+    for (uint8_t row = 0; row < SWITCH_MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < SWITCH_MATRIX_COLS; col++) {
+            if ((switchMatrix[row][col].getStatusNoChange() == LOW) && ! devices.ownsSwitch(row, col)) {
+                rowBits[row] |= static_cast<uint8_t>(1) << col;
+            }
+        }
+    }
+    isSnapshotPending = ! txQueue.addSnapshot(rowBits, SWITCH_MATRIX_ROWS);
+    return ! isSnapshotPending;
+}
+
+
+/**
+ * @brief Die Schalter der in @em colMask angegebenen Matrixspalten abfragen.
+ *
+ * Die Matrixzeilen (Y) werden nacheinander auf @em LOW gesetzt und dann die Werte der
+ * ausgewählten Matrixspalten (X) als Bitmaske je Zeile eingelesen. Im Interrupt-Betrieb sind die
+ * Pin-Change-Interrupts während der Abfrage abgeschaltet, da das Umschalten der Zeilen selbst
+ * Flanken erzeugt.
+ *
+ * Erst nachdem alle Zeilen eingelesen sind, werden die Bitmasken auf Geisterschaltungen geprüft
+ * (siehe findGhostCols()) und anschließend die Schalterstatus aktualisiert.
+ *
+ * @param colMask Bitmaske der abzufragenden Matrixspalten; @em ALL_MATRIX_COLS für alle Spalten.
+ * @param now Aktueller Zeitstempel in Millisekunden; gilt für Entprellen, Einschaltzeiten und Flanken.
+ * @return @em true falls sich mindestens ein Schalter geändert hat, sonst @em false.
+ */
+bool SwitchMatrix::scanColumns(const uint8_t colMask, const unsigned long &now) {
+    bool anyChanged = false;
+    uint8_t matrixRow = 0;
+    uint8_t matrixCol = 0;
+    uint8_t colBit = 0;
+    uint8_t ghostCols[SWITCH_MATRIX_ROWS];
 
+    if (interruptMode) {
+        setPinChangeInterrupts(false);
+        setAllRows(HIGH);
+    }
     for (uint8_t row = HW_MATRIX_ROWS_LSB_PIN; row <= HW_MATRIX_ROWS_MSB_PIN; ++row) {
+        matrixRow = row - HW_MATRIX_ROWS_LSB_PIN;   // Pin-Nummer auf Matrixzeile umrechnen.
         digitalWrite(row, LOW);     // Die Matrixzeile aktivieren
         for (uint8_t col = HW_MATRIX_COLS_LSB_PIN; col <= HW_MATRIX_COLS_MSB_PIN; ++col) {
-            matrixRow = row - HW_MATRIX_ROWS_LSB_PIN;   // Pin-Nummer auf Matrixzeile umrechnen.
-            matrixCol = col - HW_MATRIX_COLS_LSB_PIN;   // Pin-Nummer auf Matrixspalte umrechnen.
-            if (isValidMatrixPos(matrixRow, matrixCol)) {
-                /// Pinstatus einlesen und entprellen.
-                pinStatus = digitalRead(col);
-                /// Wenn eine Änderung erkannt wurde, den neuen Schalterstatus in der _SwitchMatrix speichern
-                /// und die Einschalt\"zeit\" merken.
-                /// Außerdem die neuen Status an PC übertragen.\n
-                /// @em 0 enspricht geschlossenem Schalter, da bei geschlossenem Schalter
+            colBit = static_cast<uint8_t>(1) << (col - HW_MATRIX_COLS_LSB_PIN);
+            if ((colMask & colBit) != 0) {
+                /// @em LOW enspricht geschlossenem Schalter, da bei geschlossenem Schalter
                 /// das Col-Pin auf @em LOW gezogen wird.
-                if (pinStatus != (switchMatrix[matrixRow][matrixCol]).getStatusNoChange()) {
-                    if (pinStatus == LOW) {
-                        switchMatrix[matrixRow][matrixCol].setOn();
-                    }
-                    else {
-                        switchMatrix[matrixRow][matrixCol].setOff();
-                    };
-                    changed = true;
+                if (digitalRead(col) == LOW) {
+                    pressedCols[matrixRow] |= colBit;
                 } else {
-                    /// Bei den nicht veränderten Schaltern die Einschaltzeiten aktualisieren.
-                    switchMatrix[matrixRow][matrixCol].updateOnTime(millis());
-                    /// Lange Tastendrücke identifizieren und ggf. ein Ereignis auslösen.
-                    switchMatrix[matrixRow][matrixCol].checkLongOn();
+                    pressedCols[matrixRow] &= ~ colBit;
                 }
-            } else {
-                // Ungültige Position, d.h. row oder col außerhalb der Matrix.
-                Serial.print(F("Error 001"));
             }
         }   /// weiter geht's mit der nächsten Spalte
         digitalWrite(row, HIGH);    /// Row-Pin wieder auf HIGH setzen und damit deaktivieren.
     }   /// weiter geht's mit der nächsten Row
-}
+    if (interruptMode) {
+        /// Ruhezustand des Interrupt-Betriebs wiederherstellen.
+        setAllRows(LOW);
+        lastColLevels = readColumnLevels();
+        setPinChangeInterrupts(true);
+    }
 
+    if (findGhostCols(ghostCols)) {
+        ++ghostCount;
+    }
 
-void SwitchMatrix::transmitStatus(const bool changedOnly) {
-    for (uint8_t row = 0; row < SWITCH_MATRIX_ROWS; row++) {
-        for (uint8_t col = 0; col < SWITCH_MATRIX_COLS; col++) {
-            if (changedOnly && switchMatrix[row][col].isChanged()) {
-                switchMatrix[row][col].transmitStatus(row, col);        // Methode eines einzelnen Switches
-           } else {
-                if (! changedOnly) {
-                    switchMatrix[row][col].transmitStatus(row, col);
+    for (matrixRow = 0; matrixRow < SWITCH_MATRIX_ROWS; ++matrixRow) {
+        for (matrixCol = 0; matrixCol < SWITCH_MATRIX_COLS; ++matrixCol) {
+            colBit = static_cast<uint8_t>(1) << matrixCol;
+            if ((colMask & colBit) == 0) {
+                continue;   // Spalte wurde nicht abgefragt
+            }
+            Switch &sw = switchMatrix[matrixRow][matrixCol];
+            uint8_t pinStatus = ((pressedCols[matrixRow] & colBit) != 0) ? LOW : HIGH;
+            /// Wenn eine Änderung erkannt wurde, den neuen Schalterstatus in der _SwitchMatrix speichern
+            /// und die Einschalt\"zeit\" merken.
+            /// Außerdem die neuen Status an PC übertragen.\n
+            /// Änderungen innerhalb der Entprellzeit nach der letzten Änderung sowie Änderungen von
+            /// Schaltern, die Teil einer möglichen Geisterschaltung sind, werden zurückgehalten; der
+            /// endgültige Status wird bei einer späteren Abfrage übernommen.
+            if ((pinStatus != sw.getStatusNoChange()) && ((ghostCols[matrixRow] & colBit) == 0)
+                    && (! sw.isBouncing(now, debounceTime))) {
+                if (pinStatus == LOW) {
+                    sw.setOn(now);
                 }
+                else {
+                    sw.setOff(now);
+                };
+                changed = true;
+                anyChanged = true;
+            } else {
+                /// Bei den nicht veränderten Schaltern die Einschaltzeiten aktualisieren.
+                sw.updateOnTime(now);
+                /// Lange Tastendrücke identifizieren und ggf. ein Ereignis auslösen.
+                sw.checkLongOn();
             }
         }
     }
+    return anyChanged;
 }
 
-#ifdef DEBUG
-/// @brief Schaltermatrix auf Terminal ausgeben.
-void SwitchMatrix::printMatrix() {
-    Serial.println();
-    Serial.print(F("\t"));
-    for (uint8_t col = 0; col < SWITCH_MATRIX_COLS; col++) {
-        Serial.print(F("Col ")); Serial.print(col); Serial.print(F("\t"));
+
+/**
+ * @brief Mögliche Geisterschaltungen in den eingelesenen Bitmasken finden.
+ *
+ * Ohne Dioden an den Schaltern erzeugen drei gedrückte Schalter in den Ecken eines Rechtecks
+ * einen scheinbar gedrückten Schalter in der vierten Ecke. Von außen sind dann alle vier Ecken
+ * nicht zu unterscheiden. Ein solches Rechteck liegt vor, sobald zwei Zeilen mindestens zwei
+ * gedrückte Spalten gemeinsam haben. Alle Schalter in diesen gemeinsamen Spalten beider Zeilen
+ * gelten dann als zweideutig.
+ *
+ * Sind Dioden verbaut (siehe setDiodesFitted()), gibt es keine Geisterschaltungen.
+ *
+ * @param ghostCols Ergebnis: je Zeile die Bitmaske der zweideutigen Spalten.
+ * @return @em true falls mindestens ein zweideutiges Rechteck gefunden wurde, sonst @em false.
+ */
+bool SwitchMatrix::findGhostCols(uint8_t (&ghostCols)[SWITCH_MATRIX_ROWS]) {
+    bool found = false;
+    for (auto &cols : ghostCols) {
+        cols = 0;
     }
-    Serial.println();
-    for (uint8_t col = 0; col <= SWITCH_MATRIX_COLS; col++) {
-        Serial.print(F("--------"));
+    if (diodesFitted) {
+        return false;
     }
-    Serial.println();
-    for (uint8_t row = 0; row < SWITCH_MATRIX_ROWS; row++) {
-        Serial.print(F("Row ")); Serial.print(row); Serial.print(F(":\t"));
-        for (uint8_t col = 0; col < SWITCH_MATRIX_COLS; col++) {
-            Serial.print(row); Serial.print(F(" / ")); Serial.print(col);
-            Serial.print(F("\t"));
+    for (uint8_t row1 = 0; row1 < SWITCH_MATRIX_ROWS - 1; ++row1) {
+        if ((pressedCols[row1] & (pressedCols[row1] - 1)) == 0) {
+            continue;   // höchstens ein Schalter in dieser Zeile gedrückt ==> kein Rechteck möglich
+        }
+        for (uint8_t row2 = row1 + 1; row2 < SWITCH_MATRIX_ROWS; ++row2) {
+            uint8_t common = pressedCols[row1] & pressedCols[row2];
+            if ((common & (common - 1)) != 0) {     // mindestens zwei gemeinsame Spalten
+                ghostCols[row1] |= common;
+                ghostCols[row2] |= common;
+                found = true;
+            }
         }
-        Serial.println();
     }
+    return found;
 }
-#endif
 
 
-/*********************************************************************************************************//**
- * ab hier die privaten Methoden
-*************************************************************************************************************/
+/**
+ * @brief Die Zeitsynchronisation im Format @em S;T;<Zeit> senden. Die Zeit wird hexadezimal in
+ *        Millisekunden seit Sitzungsbeginn angegeben.
+ *
+ * @param now Aktueller Zeitstempel in Millisekunden, z.B. millis()
+ */
+void SwitchMatrix::transmitTimeSync(const unsigned long &now) {
+    lastTimeSync = now;
+    txQueue.addTimeSync(now - sessionEpoch);
+}
+
+
+/**
+ * @brief Alle Matrixzeilen-Pins auf den gleichen Pegel setzen.
+ *
+ * @param level @em HIGH: alle Matrixzeilen deaktivieren.\n
+ *              @em LOW: alle Matrixzeilen aktivieren (Ruhezustand im Interrupt-Betrieb).
+ */
+void SwitchMatrix::setAllRows(const uint8_t level) {
+    for (uint8_t row = HW_MATRIX_ROWS_LSB_PIN; row <= HW_MATRIX_ROWS_MSB_PIN; ++row) {
+        digitalWrite(row, level);
+    }
+}
+
+
+/**
+ * @brief Die Pin-Change-Interrupts für alle Matrixspalten-Pins ein- bzw. ausschalten.
+ *
+ * Beim Einschalten werden zuvor evtl. anstehende Interrupt-Flags gelöscht, damit die beim
+ * Abfragen der Matrix entstandenen Flanken keinen Interrupt mehr auslösen.
+ *
+ * @param enable @em true ==> Interrupts einschalten, @em false ==> ausschalten.
+ */
+void SwitchMatrix::setPinChangeInterrupts(const bool enable) {
+    #ifdef PCICR
+    for (uint8_t col = HW_MATRIX_COLS_LSB_PIN; col <= HW_MATRIX_COLS_MSB_PIN; ++col) {
+        if (enable) {
+            *digitalPinToPCMSK(col) |= bit(digitalPinToPCMSKbit(col));
+            PCIFR |= bit(digitalPinToPCICRbit(col));    // anstehendes Flag löschen (durch Schreiben einer 1)
+            PCICR |= bit(digitalPinToPCICRbit(col));
+        } else {
+            *digitalPinToPCMSK(col) &= ~ bit(digitalPinToPCMSKbit(col));
+        }
+    }
+    #else
+    (void)enable;   // ohne Pin-Change-Interrupts (z.B. auf dem PC) gibt es nichts zu schalten
+    #endif
+}
+
+
+/**
+ * @brief Die Pegel aller Matrixspalten-Pins direkt aus den Port-Registern lesen.
+ *
+ * @return Bitmaske der Spaltenpegel; Bit = 1 ==> Spalte liegt auf @em HIGH.
+ */
+uint8_t SwitchMatrix::readColumnLevels() {
+    uint8_t levels = 0;
+    for (uint8_t col = HW_MATRIX_COLS_LSB_PIN; col <= HW_MATRIX_COLS_MSB_PIN; ++col) {
+        if ((*portInputRegister(digitalPinToPort(col)) & digitalPinToBitMask(col)) != 0) {
+            levels |= static_cast<uint8_t>(1) << (col - HW_MATRIX_COLS_LSB_PIN);
+        }
+    }
+    return levels;
+}
+
 
 /**
  * @brief Prüfen, ob row eine gültige Zeile in der SwitchMatrix ist.
@@ -151,3 +433,16 @@ bool SwitchMatrix::isValidMatrixCol(const uint8_t col) { return ((col >= 0) && (
 bool SwitchMatrix::isValidMatrixPos(const uint8_t row, const uint8_t col) {
     return isValidMatrixRow(row) && isValidMatrixCol(col);
 }
+
+
+/*********************************************************************************************************//**
+ * Interrupt-Routinen
+ *
+ * Die Matrixspalten liegen auf den Pins 6 bis 13, d.h. auf Port D (PCINT2) und Port B (PCINT0).
+*************************************************************************************************************/
+#ifdef PCICR
+extern SwitchMatrix switches;
+
+ISR(PCINT0_vect) { switches.onPinChange(); }
+ISR(PCINT2_vect) { switches.onPinChange(); }
+#endif
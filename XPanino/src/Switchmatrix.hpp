@@ -28,6 +28,76 @@ const unsigned int HW_MATRIX_COLS_LSB_PIN = 6;   ///< Pin-Nummer des niederstwer
 const unsigned int HW_MATRIX_COLS_MSB_PIN = 13;  ///< Pin-Nummer des höchstwertigen Pins der Matrixspalten X
 constexpr uint8_t SWITCH_MATRIX_ROWS = HW_MATRIX_ROWS_MSB_PIN - HW_MATRIX_ROWS_LSB_PIN + 1;  ///< Anzahl Matrixzeilen
 constexpr uint8_t SWITCH_MATRIX_COLS = HW_MATRIX_COLS_MSB_PIN - HW_MATRIX_COLS_LSB_PIN + 1;  ///< Anzahl Matrixspalten
+const uint8_t ALL_MATRIX_COLS = 0xFF;    ///< Spaltenmaske: alle Matrixspalten abfragen
+const bool HW_MATRIX_HAS_DIODES = false; ///< @em true ==> an jedem Schalter der Matrix ist eine Diode verbaut
+const unsigned long TIME_SYNC_INTERVAL = 1000;  ///< Intervall in Millisekunden für die Zeitsynchronisation mit dem PC
+
+static_assert(SWITCH_MATRIX_COLS <= 8, "Die Spaltenmasken (uint8_t) erlauben max. 8 Matrixspalten.");
+static_assert(SWITCH_MATRIX_ROWS <= 4, "Die Momentaufnahme (TxMessage::value) erlaubt max. 4 Matrixzeilen.");
+
+
+/*********************************************************************************************************//**
+ * Konstanten für die adaptive Abfragerate der Schaltermatrix (Defaultwerte).
+ ************************************************************************************************************/
+const uint16_t SCAN_IDLE_INTERVAL = 20;     ///< Abfrageintervall in Millisekunden, solange keine Schalter betätigt werden
+const uint16_t SCAN_BURST_INTERVAL = 1;     ///< Abfrageintervall in Millisekunden nach einer Schalterbetätigung
+const uint16_t SCAN_BURST_WINDOW = 500;     ///< Dauer in Millisekunden der schnellen Abfrage nach der letzten Betätigung
+
+
+/*********************************************************************************************************//**
+ * @brief Taktgeber für die adaptive Abfrage der Schaltermatrix.
+ *
+ * Solange keine Schalter betätigt werden, wird die Matrix nur mit der niedrigen Rate @em idleInterval
+ * abgefragt. Nach jeder Änderung wird für die Dauer von @em burstWindow mit der hohen Rate
+ * @em burstInterval abgefragt, damit schnelle Drehgeberbewegungen und gleichzeitig gedrückte
+ * Tasten sauber erkannt werden. Die frei werdende Rechenzeit steht dem LED-Refresh und der
+ * seriellen Schnittstelle zur Verfügung.
+ *
+ ************************************************************************************************************/
+class ScanScheduler {
+public:
+    /**
+     * @brief Prüfen, ob die nächste Abfrage der Schaltermatrix fällig ist. Falls ja, wird der
+     *        Zeitpunkt der Abfrage gemerkt.
+     *
+     * @param now Aktueller Zeitstempel in Millisekunden, z.B. millis()
+     * @return @em true falls die Schaltermatrix jetzt abgefragt werden soll, sonst @em false.
+     */
+    bool isScanDue(const unsigned long &now);
+
+
+    /**
+     * @brief Eine Schalterbetätigung melden und damit das Zeitfenster für die schnelle Abfrage (neu) starten.
+     *
+     * @param now Aktueller Zeitstempel in Millisekunden, z.B. millis()
+     */
+    void notifyActivity(const unsigned long &now);
+
+
+    /**
+     * @brief Die Abfrageraten einstellen.
+     *
+     * @param idleInterval Abfrageintervall in Millisekunden ohne Schalterbetätigung.
+     * @param burstInterval Abfrageintervall in Millisekunden nach einer Schalterbetätigung.
+     * @param burstWindow Dauer in Millisekunden der schnellen Abfrage nach der letzten Betätigung.
+     */
+    void setRates(uint16_t idleInterval, uint16_t burstInterval, uint16_t burstWindow);
+
+    inline uint16_t getIdleInterval() const { return idleInterval; }
+    inline uint16_t getBurstInterval() const { return burstInterval; }
+    inline uint16_t getBurstWindow() const { return burstWindow; }
+
+    /// @brief Prüfen, ob gerade schnell abgefragt wird.
+    inline bool isBurstActive() const { return burstActive; }
+
+private:
+    uint16_t idleInterval = SCAN_IDLE_INTERVAL;     ///< Abfrageintervall ohne Schalterbetätigung
+    uint16_t burstInterval = SCAN_BURST_INTERVAL;   ///< Abfrageintervall nach Schalterbetätigung
+    uint16_t burstWindow = SCAN_BURST_WINDOW;       ///< Dauer der schnellen Abfrage
+    unsigned long lastScanTime = 0;                 ///< Zeitstempel der letzten Abfrage
+    unsigned long lastActivityTime = 0;             ///< Zeitstempel der letzten Schalterbetätigung
+    bool burstActive = false;                       ///< @em true ==> es wird schnell abgefragt
+};
 
 
 /*********************************************************************************************************//**
@@ -54,8 +124,100 @@ public:
      * @see Externe Doku: Arduino-Doku
      * @todo Statt \@see den richtigen Doxygen-Verweis auf die Arduino-Doku verwenden.
      *
+     * @param now Aktueller Zeitstempel in Millisekunden, z.B. frameClock.getNow()
+     */
+    void scanSwitchPins(const unsigned long &now);
+
+
+    /**
+     * @brief Die Schaltermatrix abfragen, falls das gemäß der adaptiven Abfragerate fällig ist.
+     *
+     * @param now Aktueller Zeitstempel in Millisekunden, z.B. millis()
+     * @return @em true falls die Schaltermatrix abgefragt wurde, sonst @em false.
+     */
+    bool scanIfDue(const unsigned long &now);
+
+
+    /**
+     * @brief Zugriff auf den Taktgeber der adaptiven Abfragerate, z.B. zum Einstellen der Raten.
+     *
+     * @return ScanScheduler& Der Taktgeber der Schaltermatrix.
+     */
+    inline ScanScheduler &getScanScheduler() { return scanScheduler; }
+
+
+    /**
+     * @brief Angeben, ob an den Schaltern der Matrix Dioden verbaut sind.
+     *
+     * Ohne Dioden können beim gleichzeitigen Drücken mehrerer Schalter Geisterschaltungen
+     * entstehen. Deren Änderungen werden dann zurückgehalten, bis sie eindeutig sind.
+     *
+     * @param fitted @em true ==> Dioden sind verbaut; keine Prüfung auf Geisterschaltungen.
      */
-    void scanSwitchPins();
+    inline void setDiodesFitted(const bool fitted) { diodesFitted = fitted; }
+
+
+    /**
+     * @brief Anzahl der Abfragen, bei denen mögliche Geisterschaltungen erkannt wurden.
+     *
+     * @return Anzahl der Abfragen mit zweideutigen Schalterstellungen.
+     */
+    inline uint16_t getGhostCount() const { return ghostCount; }
+
+
+    /**
+     * @brief Den Interrupt-Betrieb der Schaltermatrix ein- bzw. ausschalten.
+     *
+     * Im Interrupt-Betrieb liegen zwischen den Abfragen alle Matrixzeilen (Y) auf @em LOW. Ein
+     * Tastendruck zieht damit sofort die zugehörige Matrixspalte (X) auf @em LOW und löst einen
+     * Pin-Change-Interrupt aus. Die Interrupt-Routine merkt sich nur die betroffene Spalte;
+     * abgefragt wird sie dann in scanPendingColumns() außerhalb des regulären Abfragezyklus.
+     *
+     * @note Wird in einer Spalte bereits ein Schalter gedrückt gehalten, erzeugt ein weiterer Schalter
+     *       in derselben Spalte keine Flanke. Solche Änderungen erkennt erst die nächste reguläre
+     *       Abfrage per scanSwitchPins().
+     *
+     * @param enable @em true ==> Interrupt-Betrieb einschalten, @em false ==> ausschalten.
+     */
+    void enableInterruptMode(bool enable);
+
+
+    /**
+     * @brief Prüfen, ob der Interrupt-Betrieb eingeschaltet ist.
+     *
+     * @return @em true falls der Interrupt-Betrieb eingeschaltet ist, sonst @em false.
+     */
+    inline bool isInterruptModeEnabled() const { return interruptMode; }
+
+
+    /**
+     * @brief Die per Pin-Change-Interrupt gemeldeten Matrixspalten außer der Reihe abfragen.
+     *
+     * Muss regelmäßig im loop() aufgerufen werden. Liegt keine Meldung vor, kostet der Aufruf
+     * praktisch nichts.
+     *
+     * @param now Aktueller Zeitstempel in Millisekunden, z.B. frameClock.getNow()
+     * @return @em true falls Matrixspalten abgefragt wurden, sonst @em false.
+     */
+    bool scanPendingColumns(const unsigned long &now);
+
+
+    /**
+     * @brief Pegelwechsel an Matrixspalten vormerken.
+     *
+     * Wird von der Interrupt-Routine aufgerufen. In einer Host-Simulation können hierüber
+     * Flanken direkt eingespeist werden.
+     *
+     * @param colMask Bitmaske der Matrixspalten, an denen ein Pegelwechsel aufgetreten ist.
+     */
+    inline void onColumnEdge(const uint8_t colMask) { pendingCols |= colMask; }
+
+
+    /**
+     * @brief Von den Pin-Change-Interrupt-Routinen aufgerufen: Spaltenpegel lesen und die
+     *        Spalten mit Pegelwechsel vormerken.
+     */
+    void onPinChange();
 
 
     /**
@@ -64,28 +226,98 @@ public:
      *
      * Überträgt den Status der einzelnen Schalter in die Schaltermatrix.
      * Hierzu wird die Methode @em Switch::transmitStatus() des jeweiligen Schalters verwendet.
+     * Ist die Sendewarteschlange (bzw. das Sendefenster der gesicherten Übertragung) voll, bleiben
+     * die restlichen Schalter als geändert markiert und werden beim nächsten Aufruf übertragen.
      *
      * @param changedOnly @em true ==>  nur den Status der Schalter, die sich seit
      *                                  der letzten Abfrage geändert haben, übertragen.\n
      *                    @em false ==> den Status aller Schalter übertragen.
+     * @return @em false falls wegen einer vollen Sendewarteschlange noch Schalter oder die Momentaufnahme offen
+     *         sind, sonst @em true.
      */
-    void transmitStatus(bool changedOnly);
+    bool transmitStatus(bool changedOnly);
 
 
-    #ifdef DEBUG
     /**
-     * Alle Schalter in der Matrix ausgeben.
+     * @brief Den aktuellen Stand aller Schalter einmalig an die Geräte übergeben (siehe DeviceList::onSwitch()).
+     *
+     * Wird nach der ersten Abfrage aufgerufen, damit z.B. der Transponder die Stellung seines Wahlschalters
+     * kennt. Der Änderungsstatus der Schalter bleibt unverändert.
      *
-     * Gibt Row und Col der Schalter zeilen- und spaltenweise aus.
-     * @note Dient eigentlich nur zum debuggen.
+     * @param now Aktueller Zeitstempel in Millisekunden, z.B. frameClock.getNow()
      */
-    void printMatrix();
-    #endif /* ifdef DEBUG */
+    void feedDevices(const unsigned long &now);
+
+
+    /**
+     * @brief Den Status aller Schalter als kompakte Momentaufnahme an den PC senden.
+     *
+     * Format: @em S;M;<Bitmap>. Die Bitmap enthält je Matrixzeile ein Byte als zwei Hex-Ziffern,
+     * beginnend mit Zeile 0. Bit n eines Bytes steht für die Matrixspalte n; Bit = 1 ==> Schalter ist
+     * eingeschaltet. Für die 4x8-Matrix ergibt das z.B. @em S;M;00040000 (Schalter 1/2 ist ein). Schalter,
+     * die ein Gerät selbst verarbeitet (siehe DeviceList::ownsSwitch()), sind immer 0.
+     *
+     * Ersetzt das Senden aller Schalter einzeln per transmitStatus(TRANSMIT_ALL_SWITCHES). Der
+     * Änderungsstatus der Schalter bleibt unverändert; noch nicht übertragene Änderungen werden danach
+     * wie gewohnt per transmitStatus() gesendet. Ist die Sendewarteschlange voll, wird die Momentaufnahme
+     * beim nächsten transmitStatus() vor den Änderungen gesendet.
+     */
+    void transmitSnapshot();
+
+
+    /**
+     * @brief Zeitstempel in den Schalterereignissen ein- bzw. ausschalten.
+     *
+     * Beim Einschalten beginnt eine neue Sitzung: Alle Zeitstempel werden in Millisekunden relativ
+     * zum Sitzungsbeginn @em now gesendet. Zusätzlich wird sofort und danach alle
+     * @em TIME_SYNC_INTERVAL Millisekunden eine Zeitsynchronisation (@em S;T;<Zeit>) gesendet.
+     *
+     * @param enable @em true ==> Zeitstempel mitsenden, @em false ==> ohne Zeitstempel.
+     * @param now Aktueller Zeitstempel in Millisekunden, z.B. millis()
+     */
+    void enableTimestamps(bool enable, const unsigned long &now);
+
+
+    /**
+     * @brief Prüfen, ob die Schalterereignisse mit Zeitstempel gesendet werden.
+     *
+     * @return @em true falls Zeitstempel mitgesendet werden, sonst @em false.
+     */
+    inline bool isTimestampsEnabled() const { return timestampsEnabled; }
+
+
+    /**
+     * @brief Die Zeitsynchronisation an den PC senden, falls Zeitstempel eingeschaltet sind und
+     *        das Intervall @em TIME_SYNC_INTERVAL abgelaufen ist.
+     * @note Diese Methode muss regelmäßig im loop() aufgerufen werden.
+     *
+     * @param now Aktueller Zeitstempel in Millisekunden, z.B. millis()
+     */
+    void syncTimeIfDue(const unsigned long &now);
 
 private:
     Switch switchMatrix[SWITCH_MATRIX_ROWS][SWITCH_MATRIX_COLS];    ///< Switchmatrix anlegen.
     bool changed = false;   ///< Änderungsstatus der gesamten Matrix. Sobald sich ein Schalter ändert, ist @em changed @em true.
     const unsigned int debounceTime = 9;  ///< Zeit in Millisekunden zum Entprellen
+    ScanScheduler scanScheduler;        ///< Taktgeber für die adaptive Abfragerate.
+    uint8_t pressedCols[SWITCH_MATRIX_ROWS] = {0};  ///< Eingelesene Spaltenbits je Zeile (Bit = 1 ==> gedrückt).
+    bool diodesFitted = HW_MATRIX_HAS_DIODES;       ///< @em true ==> keine Prüfung auf Geisterschaltungen.
+    uint16_t ghostCount = 0;            ///< Anzahl Abfragen mit möglichen Geisterschaltungen.
+    bool timestampsEnabled = false;     ///< @em true ==> Schalterereignisse mit Zeitstempel senden.
+    unsigned long sessionEpoch = 0;     ///< Zeitstempel des Sitzungsbeginns in Millisekunden.
+    unsigned long lastTimeSync = 0;     ///< Zeitstempel der letzten Zeitsynchronisation.
+    bool isSnapshotPending = false;     ///< @em true ==> die Momentaufnahme wartet auf Platz in der Sendewarteschlange.
+    bool interruptMode = false;         ///< @em true ==> Interrupt-Betrieb ist eingeschaltet.
+    volatile uint8_t pendingCols = 0;   ///< Per Interrupt gemeldete, noch nicht abgefragte Matrixspalten.
+    volatile uint8_t lastColLevels = ALL_MATRIX_COLS;   ///< Zuletzt gelesene Spaltenpegel (Bit = 1 ==> HIGH).
+
+    bool scanColumns(uint8_t colMask, const unsigned long &now);
+    bool findGhostCols(uint8_t (&ghostCols)[SWITCH_MATRIX_ROWS]);
+    bool transmitPendingSnapshot();
+    void transmitTimeSync(const unsigned long &now);
+    void setAllRows(uint8_t level);
+    void setPinChangeInterrupts(bool enable);
+    uint8_t readColumnLevels();
 
     inline bool isValidMatrixRow(const uint8_t row);
     inline bool isValidMatrixCol(const uint8_t col);
@@ -16,10 +16,13 @@
 /*********************************************************************************************************//**
  * @brief Kommoandocodes
  ************************************************************************************************************/
-const uint16_t ACK               = 0xFFFF;    ///< Acknowledge - Angeforderte Daten für Parameter Code folgen
+const uint16_t ACK               = 0xFFFF;    ///< Acknowledge - kumulative Bestätigung der letzten lückenlos empfangenen Folgenummer (1 Byte)
 
 const uint16_t RESET_ARDUINO     = 0xFF01;    ///< Arduino neu booten
 const uint16_t RESEND_SWITCHES   = 0xFF02;    ///< Den Status aller Schalter senden
+const uint16_t PROTOCOL_ASCII    = 0xFF03;    ///< Vom Binärprotokoll zurück auf das Klartextprotokoll umschalten
+const uint16_t SEQUENCE          = 0xFF04;    ///< Folgenummer (1 Byte) des Frames für die gesicherte Übertragung
+const uint16_t HEARTBEAT         = 0xFF05;    ///< Lebenszeichen des PCs; optional neue Zeit bis "noFS" in ms (uint16_t)
 
 const uint16_t XPDR_CODE         = 0xF101;    ///< Den übergebenen XPDR-Code anzeigen
 const uint16_t XPDR_FLIGHTLEVEL  = 0xF102;    ///< Flightlevel für Transponder
@@ -28,8 +31,34 @@ const uint16_t M803_LT           = 0xF104;    ///< Aktuelle Uhrzeit (Local)
 const uint16_t M803_UT           = 0xF103;    ///< Aktuelle Uhrzeit (UTC)
 const uint16_t M803_ET           = 0xF105;    ///< Elapsed Time
 const uint16_t M803_FT           = 0xF106;    ///< Flight Time
-const uint16_t M803_OATF         = 0xF100;    ///< O.A.T. in Fahrenheit
+const uint16_t M803_OATF         = 0xF108;    ///< O.A.T. in Fahrenheit
 const uint16_t M803_OATC         = 0xF100;    ///< O.A.T. in Grad Celsius
 const uint16_t M803_VOLTS        = 0xF107;    ///< Spannung in V
 const uint16_t M803_QNH          = 0xF201;    ///< Aktuelles QNH des X-Plane-Wetters
 const uint16_t M802_ALT          = 0xF202;    ///< Aktueller Druck in inHg des X-Plane-Wetters
+const uint16_t LED_BATCH         = 0xF301;    ///< Mehrere Änderungen der LED-Matrix, gemeinsam angewendet (s. ledbatch.hpp)
+const uint16_t STATE_SNAPSHOT    = 0xF401;    ///< Momentaufnahme des Anzeigezustands: Version, Flags, Einträge (s. statesync.hpp)
+const uint16_t STATE_DELTA       = 0xF402;    ///< Änderung des Anzeigezustands: Basisversion, neue Version, Einträge
+const uint16_t STATE_QUERY       = 0xF403;    ///< Den aktuellen Anzeigezustand an den PC senden
+const uint16_t FRAMEBUFFER_MODE  = 0xF501;    ///< Rohdaten-Modus ein (1) bzw. aus (0) (s. framebuffer.hpp)
+const uint16_t FRAMEBUFFER       = 0xF502;    ///< LED-Matrix direkt: Frame-Zähler, Zeilenmaske, je Zeile uint32_t
+
+
+/*********************************************************************************************************//**
+ * @brief Kommandocodes vom Arduino zum PC
+ ************************************************************************************************************/
+const uint16_t SWITCH_ON         = 0x1101;    ///< Schalter/Taster eingeschaltet; row, col [, Zeitstempel]
+const uint16_t SWITCH_LON        = 0x1102;    ///< Schalter/Taster lange eingeschaltet; row, col [, Zeitstempel]
+const uint16_t SWITCH_OFF        = 0x1103;    ///< Schalter/Taster ausgeschaltet; row, col [, Zeitstempel]
+const uint16_t SWITCH_SNAPSHOT   = 0x1104;    ///< Momentaufnahme aller Schalter; ein Byte je Matrixzeile
+const uint16_t TIME_SYNC         = 0x1105;    ///< Zeitsynchronisation; Millisekunden seit Sitzungsbeginn
+const uint16_t STATE_REPORT      = 0x1106;    ///< Zustandswort; Version, Index, Wert (uint32_t)
+const uint16_t STATE_VERSION     = 0x1107;    ///< Aktuelle Version des Anzeigezustands; 0 = nicht abgeglichen
+const uint16_t XPDR_SET_CODE     = 0x1201;    ///< Am Transponder eingestellter Code (uint16_t, z.B. 7000)
+const uint16_t XPDR_SET_MODE     = 0x1202;    ///< Betriebsmodus des Transponders (uint8_t, siehe XpdrMode)
+const uint16_t XPDR_IDENT        = 0x1203;    ///< IDT am Transponder gedrückt
+const uint16_t REQUEST_DATA      = 0x1F01;    ///< Daten vom PC anfordern
+const uint16_t DIAG_VALUE        = 0x1F02;    ///< Diagnosewert; Name (4 Zeichen), Wert (uint32_t)
+const uint16_t LOG_MESSAGE       = 0x1F03;    ///< Log-Meldung; ID (uint8_t) gem. logdict.hpp, zwei Argumente (uint16_t)
+const uint16_t TRACE_ENTRY       = 0x1F04;    ///< Eintrag des Ablaufprotokolls; Trace-Punkt, Argument, Zeit in 4 µs (uint16_t)
+const uint16_t LOOP_STATS        = 0x1F05;    ///< Laufzeiten eines Abschnitts des loop(); siehe LoopTimingClass::requestReport()
@@ -0,0 +1,127 @@
+/*********************************************************************************************************//**
+ * @file control.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Implementierung der Klasse @em ControlClass.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#include <control.hpp>
+#include <diagnostics.hpp>
+#include <frameclock.hpp>
+#include <heartbeat.hpp>
+#include <linkspeed.hpp>
+#include <logger.hpp>
+#include <looptiming.hpp>
+#include <protocol.hpp>
+#include <statesync.hpp>
+#include <Switchmatrix.hpp>
+#include <trace.hpp>
+#include <txqueue.hpp>
+
+extern DiagnosticsClass diagnostics;
+extern HeartbeatClass heartbeat;
+extern LinkSpeedClass linkSpeed;
+extern LoopTimingClass loopTiming;
+extern ProtocolClass protocol;
+extern StateSyncClass stateSync;
+extern SwitchMatrix switches;
+extern TxQueueClass txQueue;
+
+
+/*********************************************************************************************************//**
+ * ControlClass - public Methoden
+ *
+ ************************************************************************************************************/
+
+void ControlClass::processEvent(EventClass *event) {
+    if (event == nullptr) {
+        return;
+    }
+    switch (event->eventId) {
+        case TokenId::EV_DIAG: {
+            diagnostics.requestReport();
+            break;
+        }
+        case TokenId::EV_SCAN: {
+            ScanScheduler &scanScheduler = switches.getScanScheduler();
+            scanScheduler.setRates(static_cast<uint16_t>(atoi(event->parameter1)),
+                                   static_cast<uint16_t>(atoi(event->parameter2)),
+                                   scanScheduler.getBurstWindow());
+            break;
+        }
+        case TokenId::EV_BRST: {
+            ScanScheduler &scanScheduler = switches.getScanScheduler();
+            scanScheduler.setRates(scanScheduler.getIdleInterval(), scanScheduler.getBurstInterval(),
+                                   static_cast<uint16_t>(atoi(event->parameter1)));
+            break;
+        }
+        case TokenId::EV_RSW: {
+            switches.transmitSnapshot();
+            break;
+        }
+        case TokenId::EV_HELO: {
+            txQueue.addReply(TxReply::HELLO);    // nur im Klartextprotokoll
+            switches.transmitSnapshot();
+            break;
+        }
+        case TokenId::EV_BIN: {
+            // Bestätigung noch im Klartext; die Sendewarteschlange schaltet um, sobald sie gesendet ist
+            if (! protocol.isBinary()) {
+                txQueue.addReply(TxReply::BIN_OK);
+            }
+            break;
+        }
+        case TokenId::EV_TS: {
+            switches.enableTimestamps(atoi(event->parameter1) != 0, frameClock.getNow());
+            break;
+        }
+        case TokenId::EV_BAUD: {
+            linkSpeed.requestSpeed(static_cast<uint16_t>(atoi(event->parameter1)), frameClock.getNow());
+            break;
+        }
+        case TokenId::EV_TEST: {
+            linkSpeed.verifyPattern(event->parameter1);
+            break;
+        }
+        case TokenId::EV_STAT: {
+            stateSync.requestReport();
+            break;
+        }
+        case TokenId::EV_LOG: {
+            logger.setLevel(static_cast<uint8_t>(atoi(event->parameter1)));
+            break;
+        }
+        case TokenId::EV_TRC: {
+            if (event->parameter1[0] == 'D') {
+                trace.requestDump();
+            } else if (atoi(event->parameter1) != 0) {
+                trace.start();
+            } else {
+                trace.stop();
+            }
+            break;
+        }
+        case TokenId::EV_PERF: {
+            if (event->parameter1[0] == '\0') {
+                loopTiming.requestReport();
+            } else if (event->parameter1[0] == 'R') {
+                loopTiming.reset();
+            } else {
+                loopTiming.setBudget(static_cast<LoopStage>(atoi(event->parameter1)),
+                                     static_cast<uint16_t>(atol(event->parameter2)));
+            }
+            break;
+        }
+        case TokenId::EV_HB: {
+            if (event->parameter1[0] != '\0') {
+                heartbeat.setTimeout(static_cast<uint16_t>(atol(event->parameter1)));
+            }
+            break;
+        }
+        default: ;  // unbekanntes Steuerkommando
+    }
+}
@@ -0,0 +1,50 @@
+/*********************************************************************************************************//**
+ * @file control.hpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Interface der Klasse @em ControlClass: Steuerkommandos für den Arduino.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+#include <event.hpp>
+
+const char DEVICE_CTRL[] = "CTRL";  ///< Steuerkommando für den Arduino selbst
+
+/*********************************************************************************************************//**
+ * Event-Konstanten der Steuerkommandos
+ ************************************************************************************************************/
+const char CTRL_DIAG[] = "DIAG";    ///< Diagnosewerte an den PC senden
+const char CTRL_SCAN[] = "SCAN";    ///< Abfrageintervalle der Schaltermatrix: Parameter 1 = ohne, Parameter 2 = nach Betätigung (ms)
+const char CTRL_BURST[] = "BRST";   ///< Dauer der schnellen Abfrage nach einer Schalterbetätigung: Parameter 1 (ms)
+const char CTRL_RESEND_SWITCHES[] = "RSW";  ///< Status aller Schalter senden (RESEND_SWITCHES)
+const char CTRL_HELLO[] = "HELO";   ///< Der PC hat sich (neu) verbunden: Kennung und Status aller Schalter senden
+const char CTRL_BINARY[] = "BIN";   ///< Auf das Binärprotokoll umschalten (siehe ProtocolClass)
+const char CTRL_TIMESTAMPS[] = "TS";    ///< Zeitstempel in Schalterereignissen: Parameter 1 = 1 (ein) oder 0 (aus)
+const char CTRL_BAUD[] = "BAUD";    ///< Höhere Baudrate aushandeln: Parameter 1 = kBaud (siehe LinkSpeedClass)
+const char CTRL_TEST[] = "TEST";    ///< Testmuster nach dem Umschalten der Baudrate: Parameter 1 = Testmuster
+const char CTRL_HEARTBEAT[] = "HB"; ///< Lebenszeichen des PCs: optional Parameter 1 = Zeit bis "noFS" in ms (siehe HeartbeatClass)
+const char CTRL_STATE[] = "STAT";   ///< Anzeigezustand an den PC senden (entspricht STATE_QUERY, siehe StateSyncClass)
+const char CTRL_LOG[] = "LOG";      ///< Log-Level zur Laufzeit: Parameter 1 = 0 (aus) bis 4 (Debug) (siehe LoggerClass)
+const char CTRL_TRACE[] = "TRC";    ///< Ablaufprotokoll: Parameter 1 = 1 (Start), 0 (Stopp) oder D (senden) (siehe TraceClass)
+const char CTRL_PERF[] = "PERF";    ///< Laufzeiten des loop(): ohne Parameter senden, R = zurücksetzen, sonst Abschnitt und Budget in µs
+
+
+/*********************************************************************************************************//**
+ * @brief Verarbeitet die Steuerkommandos (Device @em CTRL), die der PC an den Arduino selbst schickt.
+ *
+ ************************************************************************************************************/
+class ControlClass {
+public:
+    /**
+     * @brief Ein Steuerkommando ausführen.
+     *
+     * @param event Das auszuführende Steuerkommando.
+     */
+    void processEvent(EventClass *event);
+};
@@ -9,6 +9,7 @@
  **************************************************************************************************/
 
 #include <device.hpp>
+#include <logger.hpp>
 
 /**
  * @brief Construct a new Device:: Device object
@@ -24,15 +25,11 @@ Device::Device() {
 
 
 void Device::processEvent(EventClass *event) const {
-    #ifdef DEBUG
-    Serial.println(F("***Device.processEvent()"));
     if (event != nullptr) {
-        event->printEvent();
+        LOG(DEVICE_EVENT, event->deviceId, event->eventId);
     } else {
-        Serial.println(F("  !!! nullptr statt event angekommen."));
+        LOG(DEVICE_NULL_EVENT, 0, 0);
     }
-    Serial.println(F("***End Device.processEvent()"));
-    #endif
 }
 
 
@@ -45,6 +42,13 @@ void Device::setDevicePower(bool devicePowerSwitchState) {
     devicePower = devicePowerSwitchState;
 }
 
+
+void Device::setBusPower(const bool battery, const bool avionics1, const bool avionics2) {
+    batteryPower = battery;
+    avionics1Power = avionics1;
+    avionics2Power = avionics2;
+}
+
 inline bool Device::isBatteryPowerOn() {
     return batteryPower;
 };
@@ -62,9 +66,4 @@ inline bool Device::isAvionics2PowerOn() {
 
 inline bool Device::isPowerAvailable() {
     return isBatteryPowerOn() and isAvionics1PowerOn();
-}
-
-
-void Device::show() {
-    ;
 }
\ No newline at end of file
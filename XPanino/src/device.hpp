@@ -22,6 +22,10 @@
  *
  * bereit.
  *
+ * Die Methoden processEvent(), setLinkUp(), redraw(), tick() und show() sind bewusst nicht virtuell:
+ * @em DeviceList ruft sie direkt über den Typ des Geräts auf, eine abgeleitete Klasse überdeckt sie bei
+ * Bedarf. Die leeren Methoden hier kosten daher nichts, und es gibt keine vtable im RAM.
+ *
  */
 class Device {
 public:
@@ -31,12 +35,22 @@ public:
     Device();
 
     /**
-     * @brief Verarbeitet die Tastendrücke und Daten.
+     * @brief Verarbeitet die Tastendrücke und Daten. Ohne eigene Methode des Geräts wird das Event nur protokolliert.
      *
      */
     void processEvent(EventClass *event) const;
 
 
+    /**
+     * @brief Die Stromversorgung setzen.
+     *
+     * @param battery @em true = Batteriestrom verfügbar.
+     * @param avionics1 @em true = Avionicsbus 1 versorgt.
+     * @param avionics2 @em true = Avionicsbus 2 versorgt.
+     */
+    void setBusPower(bool battery, bool avionics1, bool avionics2);
+
+
     /**
      * @brief
      *
@@ -93,12 +107,14 @@ public:
     bool isPowerAvailable();
 
 
-    /**
-     * @brief This is an abstract method which has to be implemented in every derived class.
-     * @todo als abstrakt und virtuell deklarieren
-     *
-     */
-    void show();
+    /// Schalter der Schaltermatrix verarbeiten; @em true = gehört zum Gerät und geht nicht an den PC
+    inline bool onSwitch(uint8_t, uint8_t, uint8_t, unsigned long) { return false; }
+    /// Prüfen, ob ein Schalter der Schaltermatrix zum Gerät gehört; er fehlt dann in der Momentaufnahme an den PC
+    inline bool ownsSwitch(uint8_t, uint8_t) const { return false; }
+    inline void setLinkUp(bool) {}          ///< Verbindung zum Flugsimulator hergestellt bzw. getrennt
+    inline void redraw() {}                 ///< Beim nächsten show() alles neu anzeigen
+    inline void tick(unsigned long) {}      ///< Eigene Zeitbasis weiterlaufen lassen (Zeit in ms)
+    inline void show() {}                   ///< Aktuelle Werte anzeigen
 
 
 private:
@@ -0,0 +1,174 @@
+/*********************************************************************************************************//**
+ * @file devices.hpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Interface der Klasse @em DeviceList: Liste der Geräte des Panels, beim Compilieren festgelegt.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+#include <event.hpp>
+#include <m803.hpp>
+#include <xpdr.hpp>
+
+/// Hilfstyp, um in @em DeviceList ein Gerät über seinen Typ zu finden.
+template <typename T> struct DeviceTag {};
+
+
+/*********************************************************************************************************//**
+ * @brief Liste der Geräte des Panels, beim Compilieren festgelegt.
+ *
+ * Die Liste enthält die Geräte selbst und verteilt Events, Schalter, Stromversorgung, Verbindungsstatus, den Takt
+ * und die Anzeige an alle Geräte. Die Methoden der Geräte werden direkt über ihren Typ aufgerufen; es
+ * gibt weder virtuelle Methoden noch vtables im RAM. Jede Geräteklasse ist von @em Device abgeleitet,
+ * hat eine Konstante @em DEVICE_ID und überdeckt die Methoden von @em Device, die sie braucht.
+ *
+ * Ein neues Gerät muss nur in @em PanelDevices eingetragen werden; Dispatcher und Hauptprogramm bleiben
+ * unverändert.
+ *
+ ************************************************************************************************************/
+template <typename... Devices> class DeviceList;
+
+
+/// @brief Ende der Rekursion: die leere Liste.
+template <> class DeviceList<> {
+public:
+    inline bool processEvent(EventClass *) { return false; }
+    inline bool onSwitch(uint8_t, uint8_t, uint8_t, unsigned long) { return false; }
+    inline bool ownsSwitch(uint8_t, uint8_t) const { return false; }
+    inline void setBusPower(bool, bool, bool) {}
+    inline void setLinkUp(bool) {}
+    inline void redraw() {}
+    inline void tick(unsigned long) {}
+    inline void show() {}
+
+protected:
+    inline void find() {}
+};
+
+
+template <typename First, typename... Rest>
+class DeviceList<First, Rest...> : private DeviceList<Rest...> {
+    using Others = DeviceList<Rest...>;     ///< Die restlichen Geräte der Liste
+
+public:
+    /**
+     * @brief Ein Event an das Gerät mit der passenden ID übergeben.
+     *
+     * @param event Das Event.
+     * @return @em true falls ein Gerät der Liste das Event verarbeitet hat, sonst @em false.
+     */
+    inline bool processEvent(EventClass *event) {
+        if (event->deviceId == First::DEVICE_ID) {
+            device.processEvent(event);
+            return true;
+        }
+        return Others::processEvent(event);
+    }
+
+
+    /**
+     * @brief Einen Schalter der Schaltermatrix dem Gerät übergeben, zu dem er gehört.
+     *
+     * @param row Row des Schalters in der Schaltermatrix.
+     * @param col Col des Schalters in der Schaltermatrix.
+     * @param switchState 0 = aus, 1 = ein, 2 = lange ein.
+     * @param now Aktuelle Zeit in Millisekunden.
+     * @return @em true falls ein Gerät den Schalter selbst verarbeitet; er geht dann nicht an den PC.
+     */
+    inline bool onSwitch(const uint8_t row, const uint8_t col, const uint8_t switchState, const unsigned long now) {
+        return device.onSwitch(row, col, switchState, now) || Others::onSwitch(row, col, switchState, now);
+    }
+
+
+    /**
+     * @brief Prüfen, ob ein Schalter der Schaltermatrix zu einem Gerät der Liste gehört.
+     *
+     * @param row Row des Schalters in der Schaltermatrix.
+     * @param col Col des Schalters in der Schaltermatrix.
+     * @return @em true falls ein Gerät den Schalter selbst verarbeitet; er fehlt dann in der Momentaufnahme.
+     */
+    inline bool ownsSwitch(const uint8_t row, const uint8_t col) const {
+        return device.ownsSwitch(row, col) || Others::ownsSwitch(row, col);
+    }
+
+
+    /**
+     * @brief Die Stromversorgung an alle Geräte melden.
+     *
+     * @param battery @em true = Batteriestrom verfügbar.
+     * @param avionics1 @em true = Avionicsbus 1 versorgt.
+     * @param avionics2 @em true = Avionicsbus 2 versorgt.
+     */
+    inline void setBusPower(const bool battery, const bool avionics1, const bool avionics2) {
+        device.setBusPower(battery, avionics1, avionics2);
+        Others::setBusPower(battery, avionics1, avionics2);
+    }
+
+
+    /**
+     * @brief Verbindung zum Flugsimulator hergestellt bzw. getrennt an alle Geräte melden.
+     *
+     * @param isUp @em true = Flugsimulator online.
+     */
+    inline void setLinkUp(const bool isUp) {
+        device.setLinkUp(isUp);
+        Others::setLinkUp(isUp);
+    }
+
+
+    /**
+     * @brief Alle Geräte beim nächsten @em show() vollständig neu anzeigen.
+     */
+    inline void redraw() {
+        device.redraw();
+        Others::redraw();
+    }
+
+
+    /**
+     * @brief Die eigene Zeitbasis aller Geräte weiterlaufen lassen.
+     * @note Diese Methode muss vor @em show() aufgerufen werden.
+     *
+     * @param now Aktuelle Zeit in Millisekunden.
+     */
+    inline void tick(const unsigned long now) {
+        device.tick(now);
+        Others::tick(now);
+    }
+
+
+    /**
+     * @brief Alle Geräte anzeigen.
+     */
+    inline void show() {
+        device.show();
+        Others::show();
+    }
+
+
+    /**
+     * @brief Ein Gerät über seinen Typ abrufen, z.B. @em devices.get<ClockDavtronM803>().
+     *
+     * @return Das Gerät; gibt es den Typ nicht in der Liste, bricht das Compilieren ab.
+     */
+    template <typename T> inline T &get() { return find(DeviceTag<T>()); }
+
+protected:
+    using Others::find;
+    inline First &find(DeviceTag<First>) { return device; }
+
+private:
+    First device;   ///< Das Gerät; die Geräte werden vom Ende der Liste her angelegt.
+};
+
+
+/// Die Geräte des Panels. Ein neues Gerät hier eintragen (und oben seinen Header includen).
+using PanelDevices = DeviceList<ClockDavtronM803, TransponderKT76C>;
+
+extern PanelDevices devices;
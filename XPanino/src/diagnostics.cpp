@@ -0,0 +1,171 @@
+/*********************************************************************************************************//**
+ * @file diagnostics.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Implementierung der Klasse @em DiagnosticsClass.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#include <diagnostics.hpp>
+#include <event.hpp>
+#include <framebuffer.hpp>
+#include <heartbeat.hpp>
+#include <ledbatch.hpp>
+#include <link.hpp>
+#include <linkspeed.hpp>
+#include <logger.hpp>
+#include <looptiming.hpp>
+#include <memmonitor.hpp>
+#include <parser.hpp>
+#include <protocol.hpp>
+#include <scheduler.hpp>
+#include <statesync.hpp>
+#include <Switchmatrix.hpp>
+#include <txqueue.hpp>
+
+extern EventQueueClass eventQueue;
+extern FramebufferClass framebuffer;
+extern HeartbeatClass heartbeat;
+extern LedBatchClass ledBatch;
+extern LinkClass linkLayer;
+extern LinkSpeedClass linkSpeed;
+extern LoopTimingClass loopTiming;
+extern ParserClass parser;
+extern ProtocolClass protocol;
+extern SchedulerClass scheduler;
+extern StateSyncClass stateSync;
+extern SwitchMatrix switches;
+extern TxQueueClass txQueue;
+
+
+/*********************************************************************************************************//**
+ * @brief Alle Diagnosewerte als X-Makro: X(Name, Wert). Der Name hat max. @em DIAG_NAME_LENGTH Zeichen; die
+ *        Reihenfolge ist die Reihenfolge der Ausgabe.
+ *
+ ************************************************************************************************************/
+#define DIAG_VALUES(X) \
+    X(LOOP, loopRate) \
+    X(SCAN, scanRate) \
+    X(REFR, refreshRate) \
+    X(SIDL, switches.getScanScheduler().getIdleInterval()) \
+    X(SBST, switches.getScanScheduler().getBurstInterval()) \
+    X(SWIN, switches.getScanScheduler().getBurstWindow()) \
+    X(BRST, switches.getScanScheduler().isBurstActive() ? 1 : 0) \
+    X(GHST, switches.getGhostCount()) \
+    X(FRX, protocol.getFramesReceived()) \
+    X(FTX, protocol.getFramesSent()) \
+    X(FERR, protocol.getFrameErrors()) \
+    X(FREF, protocol.getFramesRefused()) \
+    X(PERR, parser.getLineErrors()) \
+    X(EVHW, eventQueue.getHighWater()) \
+    X(EVDR, eventQueue.getDropped()) \
+    X(EVSU, eventQueue.getSuperseded()) \
+    X(TXHW, txQueue.getHighWater()) \
+    X(TXDR, txQueue.getDropped()) \
+    X(LRTX, linkLayer.getRetransmits()) \
+    X(LDUP, linkLayer.getDuplicates()) \
+    X(BAUD, linkSpeed.getBaudRate()) \
+    X(BFLB, linkSpeed.getFallbacks()) \
+    X(LBAT, ledBatch.getApplied()) \
+    X(LBER, ledBatch.getRejected()) \
+    X(LKUP, heartbeat.getLinkUps()) \
+    X(LKDN, heartbeat.getLinkDowns()) \
+    X(SVER, stateSync.getVersion()) \
+    X(SREJ, stateSync.getRejected()) \
+    X(RAWF, framebuffer.getFrames()) \
+    X(RAWL, framebuffer.getLostFrames()) \
+    X(RAWE, framebuffer.getRejected()) \
+    X(LGDR, logger.getDropped()) \
+    X(LMAX, loopTiming.getStats(LoopStage::LOOP).max) \
+    X(LOVR, loopTiming.getStats(LoopStage::LOOP).overruns) \
+    X(TOVR, scheduler.getOverruns()) \
+    X(TLAT, scheduler.getMaxLateness()) \
+    X(RAMF, MemoryMonitorClass::getFreeRam()) \
+    X(STKH, MemoryMonitorClass::getStackHighWater()) \
+    X(STKR, MemoryMonitorClass::getStackReserve()) \
+    X(HPSZ, MemoryMonitorClass::getHeapSize()) \
+    X(HPFR, MemoryMonitorClass::getHeapFree()) \
+    X(HPLB, MemoryMonitorClass::getLargestBlock()) \
+    X(HALC, MemoryMonitorClass::getAllocations()) \
+    X(HAFL, MemoryMonitorClass::getAllocFailures()) \
+    X(HFRE, MemoryMonitorClass::getFrees())
+
+/// Position der Diagnosewerte in @em DIAG_VALUES.
+enum class DiagValue : uint8_t {
+    #define DIAG_ID(name, value) DIAG_##name,
+    DIAG_VALUES(DIAG_ID)
+    #undef DIAG_ID
+    COUNT
+};
+
+const uint8_t DIAG_VALUE_COUNT = static_cast<uint8_t>(DiagValue::COUNT);   ///< Anzahl Diagnosewerte
+
+/// Die Namen der Diagnosewerte im Flash, in der Reihenfolge von @em DIAG_VALUES.
+const char DIAG_NAMES[DIAG_VALUE_COUNT][DIAG_NAME_LENGTH + 1] PROGMEM = {
+    #define DIAG_NAME(name, value) #name,
+    DIAG_VALUES(DIAG_NAME)
+    #undef DIAG_NAME
+};
+
+
+/*********************************************************************************************************//**
+ * DiagnosticsClass - public Methoden
+ *
+ ************************************************************************************************************/
+
+void DiagnosticsClass::update(const unsigned long &now) {
+    unsigned long elapsed = now - windowStart;
+    if (elapsed >= DIAG_RATE_WINDOW) {
+        // Auf Raten je Sekunde umrechnen, falls das Messfenster (durch einen langen loop()) überzogen wurde.
+        loopRate = static_cast<uint16_t>((static_cast<unsigned long>(loopCount) * 1000) / elapsed);
+        scanRate = static_cast<uint16_t>((static_cast<unsigned long>(scanCount) * 1000) / elapsed);
+        refreshRate = static_cast<uint16_t>((static_cast<unsigned long>(refreshCount) * 1000) / elapsed);
+        loopCount = 0;
+        scanCount = 0;
+        refreshCount = 0;
+        windowStart = now;
+    }
+}
+
+
+void DiagnosticsClass::requestReport() {
+    reportRemaining = DIAG_VALUE_COUNT;
+}
+
+
+void DiagnosticsClass::transmit() {
+    while ((reportRemaining > 0) && (txQueue.getCount() < TX_REPORT_LIMIT)) {
+        const uint8_t index = DIAG_VALUE_COUNT - reportRemaining;
+        txQueue.addMessage({TxMessageType::DIAG_VALUE, index, 0, 0, 0, getValue(index)});
+        reportRemaining--;
+    }
+}
+
+
+void DiagnosticsClass::getName(const uint8_t index, char *name) {
+    strncpy_P(name, DIAG_NAMES[index], DIAG_NAME_LENGTH);
+    name[DIAG_NAME_LENGTH] = '\0';
+}
+
+
+/*********************************************************************************************************//**
+ * ab hier die privaten Methoden
+*************************************************************************************************************/
+
+/**
+ * @brief Den aktuellen Wert eines Diagnosewerts ermitteln.
+ *
+ * @param index Position in @em DIAG_VALUES.
+ * @return Der Diagnosewert.
+ */
+uint32_t DiagnosticsClass::getValue(const uint8_t index) const {
+    switch (static_cast<DiagValue>(index)) {
+        #define DIAG_CASE(name, value) case DiagValue::DIAG_##name: return static_cast<uint32_t>(value);
+        DIAG_VALUES(DIAG_CASE)
+        #undef DIAG_CASE
+        default: return 0;
+    }
+}
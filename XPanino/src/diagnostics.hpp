@@ -0,0 +1,78 @@
+/*********************************************************************************************************//**
+ * @file diagnostics.hpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Interface der Klasse @em DiagnosticsClass.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+
+const unsigned long DIAG_RATE_WINDOW = 1000;    ///< Messfenster in Millisekunden für die Ermittlung der Raten
+const uint8_t DIAG_NAME_LENGTH = 4;             ///< Max. Länge des Namens eines Diagnosewerts
+
+
+/*********************************************************************************************************//**
+ * @brief Zähler für die Diagnose des laufenden Betriebs.
+ *
+ * Die Zähler werden im loop() hochgezählt. Einmal je Messfenster (@em DIAG_RATE_WINDOW) werden
+ * daraus die effektiven Raten je Sekunde ermittelt. Die Ausgabe erfolgt auf Anforderung des PC
+ * über das Steuerkommando @em CTRL;DIAG im Format @em D;<Name>;<Wert> bzw. im Binärprotokoll als Records
+ * @em DIAG_VALUE. Die Werte gehen wie das Ablaufprotokoll über die Sendewarteschlange und belegen dort
+ * höchstens @em TX_REPORT_LIMIT Plätze; der loop() wartet nie auf die serielle Schnittstelle.
+ *
+ ************************************************************************************************************/
+class DiagnosticsClass {
+public:
+    inline void countLoop() { ++loopCount; }        ///< Einen Durchlauf des loop() zählen.
+    inline void countScan() { ++scanCount; }        ///< Eine Abfrage der Schaltermatrix zählen.
+    inline void countRefresh() { ++refreshCount; }  ///< Einen Refresh der LED-Matrix zählen.
+
+
+    /**
+     * @brief Nach Ablauf des Messfensters die Raten aus den Zählern berechnen und die Zähler zurücksetzen.
+     * @note Diese Methode muss regelmäßig im loop() aufgerufen werden.
+     *
+     * @param now Aktueller Zeitstempel in Millisekunden, z.B. millis()
+     */
+    void update(const unsigned long &now);
+
+
+    /**
+     * @brief Alle Diagnosewerte an den PC senden. Gesendet wird verteilt über mehrere Aufrufe von transmit().
+     */
+    void requestReport();
+
+
+    /**
+     * @brief Anstehende Diagnosewerte in die Sendewarteschlange stellen.
+     * @note Diese Methode muss einmal je loop() aufgerufen werden.
+     */
+    void transmit();
+
+
+    /**
+     * @brief Den Namen eines Diagnosewerts aus dem Flash lesen.
+     *
+     * @param index Position des Diagnosewerts (siehe TxMessage::row).
+     * @param name Zielpuffer für mind. @em DIAG_NAME_LENGTH + 1 Zeichen.
+     */
+    static void getName(uint8_t index, char *name);
+
+private:
+    uint16_t loopCount = 0;         ///< Anzahl loop()-Durchläufe im aktuellen Messfenster
+    uint16_t scanCount = 0;         ///< Anzahl Abfragen der Schaltermatrix im aktuellen Messfenster
+    uint16_t refreshCount = 0;      ///< Anzahl Refreshs der LED-Matrix im aktuellen Messfenster
+    uint16_t loopRate = 0;          ///< loop()-Durchläufe je Sekunde im letzten Messfenster
+    uint16_t scanRate = 0;          ///< Abfragen der Schaltermatrix je Sekunde im letzten Messfenster
+    uint16_t refreshRate = 0;       ///< Refreshs der LED-Matrix je Sekunde im letzten Messfenster
+    unsigned long windowStart = 0;  ///< Startzeitpunkt des aktuellen Messfensters
+    uint8_t reportRemaining = 0;    ///< Anzahl der noch zu sendenden Diagnosewerte
+
+    uint32_t getValue(uint8_t index) const;
+};
@@ -9,17 +9,70 @@
  ***********************************************************************************************************/
 
 #include <dispatcher.hpp>
+#include <logger.hpp>
 
 extern EventQueueClass eventQueue;
 
 
-void DispatcherClass::dispatch(EventClass *event) const {
-    if (strcmp(event->device, DEVICE_M803) == 0) {
-        m803.processEvent(event);
-    } else if (strcmp(event->device, DEVICE_XPDR) == 0) {
-        xpdr.processEvent(event);
+/*********************************************************************************************************//**
+ * Tabelle der Handler je Device
+ *
+ ************************************************************************************************************/
+
+static void dispatchCtrl(EventClass *event) { control.processEvent(event); }
+static void dispatchLed(EventClass *event) { ledBatch.processEvent(event); }
+
+/// Stromversorgung laut PC in der Reihenfolge PB, PA1, PA2; bis zur ersten Meldung gilt alles als versorgt.
+static bool busPower[] = {true, true, true};
+
+/**
+ * @brief @em ON bzw. @em OFF für die Batterie (PB) oder einen Avionicsbus (PA1, PA2) an alle Geräte melden.
+ */
+static void dispatchPower(EventClass *event) {
+    const uint8_t bus = static_cast<uint8_t>(event->deviceId) - static_cast<uint8_t>(TokenId::DEV_PB);
+    if (event->eventId == TokenId::EV_ON) {
+        busPower[bus] = true;
+    } else if (event->eventId == TokenId::EV_OFF) {
+        busPower[bus] = false;
     } else {
-        // kein passendes Device gefunden.
+        LOG(DEVICE_EVENT, event->deviceId, event->eventId);
+        return;
+    }
+    devices.setBusPower(busPower[0], busPower[1], busPower[2]);
+}
+
+/// Handler je Device-ID in der Reihenfolge von @em TokenId; nullptr = kein Device oder Gerät aus @em PanelDevices.
+static_assert((static_cast<uint8_t>(TokenId::DEV_PA1) == static_cast<uint8_t>(TokenId::DEV_PB) + 1)
+              && (static_cast<uint8_t>(TokenId::DEV_PA2) == static_cast<uint8_t>(TokenId::DEV_PB) + 2),
+              "dispatchPower() erwartet PB, PA1, PA2 direkt hintereinander.");
+const DeviceHandler DEVICE_HANDLERS[] PROGMEM = {
+    nullptr,                                    // NONE
+    nullptr, nullptr, dispatchCtrl,             // M803, XPDR, CTRL
+    nullptr, nullptr, nullptr, nullptr,         // COM1, COM2, NAV1, NAV2
+    dispatchPower, dispatchPower, dispatchPower, nullptr,   // PB, PA1, PA2, PM
+    nullptr, nullptr, nullptr,                  // PX, PC1, PC2
+    dispatchLed                                 // LED
+};
+static_assert(sizeof(DEVICE_HANDLERS) / sizeof(DEVICE_HANDLERS[0]) == DEVICE_TOKEN_COUNT,
+              "DEVICE_HANDLERS passt nicht zu TokenId.");
+
+
+/*********************************************************************************************************//**
+ * DispatcherClass - public Methoden
+ *
+ ************************************************************************************************************/
+
+void DispatcherClass::dispatch(EventClass *event) const {
+    if (! isDeviceToken(event->deviceId)) {
+        return;     // kein passendes Device gefunden.
+    }
+    if (devices.processEvent(event)) {
+        return;
+    }
+    auto handler = reinterpret_cast<DeviceHandler>(
+        pgm_read_ptr(&DEVICE_HANDLERS[static_cast<uint8_t>(event->deviceId)]));
+    if (handler != nullptr) {
+        handler(event);
     }
 }
 
@@ -27,9 +80,9 @@ void DispatcherClass::dispatch(EventClass *event) const {
 void DispatcherClass::dispatchAll() {
     EventClass* ptr = eventQueue.getHeadEvent();
     while (ptr != nullptr) {
-        Serial.println(F("---DispatchAll---"));
+        LOG(DISPATCH_EVENT, ptr->deviceId, ptr->eventId);
         dispatch(ptr);
-        eventQueue.deleteHeadEvent(ptr);
+        eventQueue.removeHeadEvent();
         ptr = eventQueue.getHeadEvent();
     };
 }
\ No newline at end of file
@@ -10,15 +10,20 @@
 
 #pragma once
 
+#include <control.hpp>
+#include <devices.hpp>
 #include <event.hpp>
-#include <m803.hpp>
-#include <xpdr.hpp>
+#include <ledbatch.hpp>
 
-extern ClockDavtronM803 m803;
-extern TransponderKT76C xpdr;
+extern ControlClass control;
+extern LedBatchClass ledBatch;
 extern EventQueueClass eventQueue;
 
 
+/// @brief Handler, der ein Event an ein Device ohne Eintrag in @em PanelDevices übergibt (CTRL, LED, PB, PA1, PA2).
+typedef void (*DeviceHandler)(EventClass *event);
+
+
 /***************************************************************************************************
  * @brief dispatchen
  *
@@ -28,6 +33,9 @@ public:
     /**
      * @brief dispatch a specific event.
      *
+     * Die Geräte des Panels bekommen das Event über @em PanelDevices. Die übrigen Devices (CTRL, LED)
+     * werden über ihre ID direkt in der Tabelle der Handler gefunden.
+     *
      * @param event Event to dispatch.
      */
     void dispatch(EventClass *event) const;
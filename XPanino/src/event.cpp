@@ -10,7 +10,6 @@
  ************************************************************************************************************/
 
 #include <event.hpp>
-#include <buffer.hpp>   /// @todo dieses #include kann 'raus?
 
 /*********************************************************************************************************//**
  * Konstanten für Devices und Actions
@@ -19,45 +18,21 @@
  *
  ************************************************************************************************************/
 
-/*********************************************************************************************************//**
- * @brief Event - public Methoden
- *
- ************************************************************************************************************/
-
 /**
- * @brief Konstruktor
+ * @brief Compiler-Barriere: Schreib- und Lesezugriffe auf die Plätze der Eventqueue dürfen nicht über
+ * die Zugriffe auf @em head bzw. @em tail hinweg verschoben werden.
  */
-EventClass::EventClass() {
-    next = nullptr;
-}
+static inline void memoryBarrier() { __asm__ __volatile__("" ::: "memory"); }
 
 
-/**
- * @brief Zeiger auf das nächste Element in der Liste (= Nachfolger) eintragen.
+/*********************************************************************************************************//**
+ * @brief Event - public Methoden
  *
- * @param next
- */
-void EventClass::setNext(EventClass* next) { this->next = next; };
-
+ ************************************************************************************************************/
 
-/**
- * @brief Zeiger auf das nächste Element in der Liste zurückgeben
- *
- * @return EventClass*
- */
-EventClass* EventClass::getNext() { return this->next; };
-
-
-void EventClass::printEvent() {
-    #ifdef DEBUG
-    Serial.println(F("---EventClass.printEvent()---"));
-    Serial.print(F("Device=")); Serial.print(device); Serial.println(F("|"));
-    Serial.print(F("Event=")); Serial.print(event); Serial.println(F("|"));
-    Serial.print(F("Parameter1=")); Serial.print(parameter1); Serial.println(F("|"));
-    Serial.print(F("Parameter2=")); Serial.print(parameter2); Serial.println(F("|"));
-    if (next == nullptr) { Serial.println(F("<nullptr>"));
-    } else { Serial.println(F("<pointer>")); }
-    #endif
+void EventClass::intern() {
+    deviceId = internToken(device);
+    eventId = internToken(event);
 }
 
 
@@ -66,59 +41,83 @@ void EventClass::printEvent() {
  *
  ************************************************************************************************************/
 
-/**
- * @brief Konstruktor
- */
-EventQueueClass::EventQueueClass() {
-    head = nullptr;
-    tail = nullptr;
-};
-
-
-void EventQueueClass::addEvent(EventClass* ptrNewEvent) {
-    if (ptrNewEvent != nullptr) {
-        if (tail == nullptr) {
-            // Liste ist leer --> newEvent ist das einzige Element
-            head = ptrNewEvent;
-            tail = head;
-            head->setNext(nullptr);  // Das letzte Element hat keinen Nachfolger
-        } else {
-            // Neues Element als letztes Element an die Liste anhängen
-            tail->setNext(ptrNewEvent);     // im bisherigen letzten Element den Zeiger auf das
-                                            // neue letzte Element eintragen
-            tail = ptrNewEvent;             // Jetzt zeigt Tail auf das neue letzte Element
-        }
+bool EventQueueClass::addEvent(const EventClass &newEvent) {
+    if (isStateToken(newEvent.eventId) && replacePendingState(newEvent)) {
+        return true;
     }
-};
+    const uint8_t count = static_cast<uint8_t>(tail - head);
+    if (count >= EVENT_QUEUE_SIZE) {
+        dropped++;                  // Eventqueue voll: das neue Event verwerfen; gemeldet wird im Verbraucher
+        droppedDeviceId = newEvent.deviceId;
+        droppedEventId = newEvent.eventId;
+        return false;
+    }
+    events[tail & (EVENT_QUEUE_SIZE - 1)] = newEvent;
+    memoryBarrier();                // erst das Event vollständig schreiben, dann freigeben
+    tail = tail + 1;
+    highWater = max(highWater, static_cast<uint8_t>(count + 1));
+    return true;
+}
 
 
 EventClass *EventQueueClass::getHeadEvent() {
-    EventClass* ptr = head;         // Zeiger auf 1. Element sichern
-    if (ptr != nullptr) {
-        head = ptr->getNext();     // head auf das 2. Element zeigen lassen
-        if (head == nullptr) {      // Falls es kein 2. Element gibt, gibt es auch kein letztes Element
-            tail = nullptr;
-        }
+    if (head == tail) {
+        return nullptr;             // Eventqueue ist leer
+    }
+    memoryBarrier();
+    return &events[head & (EVENT_QUEUE_SIZE - 1)];
+}
+
+
+void EventQueueClass::removeHeadEvent() {
+    if (head != tail) {
+        memoryBarrier();            // erst das Event vollständig lesen, dann den Platz freigeben
+        head = head + 1;
     }
-    return ptr;                     // Zeiger auf das bisherige 1. Element zurück geben
-};
+}
+
+
+bool EventQueueClass::takeDropped(TokenId &deviceId, TokenId &eventId) {
+    noInterrupts();                 // dropped ist mehrere Bytes breit und wird vom Erzeuger geschrieben
+    const unsigned long count = dropped;
+    deviceId = droppedDeviceId;
+    eventId = droppedEventId;
+    interrupts();
+    if (count == reportedDropped) {
+        return false;
+    }
+    reportedDropped = count;
+    return true;
+}
 
 
-void EventQueueClass::deleteHeadEvent(EventClass *event) {
-    if (event != nullptr) {
-        delete(event);                // Das bisherige 1. Element löschen
+/*********************************************************************************************************//**
+ * ab hier die privaten Methoden
+*************************************************************************************************************/
+
+/**
+ * @brief Eine wartende Zustandsmeldung für das gleiche Device und Event durch die neue ersetzen.
+ *
+ * Das Event am Kopf der Eventqueue wird ausgelassen, da es gerade vom Verbraucher abgearbeitet
+ * werden könnte. Alle anderen wartenden Plätze fasst der Verbraucher erst an, wenn sie am Kopf stehen.
+ *
+ * @param newEvent Die neue Zustandsmeldung.
+ * @return @em true falls eine wartende Meldung ersetzt wurde.
+ */
+bool EventQueueClass::replacePendingState(const EventClass &newEvent) {
+    const uint8_t end = tail;
+    if (head == end) {
+        return false;   // Eventqueue ist leer
+    }
+    for (uint8_t index = head + 1; index != end; ++index) {
+        EventClass &pending = events[index & (EVENT_QUEUE_SIZE - 1)];
+        if ((pending.deviceId == newEvent.deviceId) && (pending.eventId == newEvent.eventId)) {
+            pending = newEvent;
+            superseded++;
+            return true;
+        }
     }
-};
-
-
-#ifdef DEBUG
-void EventQueueClass::printQueue() {
-    Serial.println(F("----Eventqueue----"));
-    EventClass* ptr = head;
-    while (ptr != nullptr) {
-        ptr->printEvent();
-        ptr = ptr->getNext();
-    };
-    Serial.println(F("----End Eventqueue----"));
+    return false;
 }
-#endif
+
+
@@ -1,7 +1,7 @@
 /*********************************************************************************************************//**
  * @file event.hpp
  * @author Christian Harraeus <christian@harraeus.de>
- * @brief Interface der Klassen @em ParserClass und @em BufferClass.
+ * @brief Interface der Klassen @em EventClass und @em EventQueueClass.
  * @version 0.1
  * @date 2022-12-08
  *
@@ -12,12 +12,17 @@
 #pragma once
 
 #include <Arduino.h>
+#include <tokens.hpp>
 
 // Einige Konstanten für die Stringlängen
 const uint8_t MAX_SRC_DEV_LENGTH = 5;   ///< Max. Länge für je Kommando, Source und Device = 4 zzgl. '\0'.
 const uint8_t MAX_PARA_LENGTH = 7;      ///< Max. Länge der geparsten Kommandoparameter = 6 zzgl. '\0'.
 
 
+const uint8_t EVENT_QUEUE_SIZE = 8;     ///< Anzahl der Plätze in der Eventqueue; muss eine Zweierpotenz sein
+static_assert((EVENT_QUEUE_SIZE & (EVENT_QUEUE_SIZE - 1)) == 0, "EVENT_QUEUE_SIZE muss eine Zweierpotenz sein.");
+
+
 /*********************************************************************************************************//**
  * @brief Event - Daten zum Event, das noch abgearbeitet werden muss
  *
@@ -28,56 +33,91 @@ public:
     char event[MAX_SRC_DEV_LENGTH] = "";     ///< ausgelöstes Event gem. Doku
     char parameter1[MAX_PARA_LENGTH] = "";   ///< Daten für das Event
     char parameter2[MAX_PARA_LENGTH] = "";   ///< Daten für das Event
+    TokenId deviceId = TokenId::NONE;       ///< ID zu @em device
+    TokenId eventId = TokenId::NONE;        ///< ID zu @em event
 
-    EventClass();
-    void setNext(EventClass* next);
-    EventClass* getNext();
-    void printEvent();
-
-private:
-    EventClass* next = nullptr;         ///< Zeiger auf das nächste Event in der Liste
+    /**
+     * @brief Die IDs zu @em device und @em event ermitteln (einmalig beim Parsen).
+     */
+    void intern();
 };
 
 
 /*********************************************************************************************************//**
- * @brief Eventliste - sammelt die noch nicht abgearbeiteten Events
+ * @brief Eventqueue - sammelt die noch nicht abgearbeiteten Events
+ *
+ * Ringpuffer mit fester Größe für genau einen Erzeuger (serielle Schnittstelle bzw. Binärprotokoll) und
+ * genau einen Verbraucher (Dispatcher). Es wird kein Heap verwendet. Der Erzeuger schreibt nur @em tail,
+ * der Verbraucher nur @em head; deshalb darf @em addEvent() auch aus einer Interrupt-Routine
+ * aufgerufen werden, ohne dass die Interrupts gesperrt werden müssen.
+ *
+ * Zustandsmeldungen (siehe @em isStateToken()) werden zusammengefasst: wartet für das gleiche Device und
+ * Event schon eine Meldung, wird diese durch die neue ersetzt, ohne einen weiteren Platz zu belegen.
+ * Damit wartet je Zustand höchstens eine Meldung, egal wie schnell der PC sendet. Aktionen (z.B.
+ * Steuerkommandos) werden immer in der Reihenfolge des Eingangs abgearbeitet.
+ *
+ * Ist die Eventqueue voll, wird das neue Event verworfen und gezählt (die älteren, bereits wartenden
+ * Events bleiben erhalten). @em addEvent() selbst meldet nichts; die Meldung (TRACE/LOG) übernimmt der
+ * Verbraucher über @em takeDropped().
  *
  ************************************************************************************************************/
 class EventQueueClass {
 public:
     /**
-     * @brief Konstruktor - Leere Liste anlegen.
-     */
-    EventQueueClass();
-
-    /**
-     * @brief Ein Event an das Ende der Liste anfügen.
+     * @brief Ein Event in die Eventqueue kopieren (Erzeuger).
      *
-     * @param ptrNewEvent Zeiger auf das anzufügende Event
+     * @param newEvent Das anzufügende Event
+     * @return @em true  Das Event wurde aufgenommen.\n
+     *         @em false Die Eventqueue ist voll; das Event wurde verworfen.
      */
-    void addEvent(EventClass* ptrNewEvent);
+    bool addEvent(const EventClass &newEvent);
 
     /**
-     * @brief Das nächste Element aus der Liste holen und das Element aus der Liste löschen.
-     * Falls es kein nächstes Element gibt, wird nullptr zurückgegeben.
+     * @brief Das älteste Event holen, ohne es aus der Eventqueue zu entfernen (Verbraucher).
+     * Falls die Eventqueue leer ist, wird nullptr zurückgegeben.
      *
-     * Der Speicher auf das Element wird nicht freigegeben. Es werden lediglich der @em head Pointer und
-     * der @em tail Pointer aktualisiert.
+     * Der Zeiger bleibt gültig, bis @em removeHeadEvent() aufgerufen wird.
      *
-     * @return EventClass
+     * @return EventClass*
      */
     EventClass *getHeadEvent();
 
     /**
-     * @brief Ein Event am Kopf der Liste löschen.
+     * @brief Das älteste Event aus der Eventqueue entfernen (Verbraucher).
+     */
+    void removeHeadEvent();
+
+    /**
+     * @brief Prüfen, ob seit dem letzten Aufruf Events verworfen wurden (Verbraucher).
+     *
+     * @param deviceId Liefert das Device des zuletzt verworfenen Events.
+     * @param eventId Liefert das Event des zuletzt verworfenen Events.
+     * @return @em true falls seit dem letzten Aufruf Events verworfen wurden, sonst @em false.
      */
-    void deleteHeadEvent(EventClass *event);
+    bool takeDropped(TokenId &deviceId, TokenId &eventId);
+
+    /// @brief Anzahl der wartenden Events.
+    inline uint8_t getCount() const { return static_cast<uint8_t>(tail - head); }
+
+    /// @brief Höchste Anzahl gleichzeitig wartender Events.
+    inline uint8_t getHighWater() const { return highWater; }
 
-    #ifdef DEBUG
-    void printQueue();
-    #endif
+    /// @brief Anzahl der wegen voller Eventqueue verworfenen Events.
+    inline unsigned long getDropped() const { return dropped; }
+
+    /// @brief Anzahl der Zustandsmeldungen, die durch eine neuere Meldung ersetzt wurden.
+    inline unsigned long getSuperseded() const { return superseded; }
 
 private:
-    EventClass* head;     ///< Zeiger auf 1. Event in der Eventliste
-    EventClass* tail;     ///< Zeiger auf das letzte Event in der Eventliste
+    EventClass events[EVENT_QUEUE_SIZE];    ///< Plätze für die Events
+    volatile uint8_t head = 0;      ///< Fortlaufender Index des ältesten Events; nur vom Verbraucher geschrieben
+    volatile uint8_t tail = 0;      ///< Fortlaufender Index des nächsten freien Platzes; nur vom Erzeuger geschrieben
+    uint8_t highWater = 0;          ///< Höchste Anzahl gleichzeitig wartender Events
+    unsigned long dropped = 0;      ///< Anzahl der verworfenen Events
+    unsigned long superseded = 0;   ///< Anzahl der ersetzten Zustandsmeldungen
+    unsigned long reportedDropped = 0;  ///< Stand von @em dropped beim letzten takeDropped(); nur vom Verbraucher geschrieben
+    TokenId droppedDeviceId = TokenId::NONE;    ///< Device des zuletzt verworfenen Events
+    TokenId droppedEventId = TokenId::NONE;     ///< Event des zuletzt verworfenen Events
+
+    bool replacePendingState(const EventClass &newEvent);
 };
@@ -0,0 +1,74 @@
+/*********************************************************************************************************//**
+ * @file framebuffer.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Implementierung der Klasse @em FramebufferClass.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#include <framebuffer.hpp>
+#include <devices.hpp>
+#include <statesync.hpp>
+
+extern LedMatrix leds;
+extern StateSyncClass stateSync;
+
+
+/*********************************************************************************************************//**
+ * FramebufferClass - public Methoden
+ *
+ ************************************************************************************************************/
+
+void FramebufferClass::setActive(const bool isEnabled) {
+    if (isEnabled == active) {
+        return;
+    }
+    active = isEnabled;
+    isFirstFrame = true;
+    // In beiden Richtungen mit einer leeren Matrix ohne Blinken beginnen.
+    for (uint8_t index = 0; index < LED_STATE_WORDS; ++index) {
+        leds.setStateWord(index, 0);
+    }
+    if (! active) {
+        devices.redraw();                   // die Geräte zeigen wieder alles neu an
+        stateSync.invalidate();             // der PC muss den Anzeigezustand neu senden
+    }
+}
+
+
+void FramebufferClass::receive(const uint8_t *payload, const uint8_t length) {
+    if (! active || (length < FRAMEBUFFER_HEADER_LENGTH)) {
+        rejected++;
+        return;
+    }
+    const uint8_t frame = payload[0];
+    const uint8_t rowMask = payload[1];
+    uint8_t rows = 0;
+    for (uint8_t row = 0; row < LED_ROWS; ++row) {
+        rows += (rowMask >> row) & 1;
+    }
+    if ((rowMask >> LED_ROWS != 0) || (length != FRAMEBUFFER_HEADER_LENGTH + rows * FRAMEBUFFER_ROW_LENGTH)) {
+        rejected++;
+        return;
+    }
+    if (isFirstFrame || (frame != lastFrame)) {
+        if (! isFirstFrame) {
+            lostFrames += static_cast<uint8_t>(frame - lastFrame - 1);
+        }
+        isFirstFrame = false;
+        lastFrame = frame;
+        frames++;
+    }
+    const uint8_t *rowData = &payload[FRAMEBUFFER_HEADER_LENGTH];
+    for (uint8_t row = 0; row < LED_ROWS; ++row) {
+        if ((rowMask & (1 << row)) != 0) {
+            leds.setStateWord(row, (static_cast<uint32_t>(rowData[0]) << 24)
+                                   | (static_cast<uint32_t>(rowData[1]) << 16)
+                                   | (static_cast<uint32_t>(rowData[2]) << 8) | rowData[3]);
+            rowData += FRAMEBUFFER_ROW_LENGTH;
+        }
+    }
+}
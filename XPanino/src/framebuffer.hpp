@@ -0,0 +1,67 @@
+/*********************************************************************************************************//**
+ * @file framebuffer.hpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Interface der Klasse @em FramebufferClass: LED-Matrix direkt vom PC beschreiben.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+#include <ledmatrix.hpp>
+
+const uint8_t FRAMEBUFFER_HEADER_LENGTH = 2;    ///< Frame-Zähler (1 Byte) und Zeilenmaske (1 Byte)
+const uint8_t FRAMEBUFFER_ROW_LENGTH = sizeof(uint32_t);    ///< Länge einer Zeile in den Nutzdaten
+
+static_assert(LED_ROWS <= 8, "Die Zeilenmaske hat nur 8 Bits.");
+
+
+/*********************************************************************************************************//**
+ * @brief Rohdaten-Modus: der PC rendert die Anzeige selbst und überträgt die LED-Matrix direkt.
+ *
+ * Im Rohdaten-Modus (@em FRAMEBUFFER_MODE mit 1) zeigen die Geräte nichts mehr selbst an, Display-Felder,
+ * Zeichentabelle und Blinken werden umgangen. Jeder Record @em FRAMEBUFFER enthält einen Frame-Zähler, eine
+ * Zeilenmaske und die 32 Bits jeder in der Maske gesetzten Zeile (Zeile 0 zuerst). So werden nur die
+ * geänderten Zeilen übertragen; eine vollständige Matrix wird auf zwei Records mit demselben Frame-Zähler
+ * verteilt. Lücken im Frame-Zähler werden als verlorene Frames gezählt.
+ *
+ * Mit @em FRAMEBUFFER_MODE 0 zeigen die Geräte wieder selbst an; der Anzeigezustand gilt dann als nicht
+ * abgeglichen (siehe StateSyncClass).
+ *
+ ************************************************************************************************************/
+class FramebufferClass {
+public:
+    /**
+     * @brief Den Rohdaten-Modus ein- bzw. ausschalten.
+     *
+     * @param isEnabled @em true = der PC überträgt die LED-Matrix direkt.
+     */
+    void setActive(bool isEnabled);
+
+
+    /**
+     * @brief Einen Record @em FRAMEBUFFER verarbeiten.
+     *
+     * @param payload Frame-Zähler, Zeilenmaske, je gesetztem Bit eine Zeile (uint32_t, MSB zuerst).
+     * @param length Länge der Nutzdaten.
+     */
+    void receive(const uint8_t *payload, uint8_t length);
+
+
+    inline bool isActive() const { return active; }                 ///< Rohdaten-Modus ist eingeschaltet
+    inline unsigned long getFrames() const { return frames; }       ///< Anzahl empfangener Frames
+    inline unsigned long getLostFrames() const { return lostFrames; }   ///< Anzahl verlorener Frames (Lücken)
+    inline uint16_t getRejected() const { return rejected; }        ///< Anzahl verworfener Records
+
+private:
+    bool active = false;            ///< Rohdaten-Modus ist eingeschaltet
+    bool isFirstFrame = true;       ///< Noch kein Frame seit dem Einschalten empfangen
+    uint8_t lastFrame = 0;          ///< Frame-Zähler des zuletzt empfangenen Frames
+    unsigned long frames = 0;       ///< Anzahl empfangener Frames
+    unsigned long lostFrames = 0;   ///< Anzahl verlorener Frames
+    uint16_t rejected = 0;          ///< Anzahl verworfener Records
+};
@@ -0,0 +1,60 @@
+/*********************************************************************************************************//**
+ * @file frameclock.hpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Interface der Klasse @em FrameClockClass: gemeinsamer Zeitstempel eines loop()-Durchlaufs.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+
+/// Zeitquelle in Millisekunden, z.B. millis() oder eine simulierte Uhr.
+using ClockSource = unsigned long (*)();
+
+
+/*********************************************************************************************************//**
+ * @brief Gemeinsamer Zeitstempel eines loop()-Durchlaufs.
+ *
+ * Die Zeit wird mit tick() einmal am Anfang jedes Durchlaufs gelesen; alle Teilsysteme (Abfrage,
+ * Entprellen, lange Tastendrücke, Blinken, Zeitüberwachungen der Geräte und der Übertragung) verwenden
+ * bis zum nächsten tick() denselben Wert von getNow(). Das spart die vielen millis()-Aufrufe mit jeweils
+ * gesperrten Interrupts, und innerhalb eines Durchlaufs sind sich alle über "jetzt" einig. Auch
+ * serialEvent() nach dem loop() verwendet noch die Zeit dieses Durchlaufs.
+ *
+ * Mit setSource() lässt sich statt millis() eine andere Zeitquelle einsetzen, z.B. eine simulierte Uhr,
+ * mit der Zeitabläufe reproduzierbar durchgespielt werden können.
+ *
+ ************************************************************************************************************/
+class FrameClockClass {
+public:
+    /**
+     * @brief Die Zeit für den neuen Durchlauf einmal von der Zeitquelle lesen.
+     *
+     * @return Der neue Zeitstempel in Millisekunden.
+     */
+    inline unsigned long tick() {
+        now = source();
+        return now;
+    }
+
+
+    /**
+     * @brief Die Zeitquelle einstellen.
+     *
+     * @param newSource Neue Zeitquelle; @em nullptr = millis().
+     */
+    inline void setSource(const ClockSource newSource) { source = (newSource != nullptr) ? newSource : millis; }
+
+    inline unsigned long getNow() const { return now; }     ///< Zeitstempel des aktuellen Durchlaufs in ms
+
+private:
+    ClockSource source = millis;    ///< Zeitquelle
+    unsigned long now = 0;          ///< Zeitstempel des aktuellen Durchlaufs in ms
+};
+
+extern FrameClockClass frameClock;
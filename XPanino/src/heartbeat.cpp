@@ -0,0 +1,83 @@
+/*********************************************************************************************************//**
+ * @file heartbeat.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Implementierung der Klasse @em HeartbeatClass.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#include <heartbeat.hpp>
+#include <devices.hpp>
+#include <framebuffer.hpp>
+#include <ledmatrix.hpp>
+#include <logger.hpp>
+
+extern FramebufferClass framebuffer;
+extern LedMatrix leds;
+
+
+/*********************************************************************************************************//**
+ * HeartbeatClass - public Methoden
+ *
+ ************************************************************************************************************/
+
+void HeartbeatClass::begin() {
+    linkUp = false;
+    enterFallback();
+}
+
+
+void HeartbeatClass::onActivity(const unsigned long now) {
+    lastActivity = now;
+    if (! linkUp) {
+        linkUp = true;
+        linkUps++;
+        LOG(LINK_UP, linkUps, 0);
+        leaveFallback();
+    }
+}
+
+
+void HeartbeatClass::setTimeout(const uint16_t timeoutMs) {
+    if (timeoutMs == 0) {
+        timeout = HEARTBEAT_DEFAULT_TIMEOUT;
+    } else {
+        timeout = max(timeoutMs, HEARTBEAT_MIN_TIMEOUT);
+    }
+}
+
+
+void HeartbeatClass::update(const unsigned long now) {
+    if (linkUp && (now - lastActivity >= timeout)) {
+        linkUp = false;
+        linkDowns++;
+        LOG(LINK_DOWN, now - lastActivity, 0);
+        enterFallback();
+    }
+}
+
+
+/*********************************************************************************************************//**
+ * ab hier die privaten Methoden
+*************************************************************************************************************/
+
+/**
+ * @brief Den aktuellen Stand der LED-Matrix sichern und alle Geräte auf die lokale Anzeige umschalten.
+ */
+void HeartbeatClass::enterFallback() {
+    framebuffer.setActive(false);   // ohne PC gibt es keine vom PC gerenderte Anzeige
+    leds.saveState();
+    devices.setLinkUp(false);
+}
+
+
+/**
+ * @brief Den gesicherten Stand der LED-Matrix wiederherstellen; die Geräte zeigen wieder die Werte des PCs.
+ */
+void HeartbeatClass::leaveFallback() {
+    leds.restoreState();
+    devices.setLinkUp(true);
+}
@@ -0,0 +1,80 @@
+/*********************************************************************************************************//**
+ * @file heartbeat.hpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Interface der Klasse @em HeartbeatClass: Überwachung der Verbindung zum Flugsimulator.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+
+const uint16_t HEARTBEAT_DEFAULT_TIMEOUT = 3000;    ///< Zeit in ms ohne Empfang, nach der die Verbindung als getrennt gilt
+const uint16_t HEARTBEAT_MIN_TIMEOUT = 500;         ///< Kleinste einstellbare Zeit in ms
+
+
+/*********************************************************************************************************//**
+ * @brief Überwachung der Verbindung zum PC bzw. Flugsimulator.
+ *
+ * Jedes gültig empfangene Kommando (Klartextzeile oder Frame) gilt als Lebenszeichen; ist nichts anderes zu
+ * senden, schickt der PC `CTRL;HB` bzw. den Kommandocode @em HEARTBEAT. Bleibt das Lebenszeichen länger als
+ * die eingestellte Zeit aus, schalten alle Geräte auf ihre lokale Anzeige "noFS" um. Der bis dahin angezeigte
+ * Stand der LED-Matrix wird gesichert und beim nächsten Lebenszeichen wiederhergestellt, so dass der PC nach
+ * dem Wiederverbinden nicht alles neu senden muss.
+ *
+ * Nach dem Start gilt die Verbindung als getrennt, bis sich der PC zum ersten Mal meldet.
+ *
+ ************************************************************************************************************/
+class HeartbeatClass {
+public:
+    /**
+     * @brief Überwachung starten; bis zum ersten Lebenszeichen zeigen die Geräte "noFS".
+     * @note Erst am Ende von setup() aufrufen, wenn alle Geräte ihren Anfangszustand angezeigt haben.
+     */
+    void begin();
+
+
+    /**
+     * @brief Ein Lebenszeichen des PCs ist angekommen.
+     *
+     * @param now Aktuelle Zeit in Millisekunden.
+     */
+    void onActivity(unsigned long now);
+
+
+    /**
+     * @brief Die Zeit bis zur Erkennung einer getrennten Verbindung einstellen.
+     *
+     * @param timeoutMs Zeit in ms; 0 = Standardwert; kleinere Werte als @em HEARTBEAT_MIN_TIMEOUT werden angehoben.
+     */
+    void setTimeout(uint16_t timeoutMs);
+
+
+    /**
+     * @brief Prüfen, ob das Lebenszeichen ausgeblieben ist.
+     * @note Diese Methode muss einmal je loop() aufgerufen werden.
+     *
+     * @param now Aktuelle Zeit in Millisekunden.
+     */
+    void update(unsigned long now);
+
+
+    inline bool isLinkUp() const { return linkUp; }                     ///< Verbindung zum PC besteht
+    inline uint16_t getTimeout() const { return timeout; }              ///< Eingestellte Zeit in ms
+    inline uint16_t getLinkUps() const { return linkUps; }              ///< Anzahl der Wechsel auf "verbunden"
+    inline uint16_t getLinkDowns() const { return linkDowns; }          ///< Anzahl der Wechsel auf "getrennt"
+
+private:
+    bool linkUp = false;                            ///< Verbindung zum PC besteht
+    unsigned long lastActivity = 0;                 ///< Zeitpunkt des letzten Lebenszeichens
+    uint16_t timeout = HEARTBEAT_DEFAULT_TIMEOUT;   ///< Zeit in ms bis zur Erkennung einer getrennten Verbindung
+    uint16_t linkUps = 0;                           ///< Anzahl der Wechsel auf "verbunden"
+    uint16_t linkDowns = 0;                         ///< Anzahl der Wechsel auf "getrennt"
+
+    void enterFallback();
+    void leaveFallback();
+};
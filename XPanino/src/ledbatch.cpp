@@ -0,0 +1,157 @@
+/*********************************************************************************************************//**
+ * @file ledbatch.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Implementierung der Klasse @em LedBatchClass.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#include <ledbatch.hpp>
+#include <ledmatrix.hpp>
+
+extern EventQueueClass eventQueue;
+extern LedMatrix leds;
+
+const uint8_t LED_BATCH_POS_LENGTH = 3;         ///< Länge einer Änderung LED_ON/LED_OFF inkl. Art
+const uint8_t LED_BATCH_BLINK_LENGTH = 4;       ///< Länge einer Änderung BLINK_ON/BLINK_OFF inkl. Art
+const uint8_t LED_BATCH_DISPLAY_HEADER = 3;     ///< Länge einer Änderung DISPLAY inkl. Art, ohne die Zeichen
+
+
+/*********************************************************************************************************//**
+ * LedBatchClass - public Methoden
+ *
+ ************************************************************************************************************/
+
+bool LedBatchClass::receive(const uint8_t *payload, const uint8_t length) {
+    if ((length == 0) || (length > LED_BATCH_MAX_LENGTH) || ! isValid(payload, length) || (getFree() == 0)) {
+        rejected++;
+        return false;
+    }
+    EventClass event {};
+    strcpy(event.device, "LED");
+    strcpy(event.event, "BAT");
+    event.intern();
+    if (! eventQueue.addEvent(event)) {
+        rejected++;
+        return false;
+    }
+    const uint8_t slot = tail & (LED_BATCH_QUEUE_SIZE - 1);
+    memcpy(pending[slot], payload, length);
+    pendingLength[slot] = length;
+    tail++;
+    return true;
+}
+
+
+void LedBatchClass::processEvent(EventClass *event) {
+    if ((event != nullptr) && (event->eventId == TokenId::EV_BAT) && (head != tail)) {
+        const uint8_t slot = head & (LED_BATCH_QUEUE_SIZE - 1);
+        apply(pending[slot], pendingLength[slot]);
+        head++;
+    }
+}
+
+
+/*********************************************************************************************************//**
+ * ab hier die privaten Methoden
+*************************************************************************************************************/
+
+/**
+ * @brief Alle Änderungen eines geprüften Sammelkommandos gemeinsam anwenden.
+ *
+ * @param batch Das Sammelkommando.
+ * @param length Länge des Sammelkommandos.
+ */
+void LedBatchClass::apply(const uint8_t *batch, const uint8_t length) {
+    leds.beginUpdate();
+    uint8_t pos = 0;
+    while (pos < length) {
+        const auto op = static_cast<LedBatchOp>(batch[pos]);
+        const LedMatrixPos ledPos {batch[pos + 1], batch[pos + 2]};
+        switch (op) {
+            case LedBatchOp::LED_ON: { leds.ledOn(ledPos); pos += LED_BATCH_POS_LENGTH; break; }
+            case LedBatchOp::LED_OFF: { leds.ledOff(ledPos); pos += LED_BATCH_POS_LENGTH; break; }
+            case LedBatchOp::BLINK_ON: {
+                leds.ledBlinkOn(ledPos, batch[pos + 3]);
+                pos += LED_BATCH_BLINK_LENGTH;
+                break;
+            }
+            case LedBatchOp::BLINK_OFF: {
+                leds.ledBlinkOff(ledPos, batch[pos + 3]);
+                pos += LED_BATCH_BLINK_LENGTH;
+                break;
+            }
+            default: {   // DISPLAY: die Zeichen als C-String übergeben
+                char chars[MAX_7SEGMENT_UNITS * 2 + 1];    // jede Stelle ggf. mit Dezimalpunkt
+                const uint8_t count = batch[pos + 2];
+                memcpy(chars, &batch[pos + LED_BATCH_DISPLAY_HEADER], count);
+                chars[count] = '\0';
+                leds.display(batch[pos + 1], chars);
+                pos += LED_BATCH_DISPLAY_HEADER + count;
+            }
+        }
+    }
+    leds.endUpdate();
+    applied++;
+}
+
+
+/**
+ * @brief Ein Sammelkommando vollständig prüfen, bevor irgendetwas angewendet wird.
+ *
+ * Jede Änderung muss vollständig sein und auf eine vorhandene LED bzw. ein vorhandenes Display-Feld
+ * mit höchstens zwei Zeichen je Stelle (Ziffer und Dezimalpunkt) verweisen.
+ *
+ * @param payload Die Nutzdaten.
+ * @param length Länge der Nutzdaten.
+ * @return @em true falls alle Änderungen vollständig und gültig sind.
+ */
+bool LedBatchClass::isValid(const uint8_t *payload, const uint8_t length) {
+    uint8_t pos = 0;
+    while (pos < length) {
+        const uint8_t remaining = length - pos;
+        switch (static_cast<LedBatchOp>(payload[pos])) {
+            case LedBatchOp::LED_ON:
+            case LedBatchOp::LED_OFF: {
+                if ((remaining < LED_BATCH_POS_LENGTH) || ! isLedPos(&payload[pos + 1])) {
+                    return false;
+                }
+                pos += LED_BATCH_POS_LENGTH;
+                break;
+            }
+            case LedBatchOp::BLINK_ON:
+            case LedBatchOp::BLINK_OFF: {
+                if ((remaining < LED_BATCH_BLINK_LENGTH) || ! isLedPos(&payload[pos + 1])
+                    || (payload[pos + 3] >= NO_OF_SPEED_CLASSES)) {
+                    return false;
+                }
+                pos += LED_BATCH_BLINK_LENGTH;
+                break;
+            }
+            case LedBatchOp::DISPLAY: {
+                if ((remaining < LED_BATCH_DISPLAY_HEADER) || (payload[pos + 1] >= MAX_DISPLAY_FIELDS)
+                    || (payload[pos + 2] > MAX_7SEGMENT_UNITS * 2)
+                    || (remaining < LED_BATCH_DISPLAY_HEADER + payload[pos + 2])) {
+                    return false;
+                }
+                pos += LED_BATCH_DISPLAY_HEADER + payload[pos + 2];
+                break;
+            }
+            default: return false;  // unbekannte Art der Änderung
+        }
+    }
+    return true;
+}
+
+
+/**
+ * @brief Prüfen, ob Zeile und Spalte innerhalb der LED-Matrix liegen.
+ *
+ * @param rowCol Zeiger auf die beiden Bytes row und col.
+ */
+bool LedBatchClass::isLedPos(const uint8_t *rowCol) {
+    return (rowCol[0] < LED_ROWS) && (rowCol[1] < LED_COLS);
+}
@@ -0,0 +1,88 @@
+/*********************************************************************************************************//**
+ * @file ledbatch.hpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Interface der Klasse @em LedBatchClass: mehrere Änderungen der LED-Matrix in einem Kommando.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+#include <event.hpp>
+#include <protocol.hpp>
+
+const uint8_t LED_BATCH_MAX_LENGTH = FRAME_MAX_LENGTH;  ///< Max. Länge der Nutzdaten eines Sammelkommandos
+const uint8_t LED_BATCH_QUEUE_SIZE = 2;     ///< Anzahl wartender Sammelkommandos; muss eine Zweierpotenz sein
+static_assert((LED_BATCH_QUEUE_SIZE & (LED_BATCH_QUEUE_SIZE - 1)) == 0,
+              "LED_BATCH_QUEUE_SIZE muss eine Zweierpotenz sein.");
+
+
+/*********************************************************************************************************//**
+ * @brief Arten der Änderungen in einem Sammelkommando @em LED_BATCH.
+ *
+ ************************************************************************************************************/
+enum class LedBatchOp : uint8_t {
+    LED_ON = 1,         ///< row, col: LED einschalten
+    LED_OFF = 2,        ///< row, col: LED ausschalten
+    BLINK_ON = 3,       ///< row, col, speed: Blinken einschalten
+    BLINK_OFF = 4,      ///< row, col, speed: Blinken ausschalten
+    DISPLAY = 5         ///< fieldId, n, n Zeichen: Wert auf einem Display-Feld anzeigen
+};
+
+
+/*********************************************************************************************************//**
+ * @brief Sammelkommando für die LED-Matrix (Kommandocode @em LED_BATCH im Binärprotokoll).
+ *
+ * Die Nutzdaten enthalten mehrere Änderungen hintereinander, z.B. Squawk, Flightlevel und die LED "R".
+ * Beim Empfang wird das Sammelkommando einmal vollständig geprüft und in einem kleinen Ringpuffer
+ * zwischengespeichert; in die Eventqueue kommt je Sammelkommando ein Event @em LED;BAT. Jedes Event wendet
+ * das älteste wartende Sammelkommando an, also in der Reihenfolge, in der die Events vom PC kamen. Alle
+ * Änderungen eines Sammelkommandos werden innerhalb von @em LedMatrix::beginUpdate() / @em endUpdate()
+ * angewendet, so dass sie gemeinsam im selben Refresh sichtbar werden. Ist auch nur eine Änderung
+ * fehlerhaft, wird das ganze Sammelkommando verworfen.
+ *
+ * Damit ein gesicherter Frame nicht bestätigt und dann verworfen wird, prüft die ProtocolClass vorher mit
+ * @em getFree(), ob Platz ist, und nimmt den Frame sonst nicht an (siehe ProtocolClass::processFrame()).
+ *
+ ************************************************************************************************************/
+class LedBatchClass {
+public:
+    /**
+     * @brief Ein empfangenes Sammelkommando prüfen, zwischenspeichern und das Event @em LED;BAT erzeugen.
+     *
+     * @param payload Die Nutzdaten des Records.
+     * @param length Länge der Nutzdaten.
+     * @return @em true falls das Sammelkommando gültig ist und Platz im Ringpuffer und in der Eventqueue hatte.
+     */
+    bool receive(const uint8_t *payload, uint8_t length);
+
+
+    /**
+     * @brief Event für das Device @em LED verarbeiten: das älteste wartende Sammelkommando anwenden.
+     *
+     * @param event Das Event.
+     */
+    void processEvent(EventClass *event);
+
+
+    /// Anzahl freier Plätze im Ringpuffer
+    inline uint8_t getFree() const { return static_cast<uint8_t>(LED_BATCH_QUEUE_SIZE - (tail - head)); }
+    inline unsigned long getApplied() const { return applied; }     ///< Anzahl angewendeter Sammelkommandos
+    inline unsigned long getRejected() const { return rejected; }   ///< Anzahl verworfener Sammelkommandos
+
+private:
+    uint8_t pending[LED_BATCH_QUEUE_SIZE][LED_BATCH_MAX_LENGTH];    ///< Wartende Sammelkommandos (Ringpuffer)
+    uint8_t pendingLength[LED_BATCH_QUEUE_SIZE];    ///< Länge der wartenden Sammelkommandos
+    uint8_t head = 0;                       ///< Index (modulo Größe) des ältesten wartenden Sammelkommandos
+    uint8_t tail = 0;                       ///< Index (modulo Größe) des nächsten freien Platzes
+    unsigned long applied = 0;              ///< Anzahl angewendeter Sammelkommandos
+    unsigned long rejected = 0;             ///< Anzahl verworfener Sammelkommandos
+
+    void apply(const uint8_t *batch, uint8_t length);
+    static bool isValid(const uint8_t *payload, uint8_t length);
+    static bool isLedPos(const uint8_t *rowCol);
+};
@@ -54,7 +54,7 @@ LedMatrix::LedMatrix() {
             blinkStatus[speedClass][row] = 0;         // Keine LED blinkt
         }
         isBlinkDarkPhase[speedClass] = true;
-        blinkStartTime[speedClass] = millis(); // + speedClass * BLINK_VERSATZ;   // Startzeit mit Versatz
+        blinkStartTime[speedClass] = 0;     // globales Objekt: vor dem Start der Zeitbasis, millis() wäre ebenfalls 0
     }
     /// Defaultwerte für die Blinkdauern der Speedklassen der nächsten anstehenden Hellphase
     nextBlinkInterval[BLINK_NORMAL] = blinkTimes[BLINK_NORMAL].getBrightTime();    // Dauer der Hellphase als Initialwert
@@ -106,9 +106,9 @@ void LedMatrix::initHardware() {
  * Wenn zu viele andere Aktivitäten zwischen den display()-Aufrufen
  * stattfinden, wird die Anzeige mehr oder weniger stark flimmern.
  */
-void LedMatrix::writeToHardware() {
+void LedMatrix::writeToHardware(const unsigned long &now) {
     // Alle Berechnungen zum Blinken erledigen
-    doBlink();
+    doBlink(now);
     // Die hwMatrix serialisieren, in die Schieberegister schieben und die Outputs scharf schalten
     for (uint8_t row = 0; row != LED_ROWS; ++row) {
         digitalWrite(STRB, LOW);    // STROBE unbedingt auf LOW setzen damit die Registerinhalte in die Latches übernommen werden
@@ -354,6 +354,15 @@ void LedMatrix::defineDisplayField(const uint8_t &fieldId, const uint8_t &led7Se
  *
  */
 void LedMatrix::display(const uint8_t &fieldId, const String &outString) {
+    display(fieldId, outString.c_str());
+}
+
+
+/**
+ *
+ *
+ */
+void LedMatrix::display(const uint8_t &fieldId, const char *outString) {
     bool dpOn = false;         // Flag, ob Dezimalpunkt im akt. 7-Segment-Display angezeigt wird
     uint8_t dpKorrektur = 0;   // Korrektur zum Positionszähler, falls Dezimalpunkt(e) gefunden
     uint8_t led7SegmentIndex = 0;  // Index für die 7-Segm.-Anz., wo das Zeichen ausgegeben wird
@@ -362,15 +371,15 @@ void LedMatrix::display(const uint8_t &fieldId, const String &outString) {
     uint8_t charBitMap = 0;    // Bitmap des auf der 7-Segment-Anzeige darzustellenden Zeichens
 
     // Den anzuzeigenden outString Zeichen für Zeichen abklappern...
-    for (const auto &outChar : outString) {
+    for (const char *outChar = outString; *outChar != '\0'; ++outChar) {
         // Konstante zum Ausrechnen des charMapIndex aus dem ASCII-Code
         // Falls das aktuelle Zeichen ein Dezimalpunkt ist, dieses übergehen, da es bereits
         // verarbeitet bzw. anderweitig verarbeitet wird.
-        if (outChar == '.') {
+        if (*outChar == '.') {
             dpKorrektur++;
         } else {
             // Bitmap für das Zeichen holen;
-            charBitMap = charMap.get7SegBitMap(outChar);
+            charBitMap = charMap.get7SegBitMap(*outChar);
             // Prüfen, ob das dem aktuellen Zeichen folgende Zeichen ein Dezimalpunkt ist und Flag entsprechend setzen.
             if (outString[led7SegmentIndex + 1] == '.') {
                 dpOn = true;    // NOLINT
@@ -387,6 +396,38 @@ void LedMatrix::display(const uint8_t &fieldId, const String &outString) {
 };
 
 
+void LedMatrix::saveState() {
+    memcpy(savedMatrix, matrix, sizeof(matrix));
+    memcpy(savedBlinkStatus, blinkStatus, sizeof(blinkStatus));
+}
+
+
+void LedMatrix::restoreState() {
+    memcpy(matrix, savedMatrix, sizeof(matrix));
+    memcpy(blinkStatus, savedBlinkStatus, sizeof(blinkStatus));
+}
+
+
+uint32_t LedMatrix::getStateWord(const uint8_t index) const {
+    if (index < LED_ROWS) {
+        return matrix[index];
+    }
+    if (index < LED_STATE_WORDS) {
+        return blinkStatus[(index - LED_ROWS) / LED_ROWS][index % LED_ROWS];
+    }
+    return 0;
+}
+
+
+void LedMatrix::setStateWord(const uint8_t index, const uint32_t value) {
+    if (index < LED_ROWS) {
+        matrix[index] = value;
+    } else if (index < LED_STATE_WORDS) {
+        blinkStatus[(index - LED_ROWS) / LED_ROWS][index % LED_ROWS] = value;
+    }
+}
+
+
 /*********************************************************************************************************//**
  * ab hier die privaten Methoden
 *************************************************************************************************************/
@@ -447,7 +488,7 @@ bool LedMatrix::isSomethingToBlink() {
 /**
  * @brief Ein-/Aus-Status für die LEDs gemäß der aktuellen Hell-/Dunkelphase des Blinkens festlegen.
  */
-void LedMatrix::doBlink() {
+void LedMatrix::doBlink(const unsigned long &now) {
     /// Wenn was zu blinken ist und das Blinkintervall abgelaufen ist, die Blinkphase umschalten.
     /// isBlinkDarkPhaseXXX wurde mit Anfangs mit false initialisiert, d.h. das Blinken startet
     /// immer mit einer Hellphase.
@@ -456,18 +497,23 @@ void LedMatrix::doBlink() {
     if (blinkOn) {
         /// Check auf Zeitablauf, so dass die Hell- und Dunkelphasen umgeschaltet werden müssen
         for (uint8_t speedClass = 0; speedClass != NO_OF_SPEED_CLASSES; ++speedClass) {
-            if (millis() - blinkStartTime[speedClass] > nextBlinkInterval[speedClass]) {
+            if (now - blinkStartTime[speedClass] > nextBlinkInterval[speedClass]) {
                 if (isBlinkDarkPhase[speedClass]) {
                     nextBlinkInterval[speedClass] = blinkTimes[speedClass].getBrightTime();
                 } else {
                     nextBlinkInterval[speedClass] = blinkTimes[speedClass].getDarkTime();
                 }
                 isBlinkDarkPhase[speedClass] = ! isBlinkDarkPhase[speedClass];
-                blinkStartTime[speedClass] = millis(); // + speedClass * BLINK_VERSATZ;
+                blinkStartTime[speedClass] = now; // + speedClass * BLINK_VERSATZ;
             }
         }
     }
 
+    /// Solange Änderungen zusammengefasst werden (beginUpdate()), den bisherigen Stand weiter anzeigen.
+    if (updateDepth > 0) {
+        return;
+    }
+
     /// Die matrix in die hwMatrix kopieren, die die LEDs steuert. Während der Dunkelphase müssen die entsprechenden
     /// blinkenden LEDs ausgeschaltet werden.
     for (uint32_t row = 0; row != LED_ROWS; ++row) {
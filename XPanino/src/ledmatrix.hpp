@@ -62,6 +62,9 @@ const SpeedClass blinkTimes[NO_OF_SPEED_CLASSES] = {    ///< Blinkgeschwindigkei
         {2000, 6000}  ///< BLINK_SLOW:   2000 ms hell, 6000 ms dunkel
       };
 
+/// Anzahl der Zustandsworte der LED-Matrix: je Zeile ein/aus und das Blinken je Geschwindigkeitsklasse.
+const uint8_t LED_STATE_WORDS = LED_ROWS * (1 + NO_OF_SPEED_CLASSES);
+
 
 
 /*********************************************************************************************************//**
@@ -110,8 +113,10 @@ public:
      * @brief Die die LEDs repräsentierenden Bits serialisieren und an die MIC5891/5821-Chips übertragen.
      * @note Diese Funktion muss regelmäßig und sehr häufig innerhalb des loop
      *       aufgerufen werden!
+     *
+     * @param now Aktueller Zeitstempel in Millisekunden für das Blinken, z.B. frameClock.getNow()
      */
-    void writeToHardware();
+    void writeToHardware(const unsigned long &now);
 
 
     /**
@@ -287,12 +292,72 @@ public:
     void display(const uint8_t &fieldId, const String &outString);
 
 
+    /**
+     * @brief Einen Wert (C-String) auf einem Display ausgeben; wie @em display() mit String, aber ohne Heap.
+     *
+     * @param fieldId   Id des Display-Felds, auf dem der outString ausgegeben werden soll
+     * @param outString Die auszugebenden Zeichen.
+     */
+    void display(const uint8_t &fieldId, const char *outString);
+
+
+    /**
+     * @brief Mehrere Änderungen zusammenfassen: bis zum zugehörigen @em endUpdate() zeigt
+     *        @em writeToHardware() weiter den bisherigen Stand an.
+     *
+     * Damit werden alle Änderungen dazwischen gemeinsam im selben Refresh sichtbar.
+     * Aufrufe dürfen geschachtelt werden.
+     */
+    inline void beginUpdate() { updateDepth++; }
+
+
+    /**
+     * @brief Die mit @em beginUpdate() begonnene Zusammenfassung abschließen.
+     */
+    inline void endUpdate() { if (updateDepth > 0) { updateDepth--; } }
+
+
+    /**
+     * @brief Den aktuellen Stand aller LEDs (ein/aus und Blinken) sichern, z.B. bevor die Geräte bei
+     *        getrennter Verbindung ihre lokale Anzeige zeigen.
+     */
+    void saveState();
+
+
+    /**
+     * @brief Den mit @em saveState() gesicherten Stand aller LEDs wiederherstellen.
+     */
+    void restoreState();
+
+
+    /**
+     * @brief Ein Zustandswort der LED-Matrix lesen (z.B. für den Abgleich mit dem PC).
+     *
+     * @param index 0 bis LED_ROWS - 1: ein/aus je Zeile; danach je Geschwindigkeitsklasse das Blinken
+     *              je Zeile (BLINK_NORMAL, dann BLINK_SLOW).
+     * @return Die 32 Bits der Zeile bzw. 0 bei ungültigem Index.
+     */
+    uint32_t getStateWord(uint8_t index) const;
+
+
+    /**
+     * @brief Ein Zustandswort der LED-Matrix setzen; Index wie bei @em getStateWord().
+     *
+     * @param index Index des Zustandsworts; ungültige Indizes werden ignoriert.
+     * @param value Die 32 Bits der Zeile.
+     */
+    void setStateWord(uint8_t index, uint32_t value);
+
+
 private:
     uint32_t matrix[LED_ROWS];    ///< Matrix für den logischen Status (ein oder aus) je LED.
     uint32_t hwMatrix[LED_ROWS];  ///< Akt. Status ein/aus je LED. Diese Matrix steuert direkt die Hardware.
+    uint8_t updateDepth = 0;      ///< > 0: Änderungen laufen; hwMatrix nicht aus matrix aktualisieren
     DisplayField displays[MAX_DISPLAY_FIELDS];  ///< Display-Felder (= Zusammenfassung von 7-Segment-Anzeigen).
     Led7SegmentCharMap charMap;                  ///< Zeichentabelle für 7-Segment-Anzeige(n)
     uint32_t blinkStatus[NO_OF_SPEED_CLASSES][LED_ROWS];    ///< Status ob geblinkt werden soll je Geschwindigkeitsklasse und LED.
+    uint32_t savedMatrix[LED_ROWS];                             ///< Mit saveState() gesicherte matrix
+    uint32_t savedBlinkStatus[NO_OF_SPEED_CLASSES][LED_ROWS];   ///< Mit saveState() gesicherter blinkStatus
     unsigned long int blinkStartTime[NO_OF_SPEED_CLASSES];  ///< Gibt den Takt des normal-schnellen Blinkens für alle LEDs vor.
     bool isBlinkDarkPhase[NO_OF_SPEED_CLASSES];  ///< Flag für die Dunkelphase beim normalen Blinken.
     unsigned long int nextBlinkInterval[NO_OF_SPEED_CLASSES];  ///< Dauer des nächsten Blink-Intervalls (abhängig von blinkTimes[].brightTime und ...darkTime.
@@ -300,5 +365,5 @@ private:
     bool isValidRowCol(LedMatrixPos pos);
     bool isValidBlinkSpeed(uint8_t blinkSpeed);
     bool isSomethingToBlink();
-    void doBlink();
+    void doBlink(const unsigned long &now);
 };
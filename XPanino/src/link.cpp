@@ -0,0 +1,97 @@
+/*********************************************************************************************************//**
+ * @file link.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Implementierung der Klasse @em LinkClass.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#include <link.hpp>
+
+extern TxQueueClass txQueue;
+
+
+/*********************************************************************************************************//**
+ * LinkClass - public Methoden
+ *
+ ************************************************************************************************************/
+
+void LinkClass::reset() {
+    base = 0;
+    nextSeq = 0;
+    resending = false;
+    rxExpected = 0;
+    ackPending = false;
+}
+
+
+void LinkClass::track(TxMessage &message, const unsigned long now) {
+    if (base == nextSeq) {
+        timerStart = now;   // Fenster war leer: Wartezeit beginnt jetzt
+    }
+    message.seq = nextSeq;
+    window[nextSeq & (LINK_WINDOW_SIZE - 1)] = message;
+    nextSeq++;
+}
+
+
+void LinkClass::onAck(const uint8_t seq, const unsigned long now) {
+    const uint8_t acked = static_cast<uint8_t>(seq - base + 1);     // Anzahl neu bestätigter Ereignisse
+    if ((acked == 0) || (acked > static_cast<uint8_t>(nextSeq - base))) {
+        return;     // alte oder ungültige Bestätigung
+    }
+    base = seq + 1;
+    timerStart = now;
+    if (resending && (static_cast<uint8_t>(resendSeq - base) >= LINK_WINDOW_SIZE)) {
+        resendSeq = base;   // die Wiederholung hat bereits bestätigte Ereignisse überholt
+    }
+}
+
+
+bool LinkClass::acceptSequence(const uint8_t seq) {
+    ackPending = true;  // auch bei Duplikaten bestätigen, damit der PC nicht endlos wiederholt
+    if (seq != rxExpected) {
+        duplicates++;
+        return false;
+    }
+    rxExpected++;
+    return true;
+}
+
+
+void LinkClass::update(const unsigned long now) {
+    if (base == nextSeq) {
+        resending = false;
+        return;     // alles bestätigt
+    }
+    if (! resending && (now - timerStart >= LINK_RETRANSMIT_TIMEOUT)) {
+        resending = true;
+        resendSeq = base;
+    }
+    if (! resending) {
+        return;
+    }
+    // Go-Back-N: ab dem ältesten unbestätigten Ereignis alles erneut senden, soweit die Warteschlange Platz hat
+    while ((resendSeq != nextSeq) && ! txQueue.isFull()
+           && txQueue.addMessage(window[resendSeq & (LINK_WINDOW_SIZE - 1)])) {
+        resendSeq++;
+        retransmits++;
+    }
+    if (resendSeq == nextSeq) {
+        resending = false;
+        timerStart = now;
+    }
+}
+
+
+bool LinkClass::takeAck(uint8_t &seq) {
+    if (! ackPending) {
+        return false;
+    }
+    ackPending = false;
+    seq = rxExpected - 1;
+    return true;
+}
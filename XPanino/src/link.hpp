@@ -0,0 +1,119 @@
+/*********************************************************************************************************//**
+ * @file link.hpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Interface der Klasse @em LinkClass: gesicherte Übertragung im Binärprotokoll.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+#include <txqueue.hpp>
+
+const uint8_t LINK_WINDOW_SIZE = 8;             ///< Max. Anzahl unbestätigter Schalterereignisse; Zweierpotenz
+const uint16_t LINK_RETRANSMIT_TIMEOUT = 200;   ///< Wartezeit in ms auf die Bestätigung, bevor wiederholt wird
+
+static_assert((LINK_WINDOW_SIZE & (LINK_WINDOW_SIZE - 1)) == 0, "LINK_WINDOW_SIZE muss eine Zweierpotenz sein.");
+
+
+/*********************************************************************************************************//**
+ * @brief Gesicherte Übertragung (Folgenummern, kumulative Bestätigung, Wiederholung) im Binärprotokoll.
+ *
+ * Arduino --> PC: Jedes Schalterereignis erhält eine Folgenummer und bleibt im Sendefenster, bis der PC
+ * es mit einem @em ACK-Record bestätigt. Der PC bestätigt kumulativ die letzte lückenlos empfangene
+ * Folgenummer. Es dürfen bis zu @em LINK_WINDOW_SIZE Ereignisse unbestätigt unterwegs sein, d.h. es wird
+ * nicht auf jede einzelne Bestätigung gewartet. Kommt innerhalb von @em LINK_RETRANSMIT_TIMEOUT keine
+ * Bestätigung, werden alle unbestätigten Ereignisse ab dem ältesten erneut gesendet (Go-Back-N).
+ * Doppelt empfangene Ereignisse erkennt der PC an der Folgenummer.
+ *
+ * PC --> Arduino: Beginnt ein Frame mit einem @em SEQUENCE-Record, wird er nur verarbeitet, wenn die
+ * Folgenummer die nächste erwartete ist. Doppelte oder zu frühe Frames werden verworfen. In beiden Fällen
+ * sendet der Arduino mit dem nächsten Frame einen @em ACK-Record mit der letzten lückenlos empfangenen
+ * Folgenummer. Frames ohne @em SEQUENCE-Record werden wie bisher ungesichert verarbeitet.
+ *
+ * Der Speicherbedarf ist konstant.
+ *
+ ************************************************************************************************************/
+class LinkClass {
+public:
+    /**
+     * @brief Beide Richtungen neu beginnen (z.B. nach dem Umschalten des Protokolls).
+     * Unbestätigte Ereignisse werden verworfen.
+     */
+    void reset();
+
+
+    /**
+     * @brief Prüfen, ob im Sendefenster noch Platz für ein weiteres Schalterereignis ist.
+     */
+    inline bool hasWindowSpace() const { return static_cast<uint8_t>(nextSeq - base) < LINK_WINDOW_SIZE; }
+
+
+    /**
+     * @brief Ein Schalterereignis in das Sendefenster aufnehmen und ihm die nächste Folgenummer geben.
+     * @note Vorher muss mit @em hasWindowSpace() geprüft werden, ob Platz ist.
+     *
+     * @param message Das Schalterereignis; @em seq wird gesetzt.
+     * @param now Aktuelle Zeit in Millisekunden.
+     */
+    void track(TxMessage &message, unsigned long now);
+
+
+    /**
+     * @brief Kumulative Bestätigung vom PC verarbeiten.
+     *
+     * @param seq Letzte lückenlos empfangene Folgenummer.
+     * @param now Aktuelle Zeit in Millisekunden.
+     */
+    void onAck(uint8_t seq, unsigned long now);
+
+
+    /**
+     * @brief Folgenummer eines vom PC empfangenen Frames prüfen.
+     *
+     * @param seq Folgenummer aus dem @em SEQUENCE-Record.
+     * @return @em true  Der Frame ist der nächste erwartete und wird verarbeitet.\n
+     *         @em false Doppelter oder zu früher Frame; er wird verworfen.
+     */
+    bool acceptSequence(uint8_t seq);
+
+
+    /**
+     * @brief Falls die Bestätigung überfällig ist, die unbestätigten Ereignisse erneut in die
+     *        Sendewarteschlange stellen.
+     * @note Diese Methode muss einmal je loop() aufgerufen werden.
+     *
+     * @param now Aktuelle Zeit in Millisekunden.
+     */
+    void update(unsigned long now);
+
+
+    /**
+     * @brief Eine anstehende Bestätigung an den PC abholen.
+     *
+     * @param seq Rückgabe der zu bestätigenden Folgenummer.
+     * @return @em true falls eine Bestätigung zu senden ist.
+     */
+    bool takeAck(uint8_t &seq);
+
+
+    inline bool isAckPending() const { return ackPending; }                 ///< Bestätigung an den PC steht an
+    inline unsigned long getRetransmits() const { return retransmits; }     ///< Anzahl wiederholter Ereignisse
+    inline unsigned long getDuplicates() const { return duplicates; }       ///< Anzahl verworfener Frames vom PC
+
+private:
+    TxMessage window[LINK_WINDOW_SIZE];     ///< Unbestätigte Schalterereignisse, Index = Folgenummer
+    uint8_t base = 0;                       ///< Älteste unbestätigte Folgenummer
+    uint8_t nextSeq = 0;                    ///< Nächste zu vergebende Folgenummer
+    uint8_t resendSeq = 0;                  ///< Nächste erneut zu sendende Folgenummer
+    bool resending = false;                 ///< Wiederholung läuft
+    unsigned long timerStart = 0;           ///< Beginn der Wartezeit auf die Bestätigung
+    uint8_t rxExpected = 0;                 ///< Nächste erwartete Folgenummer vom PC
+    bool ackPending = false;                ///< Bestätigung an den PC steht an
+    unsigned long retransmits = 0;          ///< Anzahl wiederholter Ereignisse
+    unsigned long duplicates = 0;           ///< Anzahl verworfener Frames vom PC
+};
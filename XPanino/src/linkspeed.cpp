@@ -0,0 +1,132 @@
+/*********************************************************************************************************//**
+ * @file linkspeed.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Implementierung der Klasse @em LinkSpeedClass.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#include <linkspeed.hpp>
+#include <parser.hpp>
+#include <protocol.hpp>
+#include <txqueue.hpp>
+
+extern ParserClass parser;
+extern ProtocolClass protocol;
+extern TxQueueClass txQueue;
+
+
+/*********************************************************************************************************//**
+ * LinkSpeedClass - public Methoden
+ *
+ ************************************************************************************************************/
+
+void LinkSpeedClass::begin() {
+    Serial.begin(SERIAL_DEFAULT_BAUDRATE, SERIAL_8N1);
+    baudRate = SERIAL_DEFAULT_BAUDRATE;
+}
+
+
+void LinkSpeedClass::requestSpeed(const uint16_t kbaud, const unsigned long) {
+    bool isSupported = false;
+    for (auto speed : LINK_SPEEDS_KBAUD) {
+        isSupported = isSupported || (speed == kbaud);
+    }
+    if (! isSupported) {
+        txQueue.addReply(TxReply::BAUD_FAIL);   // im Binärprotokoll wird nichts gesendet
+        return;
+    }
+    if (protocol.isBinary() || switching || verifying) {
+        return;
+    }
+    // Bestätigung noch mit der alten Baudrate; umgeschaltet wird in update(), sobald sie gesendet ist.
+    if (txQueue.addReply(TxReply::BAUD, kbaud)) {
+        pendingBaudRate = kbaud * 1000UL;
+    }
+}
+
+
+void LinkSpeedClass::onReplySent() {
+    switching = (pendingBaudRate != 0);
+}
+
+
+void LinkSpeedClass::verifyPattern(const char *pattern) {
+    if (! verifying) {
+        return;
+    }
+    if (strcmp(pattern, LINK_SPEED_TEST_PATTERN) != 0) {
+        fallback();
+        return;
+    }
+    verifying = false;
+    txQueue.addReply(TxReply::BAUD_OK);
+}
+
+
+void LinkSpeedClass::update(const unsigned long now) {
+    if (switching) {
+        if (Serial.availableForWrite() < SERIAL_TX_BUFFER_SIZE - 1) {
+            return;     // die Bestätigung ist noch nicht vollständig gesendet
+        }
+        switching = false;
+        setBaudRate(pendingBaudRate);
+        pendingBaudRate = 0;
+        verifying = true;
+        verifyStart = now;
+        rxErrorsAtStart = getRxErrors();
+        txQueue.addReply(TxReply::TEST);
+        return;
+    }
+    if (! verifying) {
+        return;
+    }
+    if ((now - verifyStart >= LINK_SPEED_VERIFY_TIMEOUT) || (getRxErrors() != rxErrorsAtStart)) {
+        fallback();
+    }
+}
+
+
+/*********************************************************************************************************//**
+ * ab hier die privaten Methoden
+*************************************************************************************************************/
+
+/**
+ * @brief Die serielle Schnittstelle auf eine neue Baudrate umschalten.
+ *
+ * Noch nicht gesendete Zeichen werden vorher gesendet, halb empfangene Zeichen verworfen.
+ *
+ * @param newBaudRate Die neue Baudrate.
+ */
+void LinkSpeedClass::setBaudRate(const unsigned long newBaudRate) {
+    Serial.flush();
+    Serial.end();
+    Serial.begin(newBaudRate, SERIAL_8N1);
+    while (Serial.available() > 0) {
+        Serial.read();
+    }
+    baudRate = newBaudRate;
+}
+
+
+/**
+ * @brief Die Prüfung ist fehlgeschlagen: zurück auf die Standard-Baudrate und dort melden.
+ */
+void LinkSpeedClass::fallback() {
+    verifying = false;
+    fallbacks++;
+    setBaudRate(SERIAL_DEFAULT_BAUDRATE);
+    txQueue.addReply(TxReply::BAUD_FAIL);
+}
+
+
+/**
+ * @brief Summe der bisherigen Empfangsfehler im Klartextprotokoll: verworfene Zeilen und
+ * ungültige Zeichen, wie sie bei einer nicht passenden Baudrate entstehen.
+ */
+unsigned long LinkSpeedClass::getRxErrors() {
+    return parser.getLineErrors() + parser.getInvalidChars();
+}
@@ -0,0 +1,101 @@
+/*********************************************************************************************************//**
+ * @file linkspeed.hpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Interface der Klasse @em LinkSpeedClass: Aushandeln einer höheren Baudrate mit dem PC.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+
+const unsigned long SERIAL_DEFAULT_BAUDRATE = 115200;   ///< Baudrate nach dem Start und beim Rückfall. Nur hier ändern!!
+const uint16_t LINK_SPEED_VERIFY_TIMEOUT = 1000;        ///< Zeit in ms, in der der PC das Testmuster senden muss
+const char LINK_SPEED_TEST_PATTERN[] = "U*U*U*";        ///< Testmuster: 'U' = 0x55 und '*' = 0x2A mit wechselnden Bits
+
+/// Baudraten in kBaud, die der 16-MHz-UART (mit U2X) ohne Abweichung erzeugen kann.
+const uint16_t LINK_SPEEDS_KBAUD[] = {250, 500, 1000};
+
+
+/*********************************************************************************************************//**
+ * @brief Aushandeln einer höheren Baudrate mit dem PC im Klartextprotokoll.
+ *
+ * Ablauf:
+ * 1. PC: `CTRL;BAUD;<kBaud>` (250, 500 oder 1000) mit der aktuellen Baudrate.
+ * 2. Arduino: Bestätigung `CTRL;BAUD;<kBaud>` noch mit der alten Baudrate über die Sendewarteschlange.
+ *    Sobald sie vollständig gesendet ist, Umschalten und Senden des Testmusters `CTRL;TEST;U*U*U*` mit der
+ *    neuen Baudrate. Bis dahin hält die Sendewarteschlange an; der loop() wartet dabei nicht.
+ * 3. PC: prüft das Testmuster und sendet es als `CTRL;TEST;U*U*U*` mit der neuen Baudrate zurück.
+ * 4. Arduino: `CTRL;BAUD;OK` -- die neue Baudrate gilt.
+ *
+ * Kommt das Testmuster nicht innerhalb von @em LINK_SPEED_VERIFY_TIMEOUT richtig an oder treten dabei
+ * Empfangsfehler auf, schaltet der Arduino auf @em SERIAL_DEFAULT_BAUDRATE zurück und meldet dort
+ * `CTRL;BAUD;FAIL`. Der PC muss dann ebenfalls zurückschalten.
+ *
+ ************************************************************************************************************/
+class LinkSpeedClass {
+public:
+    /**
+     * @brief Die serielle Schnittstelle mit der Standard-Baudrate starten.
+     */
+    void begin();
+
+
+    /**
+     * @brief Umschalten auf die vom PC gewünschte Baudrate und Prüfung beginnen.
+     *
+     * Im Binärprotokoll und während einer laufenden Umschaltung wird die Anfrage ignoriert.
+     *
+     * @param kbaud Gewünschte Baudrate in kBaud; unbekannte Werte werden mit `CTRL;BAUD;FAIL` abgelehnt.
+     * @param now Aktuelle Zeit in Millisekunden.
+     */
+    void requestSpeed(uint16_t kbaud, unsigned long now);
+
+
+    /**
+     * @brief Von der Sendewarteschlange aufgerufen, sobald die Bestätigung `CTRL;BAUD;<kBaud>` an die
+     *        serielle Schnittstelle übergeben ist. Danach wird auf das Leeren des Sendepuffers gewartet.
+     */
+    void onReplySent();
+
+
+    /**
+     * @brief Das vom PC zurückgesendete Testmuster prüfen.
+     *
+     * @param pattern Das empfangene Testmuster.
+     */
+    void verifyPattern(const char *pattern);
+
+
+    /**
+     * @brief Nach der Bestätigung die Baudrate umschalten und während der Prüfung auf Zeitüberschreitung
+     *        und Empfangsfehler achten.
+     * @note Diese Methode muss einmal je loop() aufgerufen werden.
+     *
+     * @param now Aktuelle Zeit in Millisekunden.
+     */
+    void update(unsigned long now);
+
+
+    inline unsigned long getBaudRate() const { return baudRate; }       ///< Aktuelle Baudrate
+    inline bool isVerifying() const { return verifying; }               ///< Prüfung der neuen Baudrate läuft
+    inline bool isSwitching() const { return switching; }               ///< Warten auf das Umschalten der Baudrate
+    inline uint16_t getFallbacks() const { return fallbacks; }          ///< Anzahl der Rückfälle auf die Standard-Baudrate
+
+private:
+    unsigned long baudRate = SERIAL_DEFAULT_BAUDRATE;   ///< Aktuelle Baudrate
+    bool verifying = false;                 ///< Prüfung der neuen Baudrate läuft
+    bool switching = false;                 ///< Bestätigung ist übergeben; Umschalten, sobald sie gesendet ist
+    unsigned long pendingBaudRate = 0;      ///< Angeforderte Baudrate; 0 = keine
+    unsigned long verifyStart = 0;          ///< Beginn der Prüfung
+    unsigned long rxErrorsAtStart = 0;      ///< Stand der Empfangsfehler zu Beginn der Prüfung
+    uint16_t fallbacks = 0;                 ///< Anzahl der Rückfälle
+
+    void setBaudRate(unsigned long newBaudRate);
+    void fallback();
+    static unsigned long getRxErrors();
+};
@@ -0,0 +1,35 @@
+/*********************************************************************************************************//**
+ * @file logdict.hpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Wörterbuch der Log-Meldungen: ID, Log-Level und Text.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#pragma once
+
+/*********************************************************************************************************//**
+ * @brief Alle Log-Meldungen als X-Makro: X(Name, Log-Level, Text).
+ *
+ * Auf dem Arduino werden nur die ID (= Position in dieser Liste) und zwei Argumente übertragen; die Texte
+ * kommen nicht in den Flash. Das Programm tools/logdecode.py liest diese Datei und setzt die Texte wieder
+ * ein; {0} und {1} stehen dort für die beiden Argumente.
+ *
+ * @note Neue Meldungen nur am Ende anhängen, damit alte Mitschnitte lesbar bleiben.
+ *
+ ************************************************************************************************************/
+#define LOG_MESSAGES(X) \
+    X(SETUP_DONE,        LOG_LEVEL_INFO,  "Setup abgeschlossen, Schaltermatrix {0} x {1}") \
+    X(EVENT_QUEUED,      LOG_LEVEL_DEBUG, "Event eingereiht: Device {0}, Event {1}") \
+    X(EVENT_DROPPED,     LOG_LEVEL_WARN,  "Eventqueue voll, Event verworfen: Device {0}, Event {1}") \
+    X(DISPATCH_EVENT,    LOG_LEVEL_DEBUG, "Dispatch: Device {0}, Event {1}") \
+    X(DEVICE_EVENT,      LOG_LEVEL_DEBUG, "Device ohne eigene Verarbeitung: Device {0}, Event {1}") \
+    X(DEVICE_NULL_EVENT, LOG_LEVEL_ERROR, "Device: nullptr statt Event") \
+    X(FRAME_ERROR,       LOG_LEVEL_WARN,  "Frame verworfen (COBS/CRC), Fehler gesamt {0}") \
+    X(LINK_UP,           LOG_LEVEL_INFO,  "Verbindung zum PC hergestellt ({0}. Mal)") \
+    X(LINK_DOWN,         LOG_LEVEL_WARN,  "Verbindung zum PC getrennt nach {0} ms ohne Lebenszeichen") \
+    X(XPDR_MODE,         LOG_LEVEL_INFO,  "Transponder: Betriebsmodus {0} (0=OFF, 1=SBY, 2=TST, 3=ON, 4=ALT)") \
+    X(XPDR_VFR_PROGRAMMED, LOG_LEVEL_INFO, "Transponder: VFR-Code {0} programmiert")
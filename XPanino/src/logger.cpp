@@ -0,0 +1,36 @@
+/*********************************************************************************************************//**
+ * @file logger.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Implementierung der Klasse @em LoggerClass.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#include <logger.hpp>
+#include <txqueue.hpp>
+
+extern TxQueueClass txQueue;
+
+/// Log-Meldungen belegen höchstens die Hälfte der Sendewarteschlange.
+const uint8_t LOG_TX_QUEUE_LIMIT = TX_QUEUE_SIZE / 2;
+
+
+/*********************************************************************************************************//**
+ * LoggerClass - public Methoden
+ *
+ ************************************************************************************************************/
+
+void LoggerClass::write(const LogId id, const uint8_t messageLevel, const uint16_t arg0, const uint16_t arg1) {
+    if (messageLevel > level) {
+        return;
+    }
+    if (txQueue.getCount() >= LOG_TX_QUEUE_LIMIT) {
+        dropped++;
+        return;
+    }
+    txQueue.addMessage({TxMessageType::LOG, static_cast<uint8_t>(id), 0, 0, 0,
+                        (static_cast<uint32_t>(arg0) << 16) | arg1});
+}
@@ -0,0 +1,104 @@
+/*********************************************************************************************************//**
+ * @file logger.hpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Interface der Klasse @em LoggerClass: kompakte Log-Meldungen als ID und binäre Argumente.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+
+const uint8_t LOG_LEVEL_OFF = 0;    ///< Keine Log-Meldungen
+const uint8_t LOG_LEVEL_ERROR = 1;  ///< Fehler
+const uint8_t LOG_LEVEL_WARN = 2;   ///< Warnungen
+const uint8_t LOG_LEVEL_INFO = 3;   ///< Informationen
+const uint8_t LOG_LEVEL_DEBUG = 4;  ///< Meldungen zum Debuggen
+
+/// Bis zu diesem Log-Level werden Meldungen überhaupt compiliert; im Release ohne @em DEBUG keine.
+/// Kann mit z.B. -DLOG_COMPILE_LEVEL=2 in platformio.ini überschrieben werden.
+#ifndef LOG_COMPILE_LEVEL
+    #ifdef DEBUG
+        #define LOG_COMPILE_LEVEL 4
+    #else
+        #define LOG_COMPILE_LEVEL 0
+    #endif
+#endif
+
+#include <logdict.hpp>
+
+/// IDs der Log-Meldungen in der Reihenfolge von @em LOG_MESSAGES.
+enum class LogId : uint8_t {
+    #define LOG_ID(name, level, text) name,
+    LOG_MESSAGES(LOG_ID)
+    #undef LOG_ID
+    COUNT
+};
+
+/// Log-Level je Meldung als Konstante LOG_LEVEL_OF_<Name>, damit LOG() schon beim Compilieren filtert.
+#define LOG_LEVEL_CONST(name, level, text) const uint8_t LOG_LEVEL_OF_##name = level;
+LOG_MESSAGES(LOG_LEVEL_CONST)
+#undef LOG_LEVEL_CONST
+
+
+/**
+ * @brief Eine Log-Meldung aus logdict.hpp mit zwei Argumenten (je uint16_t) senden.
+ *
+ * Liegt das Log-Level der Meldung über @em LOG_COMPILE_LEVEL, entfällt der Aufruf samt Argumenten
+ * vollständig. Beispiel: `LOG(EVENT_DROPPED, deviceId, eventId);`
+ */
+#define LOG(name, arg0, arg1) \
+    do { \
+        if ((LOG_LEVEL_OF_##name != LOG_LEVEL_OFF) && (LOG_LEVEL_OF_##name <= LOG_COMPILE_LEVEL)) { \
+            logger.write(LogId::name, LOG_LEVEL_OF_##name, static_cast<uint16_t>(arg0), \
+                         static_cast<uint16_t>(arg1)); \
+        } \
+    } while (false)
+
+
+/*********************************************************************************************************//**
+ * @brief Kompakte Log-Meldungen an den PC.
+ *
+ * Statt Texten werden nur die ID der Meldung und zwei Argumente über die Sendewarteschlange gesendet:
+ * im Binärprotokoll als Record @em LOG_MESSAGE (5 Bytes Nutzdaten), im Klartextprotokoll als
+ * `L;<ID>;<Arg0 hex>;<Arg1 hex>`. tools/logdecode.py macht daraus mit logdict.hpp wieder Text.
+ *
+ * Zusätzlich zum Filter beim Compilieren lässt sich das Log-Level zur Laufzeit mit `CTRL;LOG;<Level>`
+ * einstellen. Log-Meldungen belegen höchstens die Hälfte der Sendewarteschlange, der Rest bleibt für
+ * Schalterereignisse frei; was nicht passt, wird verworfen und gezählt.
+ *
+ ************************************************************************************************************/
+class LoggerClass {
+public:
+    /**
+     * @brief Eine Log-Meldung senden, falls ihr Log-Level zur Laufzeit eingeschaltet ist.
+     * @note Nicht direkt aufrufen, sondern über das Makro LOG().
+     *
+     * @param id ID der Meldung.
+     * @param level Log-Level der Meldung.
+     * @param arg0 1. Argument.
+     * @param arg1 2. Argument.
+     */
+    void write(LogId id, uint8_t level, uint16_t arg0, uint16_t arg1);
+
+
+    /**
+     * @brief Das Log-Level zur Laufzeit einstellen.
+     *
+     * @param newLevel LOG_LEVEL_OFF bis LOG_LEVEL_DEBUG; größere Werte werden auf LOG_LEVEL_DEBUG begrenzt.
+     */
+    inline void setLevel(const uint8_t newLevel) { level = min(newLevel, LOG_LEVEL_DEBUG); }
+
+    inline uint8_t getLevel() const { return level; }                   ///< Aktuelles Log-Level
+    inline uint16_t getDropped() const { return dropped; }              ///< Anzahl verworfener Meldungen
+
+private:
+    uint8_t level = LOG_COMPILE_LEVEL;  ///< Log-Level zur Laufzeit
+    uint16_t dropped = 0;               ///< Anzahl verworfener Meldungen
+};
+
+extern LoggerClass logger;
@@ -0,0 +1,103 @@
+/*********************************************************************************************************//**
+ * @file looptiming.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Implementierung der Klasse @em LoopTimingClass.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#include <looptiming.hpp>
+#include <txqueue.hpp>
+
+extern TxQueueClass txQueue;
+
+
+/*********************************************************************************************************//**
+ * LoopTimingClass - public Methoden
+ *
+ ************************************************************************************************************/
+
+LoopTimingClass::LoopTimingClass() {
+    for (uint8_t stage = 0; stage < LOOP_STAGE_COUNT; ++stage) {
+        stats[stage].budget = 0;
+    }
+    reset();
+}
+
+
+void LoopTimingClass::setBudget(const LoopStage stage, const uint16_t budgetUs) {
+    if (stage < LoopStage::COUNT) {
+        stats[static_cast<uint8_t>(stage)].budget = budgetUs;
+    }
+}
+
+
+void LoopTimingClass::reset() {
+    for (uint8_t stage = 0; stage < LOOP_STAGE_COUNT; ++stage) {
+        LoopStageStats &entry = stats[stage];
+        entry.min = 0xFFFF;
+        entry.max = 0;
+        entry.sum = 0;
+        entry.count = 0;
+        entry.overruns = 0;
+        memset(entry.histogram, 0, sizeof(entry.histogram));
+    }
+}
+
+
+void LoopTimingClass::requestReport() {
+    reportRemaining = LOOP_STAGE_COUNT;
+}
+
+
+void LoopTimingClass::transmit() {
+    // Je Abschnitt zwei Nachrichten: die Werte und (nur im Klartextprotokoll als eigene Zeile) das Histogramm
+    while ((reportRemaining > 0) && (txQueue.getCount() + 1 < TX_REPORT_LIMIT)) {
+        const uint8_t stage = LOOP_STAGE_COUNT - reportRemaining;
+        txQueue.addMessage({TxMessageType::LOOP_STATS, stage, 0, 0, 0, 0});
+        txQueue.addMessage({TxMessageType::LOOP_HISTOGRAM, stage, 0, 0, 0, 0});
+        reportRemaining--;
+    }
+}
+
+
+uint16_t LoopTimingClass::getMinimum(const LoopStage stage) const {
+    const LoopStageStats &entry = getStats(stage);
+    return (entry.count > 0) ? entry.min : 0;
+}
+
+
+uint16_t LoopTimingClass::getAverage(const LoopStage stage) const {
+    const LoopStageStats &entry = getStats(stage);
+    return (entry.count > 0) ? static_cast<uint16_t>(entry.sum / entry.count) : 0;
+}
+
+
+void LoopTimingClass::addSample(const LoopStage stage, const unsigned long elapsed) {
+    LoopStageStats &entry = stats[static_cast<uint8_t>(stage)];
+    const uint16_t sample = static_cast<uint16_t>(min(elapsed, 0xFFFFUL));
+    entry.min = min(entry.min, sample);
+    entry.max = max(entry.max, sample);
+    if (entry.count == 0xFFFF) {
+        // Summe und Anzahl halbieren: der Mittelwert bleibt erhalten und folgt weiterhin neuen Messungen.
+        entry.sum /= 2;
+        entry.count /= 2;
+    }
+    entry.sum += sample;
+    entry.count++;
+    if ((entry.budget != 0) && (sample > entry.budget) && (entry.overruns < 0xFFFF)) {
+        entry.overruns++;
+    }
+    uint8_t bucket = 0;
+    uint16_t rest = sample >> LOOP_HISTOGRAM_SHIFT;
+    while ((rest != 0) && (bucket < LOOP_HISTOGRAM_BUCKETS - 1)) {
+        rest >>= 1;
+        bucket++;
+    }
+    if (entry.histogram[bucket] < 0xFFFF) {    // die Klassen bleiben beim Höchstwert stehen
+        entry.histogram[bucket]++;
+    }
+}
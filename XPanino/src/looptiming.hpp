@@ -0,0 +1,137 @@
+/*********************************************************************************************************//**
+ * @file looptiming.hpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Interface der Klasse @em LoopTimingClass: Laufzeiten der einzelnen Abschnitte des loop().
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+
+const uint8_t LOOP_HISTOGRAM_BUCKETS = 8;   ///< Anzahl Klassen des Histogramms
+const uint8_t LOOP_STATS_LENGTH = 11 + 2 * LOOP_HISTOGRAM_BUCKETS;  ///< Nutzdaten des Records LOOP_STATS in Bytes
+const uint8_t LOOP_HISTOGRAM_SHIFT = 6;     ///< Obergrenze der 1. Klasse: 2^6 = 64 µs; jede weitere Klasse verdoppelt
+
+
+/*********************************************************************************************************//**
+ * @brief Die gemessenen Abschnitte des loop(). Die Nummern werden mit übertragen; bei Änderungen die
+ *        Dokumentation (kommunikation.md) anpassen.
+ *
+ ************************************************************************************************************/
+enum class LoopStage : uint8_t {
+    SCAN,       ///< Abfrage der Schaltermatrix und Verarbeitung der Schalterereignisse
+    TX,         ///< Gesicherte Übertragung, Baudrate, Verbindung, Zustandsabgleich und Senden
+    DISPATCH,   ///< Abarbeitung der Eventqueue
+    SHOW,       ///< Anzeige der Geräte (devices.show())
+    REFRESH,    ///< Refresh der LED-Matrix (writeToHardware())
+    LOOP,       ///< Der ganze loop()-Durchlauf
+    COUNT       ///< Anzahl Abschnitte
+};
+
+const uint8_t LOOP_STAGE_COUNT = static_cast<uint8_t>(LoopStage::COUNT);     ///< Anzahl Abschnitte
+
+
+/*********************************************************************************************************//**
+ * @brief Statistik eines Abschnitts. Alle Zeiten in µs.
+ *
+ ************************************************************************************************************/
+class LoopStageStats {
+public:
+    uint16_t min;                   ///< Kürzeste Laufzeit
+    uint16_t max;                   ///< Längste Laufzeit
+    uint32_t sum;                   ///< Summe der Laufzeiten für den Mittelwert
+    uint16_t count;                 ///< Anzahl Messungen
+    uint16_t budget;                ///< Erlaubte Laufzeit; 0 = keine Vorgabe
+    uint16_t overruns;              ///< Anzahl Messungen über dem Budget
+    uint16_t histogram[LOOP_HISTOGRAM_BUCKETS];     ///< Anzahl Messungen je Klasse: < 64, < 128, ... µs, die letzte ab 4096 µs
+};
+
+
+/*********************************************************************************************************//**
+ * @brief Laufzeiten der einzelnen Abschnitte des loop(): Minimum, Mittelwert, Maximum, Histogramm und
+ *        Überschreitungen eines einstellbaren Budgets.
+ *
+ * Die Laufzeiten der Abschnitte liefert die Ablaufsteuerung (SchedulerClass) je Ausführung einer Aufgabe
+ * mit addSample(); startLoop() und endLoop() messen den ganzen Durchlauf. Gemessen wird mit micros(),
+ * d.h. mit einer Auflösung von 4 µs; Laufzeiten über 65 ms werden auf 65535 µs begrenzt.
+ *
+ * Die Statistik wird mit `CTRL;PERF` an den PC gesendet, mit `CTRL;PERF;R` zurückgesetzt. Das Budget eines
+ * Abschnitts wird mit `CTRL;PERF;<Abschnitt>;<µs>` eingestellt.
+ *
+ ************************************************************************************************************/
+class LoopTimingClass {
+public:
+    LoopTimingClass();
+
+
+    /**
+     * @brief Beginn eines loop()-Durchlaufs.
+     */
+    inline void startLoop() { loopStart = micros(); }
+
+
+    /**
+     * @brief Ende des loop()-Durchlaufs: die Zeit seit startLoop() erfassen.
+     */
+    inline void endLoop() { addSample(LoopStage::LOOP, micros() - loopStart); }
+
+
+    /**
+     * @brief Eine Laufzeit in die Statistik eines Abschnitts übernehmen.
+     *
+     * @param stage Der Abschnitt.
+     * @param elapsed Laufzeit in µs.
+     */
+    void addSample(LoopStage stage, unsigned long elapsed);
+
+
+    /**
+     * @brief Das Budget eines Abschnitts einstellen.
+     *
+     * @param stage Der Abschnitt.
+     * @param budgetUs Erlaubte Laufzeit in µs; 0 = keine Vorgabe.
+     */
+    void setBudget(LoopStage stage, uint16_t budgetUs);
+
+
+    /**
+     * @brief Alle Messwerte löschen; die Budgets bleiben erhalten.
+     */
+    void reset();
+
+
+    /**
+     * @brief Die Statistik aller Abschnitte an den PC senden: im Klartextprotokoll je Abschnitt die Zeilen
+     *        `P;<Abschnitt>;<Min>;<Mittel>;<Max>;<Budget>;<Überschreitungen>` und `H;<Abschnitt>;<Histogramm>`,
+     *        im Binärprotokoll je Abschnitt ein Record @em LOOP_STATS. Gesendet wird verteilt über mehrere
+     *        Aufrufe von transmit().
+     */
+    void requestReport();
+
+
+    /**
+     * @brief Anstehende Abschnitte der Statistik in die Sendewarteschlange stellen; dabei bleiben mind.
+     *        @em TX_QUEUE_SIZE - @em TX_REPORT_LIMIT Plätze frei.
+     * @note Diese Methode muss einmal je loop() aufgerufen werden.
+     */
+    void transmit();
+
+
+    uint16_t getMinimum(LoopStage stage) const;     ///< Kürzeste Laufzeit eines Abschnitts; 0 ohne Messung
+    uint16_t getAverage(LoopStage stage) const;     ///< Mittlere Laufzeit eines Abschnitts; 0 ohne Messung
+
+
+    inline const LoopStageStats &getStats(const LoopStage stage) const {  ///< Statistik eines Abschnitts
+        return stats[static_cast<uint8_t>(stage)];
+    }
+
+private:
+    LoopStageStats stats[LOOP_STAGE_COUNT];     ///< Statistik je Abschnitt
+    unsigned long loopStart = 0;    ///< Beginn des loop()-Durchlaufs in µs
+    uint8_t reportRemaining = 0;    ///< Anzahl der noch zu sendenden Abschnitte
+};
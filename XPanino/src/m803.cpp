@@ -9,18 +9,11 @@
  ************************************************************************************************************/
 
 #include <device.hpp>
+#include <frameclock.hpp>
 #include <m803.hpp>
 
 extern LedMatrix leds;
 
-// Konstanten der möglichen Event-Strings
-const uint8_t NO_OF_EVENT_STRINGS = 6;
-const String eventStrings[NO_OF_EVENT_STRINGS] = {
-    "S;S",
-    "BTN_SEL ON", "BTN_SEL OFF",
-    "BTN_CTL ON", "BTN_CTL LON", "BTN_CTL OFF"
-};
-
 /**************************************************************************************************
  * ClockDavtronM803 - public Methoden
  *
@@ -38,6 +31,8 @@ ClockDavtronM803::ClockDavtronM803() {
     elapsedTime = 0;        ///< Die elapsed time im Format 00HHMMSS
     temperatureC = 0;       ///< Die Temperatur in Grad Celsius  @todo checken wie's vom Flusi kommt
     altimeter = STD_ALTIMETER_inHg; ///< Luftdruck in inHg
+    linkUp = true;          ///< Flugsimulator ist online
+    lastSecond = 0;         ///< Die Uhrzeiten laufen ab dem Start mit der eigenen Zeitbasis
 
     ///< Define the upper display and show a default value.
     upperDisplay = 0;   ///< Das Display-Feld upperDisplay definieren. Es besteht aus 4 7-Segment-Anzeigen:
@@ -94,9 +89,52 @@ OatVoltsModeState ClockDavtronM803::toggleOatVoltsMode() {
 };
 
 
+void ClockDavtronM803::processEvent(EventClass *event) {
+    uint32_t time = 0;
+    switch (event->eventId) {
+        case TokenId::EV_LT: {
+            if (parseTime(event->parameter1, time)) {
+                setLocalTime(time, frameClock.getNow());
+            }
+            break;
+        }
+        case TokenId::EV_UT: {
+            if (parseTime(event->parameter1, time)) {
+                setUtc(time, frameClock.getNow());
+            }
+            break;
+        }
+        case TokenId::EV_TIME: {
+            if (parseTime(event->parameter1, time)) {
+                setLocalTime(time, frameClock.getNow());
+            }
+            if (parseTime(event->parameter2, time)) {
+                setUtc(time, frameClock.getNow());
+            }
+            break;
+        }
+        default: Device::processEvent(event);
+    }
+}
+
+
 void ClockDavtronM803::setTimeMode(ClockModeState &timeMode) { this->clockMode = timeMode; };
-void ClockDavtronM803::setLocalTime(uint32_t &localTime) { this->localTime = localTime; };
-void ClockDavtronM803::setUtc(uint32_t &utc) { this->utc = utc; };
+
+
+void ClockDavtronM803::setLocalTime(const uint32_t localTime, const unsigned long now) {
+    this->localTime = localTime;
+    lastSecond = now;
+    isClockModeChanged = true;
+}
+
+
+void ClockDavtronM803::setUtc(const uint32_t utc, const unsigned long now) {
+    this->utc = utc;
+    lastSecond = now;
+    isClockModeChanged = true;
+}
+
+
 void ClockDavtronM803::setFlightTime(uint32_t &flightTime) { this->flightTime = flightTime; };
 void ClockDavtronM803::setElapsedTime(uint32_t &elapsedTime) { this->elapsedTime = elapsedTime; };
 void ClockDavtronM803::setOatVoltsMode(OatVoltsModeState &oatVoltsMode) {this->oatVoltsMode = oatVoltsMode; };
@@ -104,7 +142,54 @@ void ClockDavtronM803::setTemperature(int8_t &temperatureC) { this->temperatureC
 void ClockDavtronM803::setAltimeter(float &altimeter) { this->altimeter = altimeter; };
 
 
+uint16_t ClockDavtronM803::getModes() const {
+    return (static_cast<uint16_t>(clockMode) << 8) | static_cast<uint8_t>(oatVoltsMode);
+}
+
+
+void ClockDavtronM803::setModes(const uint16_t modes) {
+    const uint8_t newClockMode = static_cast<uint8_t>(modes >> 8);
+    const uint8_t newOatVoltsMode = static_cast<uint8_t>(modes);
+    if (newClockMode <= static_cast<uint8_t>(ClockModeState::SET_ET)) {
+        clockMode = static_cast<ClockModeState>(newClockMode);
+        isClockModeChanged = true;
+    }
+    if (newOatVoltsMode <= static_cast<uint8_t>(OatVoltsModeState::ALT)) {
+        oatVoltsMode = static_cast<OatVoltsModeState>(newOatVoltsMode);
+        isOatVoltsModeChanged = true;
+    }
+}
+
+
+void ClockDavtronM803::redraw() {
+    isOatVoltsModeChanged = true;
+    isClockModeChanged = true;
+}
+
+
+void ClockDavtronM803::setLinkUp(const bool isUp) {
+    linkUp = isUp;
+    redraw();
+}
+
+
+void ClockDavtronM803::tick(const unsigned long now) {
+    while (now - lastSecond >= 1000) {
+        lastSecond += 1000;
+        localTime = nextSecond(localTime);
+        utc = nextSecond(utc);
+        if ((localTime % 100) == 0) {
+            isClockModeChanged = true;  // neue Minute: die Anzeige HHMM aktualisieren
+        }
+    }
+}
+
+
 void ClockDavtronM803::show() {
+    if (isOatVoltsModeChanged && ! linkUp) {
+        leds.display(upperDisplay, "noFS");     // kein Flugsimulator online
+        isOatVoltsModeChanged = false;
+    }
     if (isOatVoltsModeChanged) {
         switch (oatVoltsMode) {
             case OatVoltsModeState::EMF        : {
@@ -137,7 +222,9 @@ void ClockDavtronM803::show() {
     if (isClockModeChanged) {
         switch (clockMode) {
             case ClockModeState::LT : {
-                        leds.display(lowerDisplay, (static_cast<String>(localTime)).substring(0, 4));
+                        char timeText[5];      // HHMM mit führender Null; "% 10000" zeigt dem Compiler, dass 4 Stellen reichen
+                        snprintf(timeText, sizeof(timeText), "%04lu", static_cast<unsigned long>((localTime / 100) % 10000));
+                        leds.display(lowerDisplay, timeText);
                         leds.ledOn(LED_LT);
                         leds.ledOn(LED_TRENNER_1);
                         leds.ledBlinkOn(LED_TRENNER_1, BLINK_NORMAL);
@@ -146,7 +233,9 @@ void ClockDavtronM803::show() {
                         break;
             }
             case ClockModeState::UT : {
-                        leds.display(lowerDisplay, (static_cast<String>(utc)).substring(0, 4));
+                        char timeText[5];      // HHMM mit führender Null; "% 10000" zeigt dem Compiler, dass 4 Stellen reichen
+                        snprintf(timeText, sizeof(timeText), "%04lu", static_cast<unsigned long>((utc / 100) % 10000));
+                        leds.display(lowerDisplay, timeText);
                         leds.ledOff(LED_LT);
                         leds.ledOn(LED_UT);
                         leds.ledOn(LED_TRENNER_1);
@@ -195,6 +284,52 @@ char* ClockDavtronM803::getLocalTimeDigits() {
 };
 
 
+/**
+ * @brief Eine Uhrzeit im Format 00HHMMSS um eine Sekunde weiterstellen; nach 23:59:59 kommt 00:00:00.
+ */
+uint32_t ClockDavtronM803::nextSecond(const uint32_t hhmmss) {
+    uint32_t hours = hhmmss / 10000;
+    uint32_t minutes = (hhmmss / 100) % 100;
+    uint32_t seconds = hhmmss % 100 + 1;
+    if (seconds == 60) {
+        seconds = 0;
+        minutes++;
+    }
+    if (minutes == 60) {
+        minutes = 0;
+        hours++;
+    }
+    if (hours == 24) {
+        hours = 0;
+    }
+    return hours * 10000 + minutes * 100 + seconds;
+}
+
+
+/**
+ * @brief Eine Uhrzeit HHMMSS (genau 6 Ziffern) in das Format 00HHMMSS umwandeln.
+ *
+ * @param text Die Uhrzeit als String.
+ * @param hhmmss Rückgabe der Uhrzeit.
+ * @return @em true falls die Uhrzeit gültig ist (höchstens 23:59:59).
+ */
+bool ClockDavtronM803::parseTime(const char *text, uint32_t &hhmmss) {
+    uint32_t value = 0;
+    uint8_t digits = 0;
+    for (; text[digits] != '\0'; ++digits) {
+        if ((digits == 6) || (text[digits] < '0') || (text[digits] > '9')) {
+            return false;
+        }
+        value = value * 10 + (text[digits] - '0');
+    }
+    if ((digits != 6) || (value / 10000 > 23) || ((value / 100) % 100 > 59) || (value % 100 > 59)) {
+        return false;
+    }
+    hhmmss = value;
+    return true;
+}
+
+
 /** qnh
  * @brief Altimeter in Hg in QNH umrechnen.
  *
@@ -11,7 +11,7 @@
 #pragma once
 
 #include <Arduino.h>
-#include <buffer.hpp>
+#include <event.hpp>
 #include <device.hpp>
 #include <ledmatrix.hpp>
 #include <Switchmatrix.hpp>
@@ -86,6 +86,8 @@ enum class m803Event {
  */
 class ClockDavtronM803 : public Device {
 public:
+    static constexpr TokenId DEVICE_ID = TokenId::DEV_M803;    ///< ID für die Zuordnung der Events
+
     ClockDavtronM803();
 
     /**
@@ -104,9 +106,38 @@ public:
     OatVoltsModeState toggleOatVoltsMode();
 
 
+    /**
+     * @brief Uhrzeiten vom PC verarbeiten: @em LT und @em UT (HHMMSS in parameter1) sowie @em TIME (LT in
+     *        parameter1, UT in parameter2). Ungültige Uhrzeiten werden ignoriert; alle anderen Events
+     *        gehen an @em Device::processEvent().
+     *
+     * Ohne PC laufen die Uhrzeiten mit der eigenen Zeitbasis weiter (siehe @em tick()); die nächste
+     * Uhrzeit vom PC stellt sie wieder genau.
+     *
+     * @param event Das Event.
+     */
+    void processEvent(EventClass *event);
+
+
     void setTimeMode(ClockModeState &timeMode);
-    void setLocalTime(uint32_t &localTime);
-    void setUtc(uint32_t &utc);
+
+
+    /**
+     * @brief Die lokale Zeit setzen; die eigene Zeitbasis zählt ab @em now weiter.
+     *
+     * @param localTime Lokale Zeit im Format 00HHMMSS.
+     * @param now Zeitstempel des aktuellen Durchlaufs in ms (frameClock).
+     */
+    void setLocalTime(uint32_t localTime, unsigned long now);
+
+
+    /**
+     * @brief Die UTC setzen; die eigene Zeitbasis zählt ab @em now weiter.
+     *
+     * @param utc UTC im Format 00HHMMSS.
+     * @param now Zeitstempel des aktuellen Durchlaufs in ms (frameClock).
+     */
+    void setUtc(uint32_t utc, unsigned long now);
     void setFlightTime(uint32_t &flightTime);
     void setElapsedTime(uint32_t &elapsedTime);
     void setOatVoltsMode(OatVoltsModeState &OatVoltsMode);
@@ -115,6 +146,47 @@ public:
     void setAltimeter(float &altimeter);
 
 
+    /**
+     * @brief Die Modi beider Displays für den Zustandsabgleich mit dem PC lesen.
+     *
+     * @return uint16_t High-Byte: ClockModeState, Low-Byte: OatVoltsModeState.
+     */
+    uint16_t getModes() const;
+
+
+    /**
+     * @brief Die Modi beider Displays aus dem Zustandsabgleich mit dem PC setzen und neu anzeigen.
+     *
+     * @param modes Wie bei @em getModes(); ungültige Modi werden ignoriert.
+     */
+    void setModes(uint16_t modes);
+
+
+    /**
+     * @brief Beim nächsten @em show() beide Displays vollständig neu anzeigen.
+     */
+    void redraw();
+
+
+    /**
+     * @brief Verbindung zum Flugsimulator hergestellt bzw. getrennt.
+     *
+     * Ohne Flugsimulator zeigt das obere Display "noFS"; die Uhrzeit läuft mit der eigenen Zeitbasis weiter.
+     *
+     * @param isUp @em true = Flugsimulator online.
+     */
+    void setLinkUp(bool isUp);
+
+
+    /**
+     * @brief Die Uhrzeiten (LT und UT) mit der eigenen Zeitbasis weiterlaufen lassen.
+     * @note Diese Methode muss einmal je loop() vor @em show() aufgerufen werden.
+     *
+     * @param now Aktuelle Zeit in Millisekunden.
+     */
+    void tick(unsigned long now);
+
+
     /**
      * @brief Display the current values in upper and lower display.
      *
@@ -147,7 +219,12 @@ private:
     uint32_t elapsedTime;               ///< Die elapsed time im Format 00HHMMSS.
     int8_t temperatureC;                ///< Die Temperatur in Grad Celsius.
     float altimeter;                    ///< Luftdruck in inHg.
+    bool linkUp;                        ///< Flugsimulator ist online.
+    unsigned long lastSecond;           ///< Zeitpunkt (millis) der letzten weitergezählten Sekunde.
 
     /// Altimeter in QNH umrechnen
     inline float qnh();
+
+    static uint32_t nextSecond(uint32_t hhmmss);
+    static bool parseTime(const char *text, uint32_t &hhmmss);
 };
@@ -14,25 +14,54 @@
 
 // Headerdateien der Objekte includen
 #include <dispatcher.hpp>
+#include <devices.hpp>
 #include <Switchmatrix.hpp>
+#include <ledbatch.hpp>
 #include <ledmatrix.hpp>
-#include <buffer.hpp>
-#include <m803.hpp>
-#include <xpdr.hpp>
+#include <control.hpp>
+#include <diagnostics.hpp>
+#include <framebuffer.hpp>
+#include <frameclock.hpp>
+#include <heartbeat.hpp>
+#include <link.hpp>
+#include <linkspeed.hpp>
+#include <logger.hpp>
+#include <looptiming.hpp>
+#include <parser.hpp>
+#include <protocol.hpp>
+#include <scheduler.hpp>
+#include <statesync.hpp>
+#include <trace.hpp>
+#include <txqueue.hpp>
 //#include <commands.hpp>
 
-// Makros für serielle Schnittstelle definieren
-#define _SERIAL_BAUDRATE 115200     /// NOLINT Baudrate für den seriellen Port. Nur hier ändern!!
-
 // Objekte anlegen
 DispatcherClass dispatcher; ///< Dispatcher
-EventQueueClass eventQueue; ///< Event
-BufferClass inBuffer;       ///< Eingabepuffer anlegen
+EventQueueClass eventQueue; ///< Eventqueue (Ringpuffer fester Größe)
+ParserClass parser;         ///< Parser für die Kommandostrings im Klartextprotokoll
 LedMatrix leds;             ///< LedMatrix anlegen
+LedBatchClass ledBatch;     ///< Sammelkommandos für die LedMatrix (Binärprotokoll)
+FramebufferClass framebuffer;   ///< Rohdaten-Modus: der PC beschreibt die LedMatrix direkt
 SwitchMatrix switches;      ///< Schaltermatrix - SwitchMatrix - anlegen
+ControlClass control;       ///< Steuerkommandos für den Arduino
+DiagnosticsClass diagnostics;   ///< Diagnosezähler
+LoggerClass logger;         ///< Kompakte Log-Meldungen (siehe logdict.hpp)
+ProtocolClass protocol;     ///< Binäres Übertragungsprotokoll
+TxQueueClass txQueue;       ///< Sendewarteschlange für die Nachrichten an den PC
+LinkClass linkLayer;        ///< Gesicherte Übertragung im Binärprotokoll
+LinkSpeedClass linkSpeed;   ///< Baudrate der seriellen Schnittstelle (SERIAL_DEFAULT_BAUDRATE bzw. ausgehandelt)
+StateSyncClass stateSync;   ///< Abgleich des Anzeigezustands mit dem PC
+HeartbeatClass heartbeat;   ///< Überwachung der Verbindung zum Flugsimulator ("noFS")
+TraceClass trace;           ///< Ablaufprotokoll des loop() (CTRL;TRC)
+FrameClockClass frameClock; ///< Gemeinsamer Zeitstempel eines loop()-Durchlaufs
+LoopTimingClass loopTiming; ///< Laufzeiten der Abschnitte des loop() (CTRL;PERF)
+SchedulerClass scheduler;   ///< Kooperative Ablaufsteuerung des loop()
+
+PanelDevices devices;       ///< Die Geräte des Panels (Uhr, Transponder, ...), siehe devices.hpp
 
-ClockDavtronM803 m803;      ///< Uhr anlegen (ClockDavtron M803)
-TransponderKT76C xpdr;      ///< Transponder anlegen
+uint8_t transmitTask = TASK_NONE;   ///< ID der Aufgabe für das Senden der Schalterstände
+uint8_t dispatchTask = TASK_NONE;   ///< ID der Aufgabe für die Abarbeitung der Eventqueue
+uint8_t showTask = TASK_NONE;       ///< ID der Aufgabe für die Anzeige der Geräte
 
 
 /*********************************************************************************************************//**
@@ -41,26 +70,128 @@ TransponderKT76C xpdr;      ///< Transponder anlegen
  ************************************************************************************************************/
 void serialEvent() {
     while (Serial.available() > 0) {
-        char inChar = char(Serial.read());
-        // prüfen auf gültige Zeichen.
-        // gültige Zeichen in den Buffer aufnehmen, ungültige Zeichen ignorieren
-        // gültig sind: Space, '_' und alle alfanumerischen Zeichen
-        if (isAlphaNumeric(inChar) || (isPunct(inChar)) || (inChar == ' ') || (inChar == '_')) {
-             inBuffer.addChar(inChar);
-        } else {
-            if (((inChar == '\n') || (inChar == '\r')) && (! inBuffer.isEmpty())) {
-                // Zeilenende erkannt und der inBuffer ist nicht leer. D.h., vorher wurde
-                // kein '\r' bzw. '\n' gelesen, was dann den inBuffer geleert hätte.
-                // Also den Buffer jetzt zum Parsen zum Parser senden.
-                eventQueue.addEvent(inBuffer.parseString(inBuffer.get()));
-                inBuffer.wipe();
-                #ifdef DEBUG
-                eventQueue.printQueue();
-                #endif
-            }
-            // alle anderen Zeichen werden ignoriert.
+        if (protocol.isBinary()) {
+            // Binärprotokoll: die Bytes werden in der ProtocolClass zu Frames zusammengesetzt
+            protocol.receiveByte(static_cast<uint8_t>(Serial.read()));
+            continue;
+        }
+        // Klartextprotokoll: jedes Zeichen sofort verarbeiten; bei Zeilenende liegt das fertige Event vor
+        if (parser.receiveChar(char(Serial.read()))) {
+            heartbeat.onActivity(frameClock.getNow());
+            TRACE(PARSE, parser.getEvent().eventId);
+            eventQueue.addEvent(parser.getEvent());
+            LOG(EVENT_QUEUED, parser.getEvent().deviceId, parser.getEvent().eventId);
         }
     }
+    if (eventQueue.getCount() > 0) {
+        scheduler.trigger(dispatchTask);
+    }
+}
+
+
+/*********************************************************************************************************//**
+ * Aufgaben für die Ablaufsteuerung (siehe SchedulerClass)
+ ************************************************************************************************************/
+
+/**
+ * @brief Die per Interrupt gemeldeten Spalten der Schaltermatrix sofort abfragen. Läuft bei jedem Durchlauf,
+ *        damit ein Tastendruck nicht auf die nächste Periode von scanSwitches() warten muss.
+ */
+void scanPendingSwitches(const unsigned long now) {
+    if (switches.scanPendingColumns(now)) {
+        scheduler.trigger(transmitTask);
+    }
+}
+
+
+/**
+ * @brief Schaltermatrix mit der adaptiven Rate der ScanScheduler-Klasse abfragen. Nach jeder Abfrage werden
+ *        die Schalterstände gesendet.
+ */
+void scanSwitches(const unsigned long now) {
+    TRACE(SCAN_START, 0);
+    const bool isScanned = switches.scanIfDue(now);
+    TRACE(SCAN_END, isScanned);
+    if (isScanned) {
+        diagnostics.countScan();
+        scheduler.trigger(transmitTask);
+    }
+}
+
+
+/**
+ * @brief Geänderte Schalterstände senden; ist die Sendewarteschlange voll, beim nächsten Durchlauf weiter.
+ */
+void transmitSwitches(const unsigned long) {
+    if (! switches.transmitStatus(TRANSMIT_ONLY_CHANGED_SWITCHES)) {
+        scheduler.trigger(transmitTask);
+    }
+}
+
+
+/**
+ * @brief Zeitüberwachungen: Wiederholungen der gesicherten Übertragung, Prüfung der Baudrate,
+ *        Verbindung zum PC, Zeitsynchronisation und die Raten der Diagnose.
+ */
+void superviseLink(const unsigned long now) {
+    linkLayer.update(now);
+    linkSpeed.update(now);
+    heartbeat.update(now);
+    switches.syncTimeIfDue(now);
+    diagnostics.update(now);
+}
+
+
+/**
+ * @brief Angeforderte Berichte in die Sendewarteschlange stellen und die Warteschlange ohne Blockieren senden.
+ */
+void transmitQueue(const unsigned long now) {
+    stateSync.update(now);
+    trace.update();
+    diagnostics.transmit();
+    loopTiming.transmit();
+    TRACE(TX_DEPTH, txQueue.getCount());
+    txQueue.flush();
+}
+
+
+/**
+ * @brief Verworfene Events melden, die Eventqueue abarbeiten und danach die Anzeigen der Geräte aktualisieren.
+ */
+void dispatchEvents(const unsigned long) {
+    TokenId droppedDeviceId;
+    TokenId droppedEventId;
+    if (eventQueue.takeDropped(droppedDeviceId, droppedEventId)) {
+        TRACE(OVERFLOW, 0);
+        LOG(EVENT_DROPPED, droppedDeviceId, droppedEventId);
+    }
+    TRACE(DISPATCH_START, eventQueue.getCount());
+    dispatcher.dispatchAll();
+    TRACE(DISPATCH_END, 0);
+    scheduler.trigger(showTask);
+}
+
+
+/**
+ * @brief Die Geräte mit ihrer eigenen Zeitbasis weiterlaufen lassen und anzeigen. Im Rohdaten-Modus
+ *        rendert der PC die Anzeige.
+ */
+void showDevices(const unsigned long now) {
+    devices.tick(now);
+    if (! framebuffer.isActive()) {
+        devices.show();
+    }
+}
+
+
+/**
+ * @brief LED-Matrix refreshen. Die Matrix wird zeilenweise gemultiplext, daher bei jedem Durchlauf.
+ */
+void refreshLeds(const unsigned long now) {
+    TRACE(REFRESH_START, 0);
+    leds.writeToHardware(now);
+    TRACE(REFRESH_END, 0);
+    diagnostics.countRefresh();
 }
 
 
@@ -74,7 +205,7 @@ void serialEvent() {
 void setup() {
     // Serielle Schnittstelle initialisieren
     if (Serial) {
-        Serial.begin(_SERIAL_BAUDRATE, SERIAL_8N1);
+        linkSpeed.begin();
         // wait for serial port to connect. Needed for native USB
         while (!Serial);
         // Schreibpuffer leeren
@@ -87,34 +218,25 @@ void setup() {
     }
 
     leds.initHardware();                      ///< Arduino-Hardware der LED-Matrix initialisieren.
-
-    const uint8_t FL = 2;
-    leds.defineDisplayField(FL, 0, {0, 8});         ///< Die 1. 7-Segment-Anzeige liegt auf der Row 0 und den Cols 8 bis 15: Hunderterstelle.
-    leds.defineDisplayField(FL, 1, {1, 8});         ///< Die 2. 7-Segment-Anzeige liegt auf der Row 1 und den Cols 8 bis 15: Zehnerstelle .
-    leds.defineDisplayField(FL, 2, {2, 8});         ///< Die 3. 7-Segment-Anzeige liegt auf der Row 2 und den Cols 8 bis 15: Einerstelle.
-    leds.display(FL, "0.20");
-    leds.set7SegBlinkOn({0, 8}, true, BLINK_NORMAL);
-
-    const uint8_t SQUAWK = 3;
-    leds.defineDisplayField(SQUAWK, 0, {3, 8});        ///< Die 1. 7-Segment-Anzeige liegt auf der Row 3 und den Cols 8 bis 15: Tausenderstelle.
-    leds.defineDisplayField(SQUAWK, 1, {4, 8});        ///< Die 2. 7-Segment-Anzeige liegt auf der Row 4 und den Cols 8 bis 15: Hunderterstelle.
-    leds.defineDisplayField(SQUAWK, 2, {5, 8});        ///< Die 3. 7-Segment-Anzeige liegt auf der Row 5 und den Cols 8 bis 15: Zehnerstelle.
-    leds.defineDisplayField(SQUAWK, 3, {6, 8});        ///< Die 4. 7-Segment-Anzeige liegt auf der Row 6 und den Cols 8 bis 15: Einerstelle.
-    leds.display(SQUAWK, "7000");
-
-    const LedMatrixPos LED_ALT{6, 4};       ///< Die LED "ALT" liegt auf Row=2 und Col=4.leds.ledOn(LED_ALT);
-    leds.ledOn(LED_ALT);
-    const LedMatrixPos LED_R = {7, 4};      ///< Die LED "R" liegt auf Row=3 und Col=4.
-    leds.ledOn(LED_R);
-    leds.ledBlinkOn(LED_R, BLINK_SLOW);
-
+                                              ///< Displays und LEDs der Geräte legen deren Konstruktoren fest.
     switches.initHardware();            ///< Die Arduino-Hardware der Schaltermatrix initialisieren.
-    switches.scanSwitchPins();          ///< Initiale Schalterstände abfragen und übertragen.
-    switches.transmitStatus(TRANSMIT_ALL_SWITCHES);     ///< Den aktuellen ein-/aus-Status der Schalter an den PC senden.
-    #ifdef DEBUG
-    switches.printMatrix();
-    //eventQueue.printQueue();
-    #endif
+    frameClock.tick();
+    switches.scanSwitchPins(frameClock.getNow());          ///< Initiale Schalterstände abfragen und übertragen.
+    switches.feedDevices(frameClock.getNow());  ///< Die Geräte (z.B. Wahlschalter des Transponders) auf den Stand bringen.
+    switches.transmitSnapshot();        ///< Den aktuellen ein-/aus-Status aller Schalter kompakt an den PC senden.
+    switches.enableInterruptMode(true); ///< Tastendrücke zwischen den Abfragen per Pin-Change-Interrupt erkennen.
+    heartbeat.begin();                  ///< Bis sich der PC meldet, zeigen die Geräte "noFS".
+
+    // Aufgaben der Ablaufsteuerung: Periode in ms, Priorität (0 = höchste), Abschnitt der Laufzeitmessung
+    scheduler.addTask(scanPendingSwitches, TASK_EVERY_PASS, 0, LoopStage::SCAN);
+    scheduler.addTask(scanSwitches, SCAN_BURST_INTERVAL, 0, LoopStage::SCAN);
+    transmitTask = scheduler.addTask(transmitSwitches, TASK_ON_TRIGGER, 0, LoopStage::SCAN);
+    scheduler.addTask(transmitQueue, 1, 1, LoopStage::TX);
+    scheduler.addTask(superviseLink, 10, 1, LoopStage::TX);
+    dispatchTask = scheduler.addTask(dispatchEvents, TASK_ON_TRIGGER, 2, LoopStage::DISPATCH);
+    showTask = scheduler.addTask(showDevices, 10, 3, LoopStage::SHOW);
+    scheduler.addTask(refreshLeds, TASK_EVERY_PASS, 4, LoopStage::REFRESH);
+    LOG(SETUP_DONE, SWITCH_MATRIX_ROWS, SWITCH_MATRIX_COLS);
 }
 
 /*********************************************************************************************************//**
@@ -122,11 +244,10 @@ void setup() {
  *
  ************************************************************************************************************/
 void loop() {
-    switches.scanSwitchPins();  ///< Hardware-Schalter abfragen
-    switches.transmitStatus(TRANSMIT_ONLY_CHANGED_SWITCHES);    ///< Geänderte Schalterstände verarbeiten
-    //readXplane()  -  Daten vom X-Plane einlesen (besser als Interrupt realisieren)
-    dispatcher.dispatchAll();   ///< Eventqueue abarbeiten
-    m803.show();
-    //xpdr.show();
-    leds.writeToHardware();     ///< LEDs anzeigen bzw. refreshen
+    frameClock.tick();          ///< Die Zeit einmal für den ganzen Durchlauf lesen
+    loopTiming.startLoop();
+    TRACE(LOOP, 0);
+    diagnostics.countLoop();
+    scheduler.runDue();     ///< Nur die fälligen Aufgaben ausführen
+    loopTiming.endLoop();
 }
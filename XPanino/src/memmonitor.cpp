@@ -0,0 +1,183 @@
+/*********************************************************************************************************//**
+ * @file memmonitor.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Implementierung der Klasse @em MemoryMonitorClass.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#include <memmonitor.hpp>
+
+static uint16_t allocations = 0;        ///< Anzahl erfolgreicher Anforderungen von Heap-Speicher
+static uint16_t allocFailures = 0;      ///< Anzahl fehlgeschlagener Anforderungen von Heap-Speicher
+static uint16_t frees = 0;              ///< Anzahl Freigaben von Heap-Speicher
+
+#ifdef __AVR__
+
+/// Symbole des Linkers bzw. der avr-libc (siehe malloc.c und stdlib_private.h der avr-libc).
+extern uint8_t _end;                    ///< Ende der globalen Variablen (.data und .bss)
+extern uint8_t __stack;                 ///< Oberstes Byte des RAM, Beginn des Stacks
+extern char __heap_start;               ///< Beginn des Heaps
+extern char *__brkval;                  ///< Aktuelles Ende des Heaps; 0 = noch nichts angefordert
+extern size_t __malloc_margin;          ///< Mindestabstand zwischen Heap und Stack
+
+/// Eintrag in der Liste der freigegebenen Blöcke der avr-libc.
+struct __freelist {
+    size_t sz;
+    struct __freelist *nx;
+};
+extern struct __freelist *__flp;        ///< Liste der freigegebenen Blöcke
+
+
+/**
+ * @brief Den RAM vom Ende der globalen Variablen bis zum Beginn des Stacks mit @em STACK_CANARY füllen.
+ *
+ * Läuft im Abschnitt .init3, also nach dem Setzen des Stackpointers und vor dem Initialisieren der
+ * globalen Variablen. Der Stack ist dann noch leer, daher ohne Prolog und nur mit Registern.
+ */
+void paintStack() __attribute__((naked, used, section(".init3")));
+
+void paintStack() {
+    __asm volatile (
+        "    ldi r30, lo8(_end)     \n"
+        "    ldi r31, hi8(_end)     \n"
+        "    ldi r24, %0            \n"
+        "    ldi r25, hi8(__stack)  \n"
+        "    rjmp 2f                \n"
+        "1:  st Z+, r24             \n"
+        "2:  cpi r30, lo8(__stack)  \n"
+        "    cpc r31, r25           \n"
+        "    brlo 1b                \n"
+        "    breq 1b                \n"
+        : : "M" (STACK_CANARY) : "r24", "r25", "r30", "r31", "memory");
+}
+
+
+/**
+ * @brief Aktuelles Ende des Heaps bzw. dessen Beginn, solange noch nichts angefordert wurde.
+ */
+static uint8_t *heapEnd() {
+    return reinterpret_cast<uint8_t *>((__brkval == nullptr) ? &__heap_start : __brkval);
+}
+
+#endif /* ifdef __AVR__ */
+
+
+#ifdef MEM_WRAP_MALLOC
+/*********************************************************************************************************//**
+ * Zähler für malloc() und free(); wirksam durch -Wl,--wrap=malloc -Wl,--wrap=free. new, delete und die
+ * Klasse String verwenden intern ebenfalls malloc() bzw. free().
+ ************************************************************************************************************/
+extern "C" {
+    void *__real_malloc(size_t size);
+    void __real_free(void *ptr);
+
+    void *__wrap_malloc(const size_t size) {
+        void *ptr = __real_malloc(size);
+        if (ptr != nullptr) {
+            allocations++;
+        } else {
+            allocFailures++;
+        }
+        return ptr;
+    }
+
+    void __wrap_free(void *ptr) {
+        if (ptr != nullptr) {
+            frees++;
+        }
+        __real_free(ptr);
+    }
+}
+#endif /* ifdef MEM_WRAP_MALLOC */
+
+
+/*********************************************************************************************************//**
+ * MemoryMonitorClass - public Methoden
+ *
+ ************************************************************************************************************/
+
+uint16_t MemoryMonitorClass::getFreeRam() {
+    #ifdef __AVR__
+    uint8_t top;    // liegt auf dem Stack, die Adresse entspricht also dem Stackpointer
+    return static_cast<uint16_t>(&top - heapEnd());
+    #else
+    return 0;
+    #endif
+}
+
+
+uint16_t MemoryMonitorClass::getStackHighWater() {
+    #ifdef __AVR__
+    return static_cast<uint16_t>(&__stack - heapEnd()) + 1 - getStackReserve();
+    #else
+    return 0;
+    #endif
+}
+
+
+uint16_t MemoryMonitorClass::getStackReserve() {
+    #ifdef __AVR__
+    // Der Heap überschreibt das Füllmuster von unten, daher erst ab seinem Ende suchen.
+    const uint8_t *pos = heapEnd();
+    while ((pos <= &__stack) && (*pos == STACK_CANARY)) {
+        pos++;
+    }
+    return static_cast<uint16_t>(pos - heapEnd());
+    #else
+    return 0;
+    #endif
+}
+
+
+uint16_t MemoryMonitorClass::getHeapSize() {
+    #ifdef __AVR__
+    return static_cast<uint16_t>(heapEnd() - reinterpret_cast<uint8_t *>(&__heap_start));
+    #else
+    return 0;
+    #endif
+}
+
+
+uint16_t MemoryMonitorClass::getHeapFree() {
+    uint16_t total = 0;
+    #ifdef __AVR__
+    for (const struct __freelist *block = __flp; block != nullptr; block = block->nx) {
+        total += block->sz;
+    }
+    #endif
+    return total;
+}
+
+
+uint16_t MemoryMonitorClass::getLargestBlock() {
+    uint16_t largest = 0;
+    #ifdef __AVR__
+    for (const struct __freelist *block = __flp; block != nullptr; block = block->nx) {
+        largest = max(largest, static_cast<uint16_t>(block->sz));
+    }
+    const uint16_t freeRam = getFreeRam();
+    if (freeRam > __malloc_margin) {
+        largest = max(largest, static_cast<uint16_t>(freeRam - __malloc_margin));
+    }
+    #endif
+    return largest;
+}
+
+
+uint16_t MemoryMonitorClass::getAllocations() {
+    return allocations;
+}
+
+
+uint16_t MemoryMonitorClass::getAllocFailures() {
+    return allocFailures;
+}
+
+
+uint16_t MemoryMonitorClass::getFrees() {
+    return frees;
+}
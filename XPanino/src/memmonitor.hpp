@@ -0,0 +1,91 @@
+/*********************************************************************************************************//**
+ * @file memmonitor.hpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Interface der Klasse @em MemoryMonitorClass: Überwachung von freiem RAM, Stack und Heap.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+
+const uint8_t STACK_CANARY = 0xC5;      ///< Füllmuster für den freien RAM zwischen Heap und Stack
+
+
+/*********************************************************************************************************//**
+ * @brief Überwachung des RAM auf dem Arduino Uno (2 KB): freier Speicher, Höchststand des Stacks und
+ *        Zustand des Heaps.
+ *
+ * Vor dem Aufruf der Konstruktoren wird der ganze freie RAM oberhalb der globalen Variablen mit
+ * @em STACK_CANARY gefüllt (Abschnitt .init3). Wie weit der Stack jemals gewachsen ist, zeigt dann das
+ * erste überschriebene Byte unterhalb des Stacks.
+ *
+ * Die Anzahl der Anforderungen von Heap-Speicher (malloc(), new, String) wird nur gezählt, wenn mit
+ * `-DMEM_WRAP_MALLOC -Wl,--wrap=malloc -Wl,--wrap=free` gebaut wird (siehe platformio.ini); sonst ist
+ * sie 0. Ohne AVR-Controller (z.B. Übersetzung auf dem PC) liefern alle anderen Methoden 0; die Zähler
+ * für malloc() und free() gibt es dort auch (env:native, lib/ArduinoHost).
+ *
+ * Die Werte werden mit `CTRL;DIAG` als Diagnosewerte gesendet. Den statischen RAM je Objekt zeigt
+ * tools/ramreport.py beim Bauen.
+ *
+ ************************************************************************************************************/
+class MemoryMonitorClass {
+public:
+    /**
+     * @brief Freier RAM zwischen dem Ende des Heaps und dem aktuellen Stackpointer.
+     *
+     * @return Anzahl Bytes.
+     */
+    static uint16_t getFreeRam();
+
+
+    /**
+     * @brief Höchststand des Stacks seit dem Start.
+     *
+     * @return Anzahl Bytes, die der Stack höchstens belegt hat.
+     */
+    static uint16_t getStackHighWater();
+
+
+    /**
+     * @brief Reserve zwischen Heap und Stack, die noch nie benutzt wurde.
+     *
+     * @return Anzahl Bytes mit unverändertem Füllmuster.
+     */
+    static uint16_t getStackReserve();
+
+
+    /**
+     * @brief Vom Heap belegter Bereich inkl. freigegebener Blöcke.
+     *
+     * @return Anzahl Bytes.
+     */
+    static uint16_t getHeapSize();
+
+
+    /**
+     * @brief Summe der freigegebenen Blöcke im Heap, die erneut vergeben werden können.
+     *
+     * @return Anzahl Bytes.
+     */
+    static uint16_t getHeapFree();
+
+
+    /**
+     * @brief Größter Block, den malloc() derzeit vergeben kann: der größte freigegebene Block oder der
+     *        Platz zwischen Heap und Stack (abzüglich @em __malloc_margin). Ist er deutlich kleiner als
+     *        der freie RAM, ist der Heap zersplittert.
+     *
+     * @return Anzahl Bytes.
+     */
+    static uint16_t getLargestBlock();
+
+
+    static uint16_t getAllocations();       ///< Anzahl erfolgreicher Anforderungen von Heap-Speicher
+    static uint16_t getAllocFailures();     ///< Anzahl fehlgeschlagener Anforderungen von Heap-Speicher
+    static uint16_t getFrees();             ///< Anzahl Freigaben von Heap-Speicher
+};
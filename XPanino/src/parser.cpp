@@ -0,0 +1,116 @@
+/*********************************************************************************************************//**
+ * @file parser.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Implementierung der Klasse @em ParserClass.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#include <parser.hpp>
+
+
+/*********************************************************************************************************//**
+ * ParserClass - public Methoden
+ *
+ ************************************************************************************************************/
+
+bool ParserClass::receiveChar(const char inChar) {
+    if ((inChar == '\n') || (inChar == '\r')) {
+        return endLine();
+    }
+    // gültig sind: Space, '_' und alle alfanumerischen Zeichen und Satzzeichen
+    if (! (isAlphaNumeric(inChar) || isPunct(inChar) || (inChar == ' ') || (inChar == '_'))) {
+        invalidChars++;
+        return false;   // alle anderen Zeichen werden ignoriert.
+    }
+    if (state == ParserState::LINE_START) {
+        startLine();
+    }
+    if (state != ParserState::FIELD) {
+        return false;   // EXTRA_FIELDS bzw. DISCARD: bis zum Zeilenende nichts mehr übernehmen
+    }
+    if (inChar == PARSER_DELIMITER) {
+        fieldIndex++;
+        fieldPos = 0;
+        if (fieldIndex >= PARSER_FIELD_COUNT) {
+            state = ParserState::EXTRA_FIELDS;  // mehr als 4 Felder; die überzähligen ignorieren
+        }
+        return false;
+    }
+    addToField(inChar);
+    return false;
+}
+
+
+/*********************************************************************************************************//**
+ * ab hier die privaten Methoden
+*************************************************************************************************************/
+
+/**
+ * @brief Eine neue Zeile beginnen: alle Felder des Events leeren.
+ */
+void ParserClass::startLine() {
+    event.device[0] = '\0';
+    event.event[0] = '\0';
+    event.parameter1[0] = '\0';
+    event.parameter2[0] = '\0';
+    fieldIndex = 0;
+    fieldPos = 0;
+    state = ParserState::FIELD;
+}
+
+
+/**
+ * @brief Zeilenende verarbeiten.
+ *
+ * Leere Zeilen (z.B. das '\\n' nach einem '\\r') werden ignoriert.
+ *
+ * @return @em true falls ein fehlerfreies Event vorliegt.
+ */
+bool ParserClass::endLine() {
+    const ParserState lastState = state;
+    state = ParserState::LINE_START;
+    switch (lastState) {
+        case ParserState::FIELD:
+        case ParserState::EXTRA_FIELDS: { event.intern(); return true; }
+        case ParserState::DISCARD: { lineErrors++; return false; }
+        default: return false;
+    }
+}
+
+
+/**
+ * @brief Ein Zeichen an das aktuelle Feld anhängen und dabei die max. Feldlänge prüfen.
+ *
+ * @param inChar Das anzuhängende Zeichen.
+ */
+void ParserClass::addToField(const char inChar) {
+    uint8_t maxLength = 0;
+    char *field = getField(maxLength);
+    if (fieldPos + 1 >= maxLength) {
+        state = ParserState::DISCARD;   // Feld zu lang; die ganze Zeile verwerfen
+        return;
+    }
+    field[fieldPos] = static_cast<char>(toupper(inChar));
+    fieldPos++;
+    field[fieldPos] = '\0';
+}
+
+
+/**
+ * @brief Das aktuelle Feld des Events ermitteln.
+ *
+ * @param maxLength Rückgabe der Größe des Feldes inkl. '\\0'.
+ * @return char* Zeiger auf das Feld.
+ */
+char *ParserClass::getField(uint8_t &maxLength) {
+    switch (fieldIndex) {
+        case 0: { maxLength = MAX_SRC_DEV_LENGTH; return event.device; }
+        case 1: { maxLength = MAX_SRC_DEV_LENGTH; return event.event; }
+        case 2: { maxLength = MAX_PARA_LENGTH; return event.parameter1; }
+        default: { maxLength = MAX_PARA_LENGTH; return event.parameter2; }
+    }
+}
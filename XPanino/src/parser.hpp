@@ -0,0 +1,96 @@
+/*********************************************************************************************************//**
+ * @file parser.hpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Interface der Klasse @em ParserClass.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+#include <event.hpp>
+
+const uint8_t PARSER_FIELD_COUNT = 4;   ///< Anzahl der Bestandteile eines Kommandostrings
+const char PARSER_DELIMITER = ';';      ///< Trennzeichen zwischen den Bestandteilen des Kommandostrings
+
+
+/*********************************************************************************************************//**
+ * @brief Zustände des Parsers.
+ *
+ ************************************************************************************************************/
+enum class ParserState : uint8_t {
+    LINE_START,     ///< Noch kein Zeichen der Zeile gelesen
+    FIELD,          ///< Zeichen werden in das aktuelle Feld übernommen
+    EXTRA_FIELDS,   ///< Mehr als 4 Felder: die überzähligen Zeichen bis zum Zeilenende ignorieren
+    DISCARD         ///< Fehler in der Zeile: alles bis zum Zeilenende verwerfen
+};
+
+
+/*********************************************************************************************************//**
+ * @brief Parser für die von der seriellen Schnittstelle gelesenen Kommandostrings.
+ *
+ * Jedes Zeichen wird sofort beim Empfang verarbeitet, in Großbuchstaben umgewandelt und direkt in das
+ * passende Feld des Events geschrieben. Ein Zwischenpuffer für die ganze Zeile wird nicht benötigt,
+ * der Aufwand je Zeichen ist konstant.
+ *
+ * Im vom Flugsimulator erhaltenen String werden folgende Informationen erwartet,
+ * jeweils getrennt durch ein Semikolon:
+ * - device     - Device, dass ein Ereignis hat
+ * - devEvent   - Ereignis; vgl. Doku
+ * - parameter1 - Wert zu dem device/Ereignis
+ * - parameter2 - Wert zu dem device/Ereignis
+ *
+ * Ist ein Feld länger als im Event vorgesehen, wird die ganze Zeile verworfen und als Fehler gezählt.
+ *
+ ************************************************************************************************************/
+class ParserClass {
+public:
+    /**
+     * @brief Ein von der seriellen Schnittstelle gelesenes Zeichen verarbeiten.
+     *
+     * Gültige Zeichen sind Space, '_' und alle alfanumerischen Zeichen und Satzzeichen.
+     * Ungültige Zeichen werden ignoriert. '\\r' bzw. '\\n' schließen die Zeile ab.
+     *
+     * @param inChar Das gelesene Zeichen.
+     * @return @em true  Die Zeile ist vollständig und fehlerfrei; das Event kann mit
+     *                   @em getEvent() abgeholt werden.\n
+     *         @em false Die Zeile ist noch nicht vollständig oder wurde verworfen.
+     */
+    bool receiveChar(char inChar);
+
+    /**
+     * @brief Das zuletzt vollständig gelesene Event.
+     *
+     * Das Event bleibt gültig, bis das erste Zeichen der nächsten Zeile gelesen wird.
+     *
+     * @return const EventClass& Das Event.
+     */
+    inline const EventClass &getEvent() const { return event; }
+
+    /**
+     * @brief Anzahl der wegen zu langer Felder verworfenen Zeilen.
+     */
+    inline unsigned long getLineErrors() const { return lineErrors; }
+
+    /**
+     * @brief Anzahl der ignorierten ungültigen Zeichen (z.B. bei falscher Baudrate).
+     */
+    inline unsigned long getInvalidChars() const { return invalidChars; }
+
+private:
+    EventClass event;                           ///< Das Event, in das die Felder direkt geschrieben werden
+    ParserState state = ParserState::LINE_START;    ///< Aktueller Zustand
+    uint8_t fieldIndex = 0;                     ///< Nummer des aktuellen Feldes (0 = device)
+    uint8_t fieldPos = 0;                       ///< Position des nächsten Zeichens im aktuellen Feld
+    unsigned long lineErrors = 0;               ///< Anzahl der verworfenen Zeilen
+    unsigned long invalidChars = 0;             ///< Anzahl der ignorierten ungültigen Zeichen
+
+    void startLine();
+    bool endLine();
+    void addToField(char inChar);
+    char *getField(uint8_t &maxLength);
+};
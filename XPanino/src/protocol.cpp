@@ -0,0 +1,345 @@
+/*********************************************************************************************************//**
+ * @file protocol.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Implementierung der Klasse @em ProtocolClass.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#include <protocol.hpp>
+#include <event.hpp>
+#include <framebuffer.hpp>
+#include <heartbeat.hpp>
+#include <ledbatch.hpp>
+#include <frameclock.hpp>
+#include <link.hpp>
+#include <logger.hpp>
+#include <trace.hpp>
+#include <statesync.hpp>
+#include <txqueue.hpp>
+
+extern EventQueueClass eventQueue;
+extern FramebufferClass framebuffer;
+extern HeartbeatClass heartbeat;
+extern LedBatchClass ledBatch;
+extern LinkClass linkLayer;
+extern StateSyncClass stateSync;
+extern TxQueueClass txQueue;
+
+
+/*********************************************************************************************************//**
+ * @brief Zuordnung der vom PC empfangenen Kommandocodes zu Device, Event und Datentyp der Nutzdaten.
+ *
+ * Die empfangenen Records werden damit in die gleichen Events übersetzt, die auch das
+ * Klartextprotokoll liefert.
+ ************************************************************************************************************/
+struct OpcodeMapping {
+    uint16_t opcode;                        ///< Kommandocode gem. commands.hpp
+    char device[MAX_SRC_DEV_LENGTH];        ///< Device des Events
+    char event[MAX_SRC_DEV_LENGTH];         ///< Event
+    PayloadType payloadType;                ///< Datentyp der Nutzdaten; wird in parameter1 übergeben
+};
+
+const OpcodeMapping opcodeMappings[] PROGMEM = {
+    {XPDR_CODE,         "XPDR", "CODE", PayloadType::SQUAWK},
+    {XPDR_FLIGHTLEVEL,  "XPDR", "F",    PayloadType::I16},
+    {M803_LT,           "M803", "LT",   PayloadType::HHMMSS},
+    {M803_UT,           "M803", "UT",   PayloadType::HHMMSS},
+    {M803_ET,           "M803", "ET",   PayloadType::HHMMSS},
+    {M803_FT,           "M803", "FT",   PayloadType::HHMMSS},
+    {M803_OATF,         "M803", "F",    PayloadType::I16},
+    {M803_OATC,         "M803", "C",    PayloadType::I16},
+    {M803_VOLTS,        "M803", "V",    PayloadType::U16},
+    {M803_QNH,          "M803", "Q",    PayloadType::U16},
+    {M802_ALT,          "M803", "A",    PayloadType::U16},
+    {RESEND_SWITCHES,   "CTRL", "RSW",  PayloadType::NONE}
+};
+
+
+/*********************************************************************************************************//**
+ * ProtocolClass - public Methoden
+ *
+ ************************************************************************************************************/
+
+void ProtocolClass::setMode(const ProtocolMode newMode) {
+    mode = newMode;
+    rxLength = 0;
+    rxOverflow = false;
+    linkLayer.reset();  // gesicherte Übertragung beginnt in beiden Richtungen mit der Folgenummer 0
+}
+
+
+void ProtocolClass::receiveByte(const uint8_t inByte) {
+    if (inByte == FRAME_DELIMITER) {
+        if (rxOverflow) {
+            frameErrors++;
+        } else if (rxLength > 0) {
+            uint8_t length = cobsDecode(rxBuffer, rxLength);
+            if ((length < 1) || (crc8(rxBuffer, length - 1) != rxBuffer[length - 1])) {
+                frameErrors++;
+                LOG(FRAME_ERROR, frameErrors, 0);
+            } else {
+                framesReceived++;
+                TRACE(PARSE, length);
+                heartbeat.onActivity(frameClock.getNow());
+                processFrame(rxBuffer, length - 1);
+            }
+        }
+        rxLength = 0;
+        rxOverflow = false;
+        return;
+    }
+    if (rxLength < sizeof(rxBuffer)) {
+        rxBuffer[rxLength] = inByte;
+        rxLength++;
+    } else {
+        rxOverflow = true;  // Rest bis zum nächsten Trennzeichen ignorieren
+    }
+}
+
+
+bool ProtocolClass::addRecord(const uint16_t opcode, const uint8_t *payload, const uint8_t length) {
+    // Platz für den Record-Kopf, die Nutzdaten und die CRC am Ende des Frames
+    if (txLength + RECORD_HEADER_LENGTH + length + 1 > FRAME_MAX_LENGTH) {
+        return false;
+    }
+    putUint16(&txBuffer[txLength], opcode);
+    txBuffer[txLength + 2] = length;
+    txLength += RECORD_HEADER_LENGTH;
+    if (length > 0) {
+        memcpy(&txBuffer[txLength], payload, length);
+        txLength += length;
+    }
+    return true;
+}
+
+
+void ProtocolClass::endFrame() {
+    if (txLength == 0) {
+        return;     // leere Frames nicht senden
+    }
+    txBuffer[txLength] = crc8(txBuffer, txLength);
+    txLength++;
+    // COBS-Kodierung: jeder Block endet an einer Null (bzw. am Ende des Frames) und wird durch
+    // seine Länge + 1 ersetzt. Da ein Frame kürzer als 254 Bytes ist, gibt es keine 0xFF-Blöcke.
+    uint8_t blockStart = 0;
+    for (uint8_t pos = 0; pos <= txLength; ++pos) {
+        if ((pos == txLength) || (txBuffer[pos] == 0)) {
+            Serial.write(static_cast<uint8_t>(pos - blockStart + 1));
+            Serial.write(&txBuffer[blockStart], pos - blockStart);
+            blockStart = pos + 1;
+        }
+    }
+    Serial.write(FRAME_DELIMITER);
+    framesSent++;
+    txLength = 0;
+}
+
+
+uint8_t ProtocolClass::crc8(const uint8_t *data, const uint8_t length) {
+    const uint8_t POLYNOM = 0x07;
+    uint8_t crc = 0;
+    for (uint8_t pos = 0; pos < length; ++pos) {
+        crc ^= data[pos];
+        for (uint8_t bit = 0; bit < 8; ++bit) {
+            crc = ((crc & 0x80) != 0) ? static_cast<uint8_t>((crc << 1) ^ POLYNOM) : static_cast<uint8_t>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+
+uint8_t ProtocolClass::cobsDecode(uint8_t *frame, const uint8_t length) {
+    uint8_t inPos = 0;
+    uint8_t outPos = 0;
+    while (inPos < length) {
+        uint8_t code = frame[inPos];
+        inPos++;
+        if ((code == 0) || (inPos + code - 1 > length)) {
+            return 0;   // ungültige Kodierung
+        }
+        for (uint8_t i = 1; i < code; ++i) {
+            frame[outPos] = frame[inPos];
+            outPos++;
+            inPos++;
+        }
+        if ((code != 0xFF) && (inPos < length)) {
+            frame[outPos] = 0;
+            outPos++;
+        }
+    }
+    return outPos;
+}
+
+
+/*********************************************************************************************************//**
+ * ab hier die privaten Methoden
+*************************************************************************************************************/
+
+/**
+ * @brief Die Records eines dekodierten und geprüften Frames nacheinander verarbeiten.
+ *
+ * @param frame Der dekodierte Frame ohne CRC.
+ * @param length Länge des Frames ohne CRC.
+ */
+void ProtocolClass::processFrame(const uint8_t *frame, const uint8_t length) {
+    uint8_t pos = 0;
+    // Gesicherter Frame: nur verarbeiten, wenn es der nächste erwartete ist (siehe LinkClass). Ist für
+    // seine Events kein Platz, wird er weder verarbeitet noch bestätigt; der PC wiederholt ihn.
+    if ((length >= RECORD_HEADER_LENGTH + 1) && ((static_cast<uint16_t>(frame[0]) << 8 | frame[1]) == SEQUENCE)
+        && (frame[2] == 1)) {
+        if (! hasRoomFor(frame, RECORD_HEADER_LENGTH + 1, length)) {
+            framesRefused++;
+            return;
+        }
+        if (! linkLayer.acceptSequence(frame[3])) {
+            return;     // doppelter oder zu früher Frame
+        }
+        pos = RECORD_HEADER_LENGTH + 1;
+    }
+    while (pos + RECORD_HEADER_LENGTH <= length) {
+        uint16_t opcode = (static_cast<uint16_t>(frame[pos]) << 8) | frame[pos + 1];
+        uint8_t payloadLength = frame[pos + 2];
+        pos += RECORD_HEADER_LENGTH;
+        if (pos + payloadLength > length) {
+            frameErrors++;  // Record ragt über das Frame-Ende hinaus
+            return;
+        }
+        processRecord(opcode, &frame[pos], payloadLength);
+        pos += payloadLength;
+    }
+}
+
+
+/**
+ * @brief Prüfen, ob die Eventqueue und der Ringpuffer der Sammelkommandos alle Records eines Frames
+ *        aufnehmen können. Für Zustandsmeldungen wird ein eigener Platz angenommen, auch wenn sie später
+ *        eine wartende Meldung ersetzen.
+ *
+ * @param frame Der dekodierte Frame ohne CRC.
+ * @param pos Beginn des ersten Records nach dem @em SEQUENCE-Record.
+ * @param length Länge des Frames ohne CRC.
+ * @return @em true falls für alle Records Platz ist.
+ */
+bool ProtocolClass::hasRoomFor(const uint8_t *frame, uint8_t pos, const uint8_t length) {
+    uint8_t events = 0;
+    uint8_t batches = 0;
+    while (pos + RECORD_HEADER_LENGTH <= length) {
+        const uint16_t opcode = (static_cast<uint16_t>(frame[pos]) << 8) | frame[pos + 1];
+        if (opcode == LED_BATCH) {
+            batches++;
+            events++;
+        } else if (isMappedOpcode(opcode)) {
+            events++;
+        }
+        pos += RECORD_HEADER_LENGTH + frame[pos + 2];
+    }
+    return (batches <= ledBatch.getFree()) && (eventQueue.getCount() + events <= EVENT_QUEUE_SIZE);
+}
+
+
+/**
+ * @brief Prüfen, ob der Kommandocode in ein Event übersetzt wird (siehe @em opcodeMappings).
+ *
+ * @param opcode Kommandocode gem. commands.hpp.
+ */
+bool ProtocolClass::isMappedOpcode(const uint16_t opcode) {
+    for (const auto &entry : opcodeMappings) {
+        if (pgm_read_word(&entry.opcode) == opcode) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * @brief Einen Record verarbeiten: Protokollkommandos direkt ausführen, alle anderen
+ *        Kommandocodes in ein Event übersetzen und in die Eventqueue stellen.
+ *
+ * @param opcode Kommandocode gem. commands.hpp.
+ * @param payload Die Nutzdaten.
+ * @param length Länge der Nutzdaten.
+ */
+void ProtocolClass::processRecord(const uint16_t opcode, const uint8_t *payload, const uint8_t length) {
+    if (opcode == PROTOCOL_ASCII) {
+        setMode(ProtocolMode::ASCII);
+        txQueue.addReply(TxReply::ASC_OK);
+        return;
+    }
+    if (opcode == ACK) {
+        if (length >= 1) {
+            linkLayer.onAck(payload[0], frameClock.getNow());
+        }
+        return;
+    }
+    if (opcode == HEARTBEAT) {
+        if (length >= 2) {
+            heartbeat.setTimeout((static_cast<uint16_t>(payload[0]) << 8) | payload[1]);
+        }
+        return;
+    }
+    if (opcode == FRAMEBUFFER) {
+        framebuffer.receive(payload, length);   // direkt, ohne Umweg über die Eventqueue
+        return;
+    }
+    if (opcode == FRAMEBUFFER_MODE) {
+        framebuffer.setActive((length >= 1) && (payload[0] != 0));
+        return;
+    }
+    if (opcode == STATE_SNAPSHOT) {
+        stateSync.receiveSnapshot(payload, length, frameClock.getNow());
+        return;
+    }
+    if (opcode == STATE_DELTA) {
+        stateSync.receiveDelta(payload, length);
+        return;
+    }
+    if (opcode == STATE_QUERY) {
+        stateSync.requestReport();
+        return;
+    }
+    if (opcode == LED_BATCH) {
+        ledBatch.receive(payload, length);
+        return;
+    }
+    for (const auto &entry : opcodeMappings) {
+        OpcodeMapping mapping;
+        memcpy_P(&mapping, &entry, sizeof(mapping));
+        if (mapping.opcode != opcode) {
+            continue;
+        }
+        uint16_t value = (length >= 2) ? ((static_cast<uint16_t>(payload[0]) << 8) | payload[1]) : 0;
+        EventClass event {};
+        strcpy(event.device, mapping.device);
+        strcpy(event.event, mapping.event);
+        switch (mapping.payloadType) {
+            case PayloadType::U16: {
+                snprintf(event.parameter1, MAX_PARA_LENGTH, "%u", value);
+                break;
+            }
+            case PayloadType::I16: {
+                snprintf(event.parameter1, MAX_PARA_LENGTH, "%d", static_cast<int16_t>(value));
+                break;
+            }
+            case PayloadType::SQUAWK: {
+                snprintf(event.parameter1, MAX_PARA_LENGTH, "%04u", value);
+                break;
+            }
+            case PayloadType::HHMMSS: {
+                uint32_t time = (length >= 4) ? ((static_cast<uint32_t>(value) << 16)
+                                                 | (static_cast<uint16_t>(payload[2]) << 8) | payload[3]) : 0;
+                snprintf(event.parameter1, MAX_PARA_LENGTH, "%06lu", static_cast<unsigned long>(time % 1000000));
+                break;
+            }
+            default: ;  // keine Nutzdaten
+        }
+        event.intern();
+        eventQueue.addEvent(event);
+        return;
+    }
+    // unbekannter Kommandocode: ignorieren
+}
@@ -0,0 +1,191 @@
+/*********************************************************************************************************//**
+ * @file protocol.hpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Interface der Klasse @em ProtocolClass: binäres Übertragungsprotokoll mit COBS-Rahmen.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+#include <commands.hpp>
+
+const uint8_t FRAME_MAX_LENGTH = 32;    ///< Max. Länge eines (dekodierten) Frames inkl. CRC
+const uint8_t FRAME_DELIMITER = 0x00;   ///< Trennzeichen zwischen den COBS-kodierten Frames
+const uint8_t RECORD_HEADER_LENGTH = 3; ///< Länge des Record-Kopfs: Kommandocode (2 Bytes) und Länge (1 Byte)
+
+
+/*********************************************************************************************************//**
+ * @brief Aufzählungstyp für die Übertragungsprotokolle.
+ *
+ ************************************************************************************************************/
+enum class ProtocolMode : uint8_t {
+    ASCII,      ///< Klartextprotokoll, z.B. @em S;S;ON;2;3 -- für das Debuggen im Terminal
+    BINARY      ///< Binärprotokoll mit COBS-Rahmen, Kommandocodes aus commands.hpp und CRC-8
+};
+
+
+/*********************************************************************************************************//**
+ * @brief Aufzählungstyp für die Datentypen der Nutzdaten im Binärprotokoll.
+ *
+ ************************************************************************************************************/
+enum class PayloadType : uint8_t {
+    NONE,       ///< keine Nutzdaten
+    U16,        ///< uint16_t
+    I16,        ///< int16_t
+    SQUAWK,     ///< uint16_t, wird vierstellig mit führenden Nullen übergeben
+    HHMMSS      ///< uint32_t, Uhrzeit im Format HHMMSS; wird sechsstellig mit führenden Nullen übergeben
+};
+
+
+/**
+ * @brief Einen uint16_t mit dem MSB zuerst in die Nutzdaten schreiben.
+ *
+ * @param dst Zeiger auf die Nutzdaten.
+ * @param value Der zu schreibende Wert.
+ */
+inline void putUint16(uint8_t *dst, const uint16_t value) {
+    dst[0] = static_cast<uint8_t>(value >> 8);
+    dst[1] = static_cast<uint8_t>(value);
+}
+
+
+/**
+ * @brief Einen uint32_t mit dem MSB zuerst in die Nutzdaten schreiben.
+ *
+ * @param dst Zeiger auf die Nutzdaten.
+ * @param value Der zu schreibende Wert.
+ */
+inline void putUint32(uint8_t *dst, const uint32_t value) {
+    putUint16(dst, static_cast<uint16_t>(value >> 16));
+    putUint16(dst + 2, static_cast<uint16_t>(value));
+}
+
+
+/*********************************************************************************************************//**
+ * @brief Binäres Übertragungsprotokoll zwischen Arduino und PC.
+ *
+ * Nach der Kennung @em XPanino wird immer das Klartextprotokoll verwendet. Mit dem Steuerkommando
+ * @em CTRL;BIN handelt der PC das Binärprotokoll aus; der Arduino bestätigt mit @em CTRL;BIN;OK
+ * (noch im Klartext) und schaltet dann um. Mit dem Kommandocode @em PROTOCOL_ASCII geht es zurück
+ * zum Klartextprotokoll.
+ *
+ * Aufbau eines Frames (vor der COBS-Kodierung):
+ * ```
+ *   | Record 1 | Record 2 | ... | CRC-8 |
+ *   Record: | Kommandocode (2 Bytes, MSB zuerst) | Länge n (1 Byte) | Nutzdaten (n Bytes) |
+ * ```
+ * Mehrbyte-Nutzdaten werden ebenfalls mit dem MSB zuerst übertragen. Der Frame wird COBS-kodiert
+ * und mit @em FRAME_DELIMITER abgeschlossen. Die CRC-8 (Polynom 0x07) läuft über alle Records.
+ *
+ * Empfangene Records werden in Events übersetzt und in die Eventqueue gestellt, so dass die
+ * weitere Verarbeitung wie beim Klartextprotokoll über den Dispatcher läuft.
+ *
+ ************************************************************************************************************/
+class ProtocolClass {
+public:
+    /**
+     * @brief Prüfen, ob das Binärprotokoll aktiv ist.
+     *
+     * @return @em true falls das Binärprotokoll aktiv ist, @em false beim Klartextprotokoll.
+     */
+    inline bool isBinary() const { return mode == ProtocolMode::BINARY; }
+
+
+    /**
+     * @brief Das Übertragungsprotokoll umschalten. Ein evtl. halb empfangener Frame wird verworfen.
+     *
+     * @param newMode Das neue Übertragungsprotokoll.
+     */
+    void setMode(ProtocolMode newMode);
+
+
+    /**
+     * @brief Ein im Binärprotokoll empfangenes Byte verarbeiten.
+     *
+     * Die Bytes werden bis zum @em FRAME_DELIMITER gesammelt. Dann wird der Frame dekodiert,
+     * geprüft und die enthaltenen Records werden verarbeitet.
+     *
+     * @param inByte Das empfangene Byte.
+     */
+    void receiveByte(uint8_t inByte);
+
+
+    /**
+     * @brief Einen neuen, leeren Frame zum Senden beginnen.
+     */
+    inline void beginFrame() { txLength = 0; }
+
+
+    /**
+     * @brief Aktuelle Länge des zu sendenden Frames (noch ohne CRC und COBS-Kodierung).
+     *
+     * @return Anzahl Bytes der bisher angehängten Records.
+     */
+    inline uint8_t getFrameLength() const { return txLength; }
+
+
+    /**
+     * @brief Einen Record an den zu sendenden Frame anhängen.
+     *
+     * @param opcode Kommandocode gem. commands.hpp.
+     * @param payload Die Nutzdaten.
+     * @param length Länge der Nutzdaten.
+     *
+     * @return @em true falls der Record in den Frame passt, sonst @em false.
+     */
+    bool addRecord(uint16_t opcode, const uint8_t *payload, uint8_t length);
+
+
+    /**
+     * @brief Den Frame mit CRC-8 abschließen, COBS-kodieren und senden.
+     */
+    void endFrame();
+
+
+    inline uint16_t getFramesReceived() const { return framesReceived; }   ///< Anzahl fehlerfrei empfangener Frames
+    inline uint16_t getFramesSent() const { return framesSent; }           ///< Anzahl gesendeter Frames
+    inline uint16_t getFrameErrors() const { return frameErrors; }         ///< Anzahl fehlerhaft empfangener Frames
+    inline uint16_t getFramesRefused() const { return framesRefused; }     ///< Anzahl mangels Platz nicht angenommener Frames
+
+
+    /**
+     * @brief CRC-8 (Polynom 0x07, Startwert 0x00) berechnen.
+     *
+     * @param data Die Daten.
+     * @param length Länge der Daten.
+     * @return Die CRC-8 der Daten.
+     */
+    static uint8_t crc8(const uint8_t *data, uint8_t length);
+
+
+    /**
+     * @brief Einen COBS-kodierten Frame an Ort und Stelle dekodieren.
+     *
+     * @param frame Der kodierte Frame ohne @em FRAME_DELIMITER; enthält danach den dekodierten Frame.
+     * @param length Länge des kodierten Frames.
+     * @return Länge des dekodierten Frames oder 0, falls der Frame ungültig ist.
+     */
+    static uint8_t cobsDecode(uint8_t *frame, uint8_t length);
+
+private:
+    ProtocolMode mode = ProtocolMode::ASCII;    ///< Aktives Übertragungsprotokoll
+    uint8_t rxBuffer[FRAME_MAX_LENGTH + 1];     ///< Empfangspuffer für einen kodierten Frame (COBS: + 1 Byte)
+    uint8_t rxLength = 0;                       ///< Anzahl Bytes im Empfangspuffer
+    bool rxOverflow = false;                    ///< @em true ==> der aktuelle Frame ist zu lang und wird verworfen
+    uint8_t txBuffer[FRAME_MAX_LENGTH];         ///< Sendepuffer für einen (noch nicht kodierten) Frame
+    uint8_t txLength = 0;                       ///< Anzahl Bytes im Sendepuffer
+    uint16_t framesReceived = 0;                ///< Anzahl fehlerfrei empfangener Frames
+    uint16_t framesSent = 0;                    ///< Anzahl gesendeter Frames
+    uint16_t frameErrors = 0;                   ///< Anzahl fehlerhaft empfangener Frames
+    uint16_t framesRefused = 0;                 ///< Anzahl mangels Platz nicht angenommener Frames
+
+    void processFrame(const uint8_t *frame, uint8_t length);
+    static bool hasRoomFor(const uint8_t *frame, uint8_t pos, uint8_t length);
+    static bool isMappedOpcode(uint16_t opcode);
+    void processRecord(uint16_t opcode, const uint8_t *payload, uint8_t length);
+};
@@ -0,0 +1,115 @@
+/*********************************************************************************************************//**
+ * @file scheduler.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Implementierung der Klasse @em SchedulerClass.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#include <scheduler.hpp>
+#include <frameclock.hpp>
+
+extern LoopTimingClass loopTiming;
+
+
+/*********************************************************************************************************//**
+ * SchedulerClass - public Methoden
+ *
+ ************************************************************************************************************/
+
+uint8_t SchedulerClass::addTask(const TaskFunction function, const uint16_t period, const uint8_t priority,
+                                const LoopStage stage) {
+    if ((taskCount >= SCHEDULER_MAX_TASKS) || (function == nullptr)) {
+        return TASK_NONE;
+    }
+    const uint8_t taskId = taskCount;
+    tasks[taskId] = {function, period, priority, stage, false, frameClock.getNow(), 0, 0};
+    // In die nach Priorität sortierte Reihenfolge einfügen, hinter Aufgaben gleicher Priorität.
+    uint8_t pos = taskCount;
+    while ((pos > 0) && (tasks[order[pos - 1]].priority > priority)) {
+        order[pos] = order[pos - 1];
+        pos--;
+    }
+    order[pos] = taskId;
+    taskCount++;
+    return taskId;
+}
+
+
+void SchedulerClass::setPeriod(const uint8_t taskId, const uint16_t period) {
+    if (taskId < taskCount) {
+        tasks[taskId].period = period;
+    }
+}
+
+
+void SchedulerClass::runDue() {
+    const unsigned long now = frameClock.getNow();
+    for (uint8_t pos = 0; pos < taskCount; ++pos) {
+        SchedulerTask &task = tasks[order[pos]];
+        if (! isDue(task, now)) {
+            continue;
+        }
+        task.pending = false;   // vor dem Aufruf, damit sich die Aufgabe selbst erneut anfordern kann
+        const unsigned long start = micros();
+        task.function(now);
+        loopTiming.addSample(task.stage, micros() - start);
+    }
+}
+
+
+uint16_t SchedulerClass::getOverruns() const {
+    uint16_t total = 0;
+    for (uint8_t taskId = 0; taskId < taskCount; ++taskId) {
+        total += tasks[taskId].overruns;
+    }
+    return total;
+}
+
+
+uint16_t SchedulerClass::getMaxLateness() const {
+    uint16_t lateness = 0;
+    for (uint8_t taskId = 0; taskId < taskCount; ++taskId) {
+        lateness = max(lateness, tasks[taskId].maxLateness);
+    }
+    return lateness;
+}
+
+
+/*********************************************************************************************************//**
+ * ab hier die privaten Methoden
+*************************************************************************************************************/
+
+/**
+ * @brief Prüfen, ob eine Aufgabe fällig ist, und bei periodischen Aufgaben den nächsten Zeitpunkt planen.
+ *
+ * Der nächste Zeitpunkt wird vom planmäßigen Zeitpunkt aus gerechnet, damit sich Verspätungen nicht
+ * aufsummieren. Ist eine ganze Periode ausgefallen, beginnt der Takt ab jetzt neu.
+ *
+ * @param task Die Aufgabe.
+ * @param now Aktueller Zeitstempel in ms.
+ * @return @em true falls die Aufgabe jetzt ausgeführt werden soll.
+ */
+bool SchedulerClass::isDue(SchedulerTask &task, const unsigned long now) {
+    if (task.period == TASK_EVERY_PASS) {
+        return true;
+    }
+    if ((task.period == TASK_ON_TRIGGER) || (static_cast<long>(now - task.nextDue) < 0)) {
+        return task.pending;
+    }
+    const unsigned long lateness = now - task.nextDue;
+    task.maxLateness = static_cast<uint16_t>(max(static_cast<unsigned long>(task.maxLateness),
+                                                 min(lateness, 0xFFFFUL)));
+    if (lateness >= task.period) {
+        if (task.overruns < 0xFFFF) {
+            task.overruns++;
+        }
+        task.nextDue = now + task.period;
+    } else {
+        task.nextDue += task.period;
+    }
+    return true;
+}
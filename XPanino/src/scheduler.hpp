@@ -0,0 +1,105 @@
+/*********************************************************************************************************//**
+ * @file scheduler.hpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Interface der Klasse @em SchedulerClass: kooperative Ablaufsteuerung des loop().
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+#include <looptiming.hpp>
+
+const uint8_t SCHEDULER_MAX_TASKS = 8;      ///< Max. Anzahl Aufgaben
+const uint8_t TASK_NONE = 0xFF;             ///< Ungültige ID einer Aufgabe
+const uint16_t TASK_EVERY_PASS = 0;         ///< Periode: bei jedem Durchlauf ausführen
+const uint16_t TASK_ON_TRIGGER = 0xFFFF;    ///< Periode: nur nach trigger() ausführen
+
+/// Funktion einer Aufgabe; @em now ist der aktuelle Zeitstempel in Millisekunden.
+using TaskFunction = void (*)(unsigned long now);
+
+
+/*********************************************************************************************************//**
+ * @brief Eine Aufgabe der Ablaufsteuerung.
+ *
+ ************************************************************************************************************/
+class SchedulerTask {
+public:
+    TaskFunction function;  ///< Auszuführende Funktion
+    uint16_t period;        ///< Periode in ms bzw. TASK_EVERY_PASS oder TASK_ON_TRIGGER
+    uint8_t priority;       ///< Priorität: 0 = höchste
+    LoopStage stage;        ///< Abschnitt für die Laufzeitmessung (siehe LoopTimingClass)
+    bool pending;           ///< Mit trigger() angefordert
+    unsigned long nextDue;  ///< Nächster planmäßiger Zeitpunkt in ms
+    uint16_t overruns;      ///< Anzahl ausgefallener Perioden (Start mind. eine Periode zu spät)
+    uint16_t maxLateness;   ///< Größte Verspätung gegenüber dem planmäßigen Zeitpunkt in ms
+};
+
+
+/*********************************************************************************************************//**
+ * @brief Kooperative Ablaufsteuerung: statt jedes Teilsystem bei jedem Durchlauf des loop() aufzurufen,
+ *        werden nur die fälligen Aufgaben ausgeführt.
+ *
+ * Jede Aufgabe hat eine Periode (oder läuft bei jedem Durchlauf bzw. nur auf Anforderung mit trigger())
+ * und eine Priorität. runDue() prüft die Aufgaben in der Reihenfolge ihrer Priorität und führt jede
+ * fällige Aufgabe einmal aus; eine Aufgabe wird nie unterbrochen. Eine periodische Aufgabe, die erst eine
+ * ganze Periode nach ihrem planmäßigen Zeitpunkt zum Zug kommt, zählt als Überschreitung; ihr Takt
+ * beginnt dann neu. Die Laufzeit jeder Ausführung geht an @em loopTiming.
+ *
+ ************************************************************************************************************/
+class SchedulerClass {
+public:
+    /**
+     * @brief Eine Aufgabe anmelden.
+     *
+     * @param function Auszuführende Funktion.
+     * @param period Periode in ms, @em TASK_EVERY_PASS oder @em TASK_ON_TRIGGER.
+     * @param priority Priorität: 0 = höchste; bei gleicher Priorität in der Reihenfolge der Anmeldung.
+     * @param stage Abschnitt für die Laufzeitmessung.
+     * @return ID der Aufgabe bzw. @em TASK_NONE, falls bereits @em SCHEDULER_MAX_TASKS angemeldet sind.
+     */
+    uint8_t addTask(TaskFunction function, uint16_t period, uint8_t priority, LoopStage stage);
+
+
+    /**
+     * @brief Eine Aufgabe beim nächsten Durchlauf ausführen, unabhängig von ihrer Periode.
+     *
+     * @param taskId ID der Aufgabe.
+     */
+    inline void trigger(const uint8_t taskId) {
+        if (taskId < taskCount) {
+            tasks[taskId].pending = true;
+        }
+    }
+
+
+    /**
+     * @brief Die Periode einer Aufgabe ändern; der nächste planmäßige Zeitpunkt bleibt.
+     *
+     * @param taskId ID der Aufgabe.
+     * @param period Periode in ms, @em TASK_EVERY_PASS oder @em TASK_ON_TRIGGER.
+     */
+    void setPeriod(uint8_t taskId, uint16_t period);
+
+
+    /**
+     * @brief Alle fälligen Aufgaben in der Reihenfolge ihrer Priorität ausführen.
+     * @note Diese Methode muss einmal je loop() aufgerufen werden.
+     */
+    void runDue();
+
+
+    uint16_t getOverruns() const;           ///< Summe der Überschreitungen aller Aufgaben
+    uint16_t getMaxLateness() const;        ///< Größte Verspätung aller Aufgaben in ms
+
+private:
+    SchedulerTask tasks[SCHEDULER_MAX_TASKS];   ///< Die angemeldeten Aufgaben in der Reihenfolge der Anmeldung
+    uint8_t order[SCHEDULER_MAX_TASKS];         ///< IDs der Aufgaben, nach Priorität sortiert
+    uint8_t taskCount = 0;                      ///< Anzahl angemeldeter Aufgaben
+
+    bool isDue(SchedulerTask &task, unsigned long now);
+};
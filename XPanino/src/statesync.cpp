@@ -0,0 +1,180 @@
+/*********************************************************************************************************//**
+ * @file statesync.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Implementierung der Klasse @em StateSyncClass.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#include <statesync.hpp>
+#include <devices.hpp>
+#include <txqueue.hpp>
+
+extern LedMatrix leds;
+extern TxQueueClass txQueue;
+
+/// Die Hälfte der Sendewarteschlange bleibt für Schalterereignisse frei.
+const uint8_t STATE_TX_QUEUE_LIMIT = TX_QUEUE_SIZE / 2;
+
+
+/*********************************************************************************************************//**
+ * StateSyncClass - public Methoden
+ *
+ ************************************************************************************************************/
+
+void StateSyncClass::receiveSnapshot(const uint8_t *payload, const uint8_t length, const unsigned long now) {
+    if ((length < 2) || ((length - 2) % STATE_ENTRY_LENGTH != 0)) {
+        rejected++;
+        return;
+    }
+    const uint8_t flags = payload[1];
+    if ((flags & STATE_FLAG_FIRST) != 0) {
+        if (! receiving) {
+            leds.beginUpdate();     // bis zum letzten Record den bisherigen Stand anzeigen
+            receiving = true;
+        }
+        receiveStart = now;
+        for (uint8_t index = 0; index < STATE_WORD_COUNT; ++index) {
+            setWord(index, 0);
+        }
+    } else if (! receiving) {
+        rejected++;     // der Anfang der Momentaufnahme fehlt
+        isVersionPending = true;
+        return;
+    }
+    if (! applyEntries(&payload[2], length - 2)) {
+        abortSnapshot();
+        return;
+    }
+    if ((flags & STATE_FLAG_LAST) != 0) {
+        receiving = false;
+        leds.endUpdate();
+        version = payload[0];
+        isVersionPending = true;    // Bestätigung an den PC
+    }
+}
+
+
+void StateSyncClass::receiveDelta(const uint8_t *payload, const uint8_t length) {
+    if ((length < 2) || ((length - 2) % STATE_ENTRY_LENGTH != 0) || receiving
+        || (version == 0) || (payload[0] != version)) {
+        rejected++;
+        isVersionPending = true;    // der PC muss eine neue Momentaufnahme senden
+        return;
+    }
+    leds.beginUpdate();
+    const bool isApplied = applyEntries(&payload[2], length - 2);
+    leds.endUpdate();
+    if (! isApplied) {
+        rejected++;
+        isVersionPending = true;
+        return;
+    }
+    version = payload[1];
+}
+
+
+void StateSyncClass::requestReport() {
+    pendingWords = 0;
+    for (uint8_t index = 0; index < STATE_WORD_COUNT; ++index) {
+        if (getWord(index) != 0) {
+            pendingWords |= static_cast<uint32_t>(1) << index;
+        }
+    }
+    isVersionPending = true;
+}
+
+
+void StateSyncClass::invalidate() {
+    version = 0;
+    isVersionPending = true;
+}
+
+
+void StateSyncClass::update(const unsigned long now) {
+    if (receiving && (now - receiveStart >= STATE_SYNC_TIMEOUT)) {
+        abortSnapshot();
+    }
+    uint8_t index = 0;
+    while ((pendingWords != 0) && (txQueue.getCount() < STATE_TX_QUEUE_LIMIT)) {
+        if ((pendingWords & (static_cast<uint32_t>(1) << index)) != 0) {
+            pendingWords &= ~(static_cast<uint32_t>(1) << index);
+            txQueue.addMessage({TxMessageType::STATE_WORD, index, version, 0, 0, getWord(index)});
+        }
+        index++;
+    }
+    // Die Version zuletzt: damit ist der Bericht für den PC vollständig.
+    if ((pendingWords == 0) && isVersionPending && (txQueue.getCount() < STATE_TX_QUEUE_LIMIT)) {
+        txQueue.addMessage({TxMessageType::STATE_VERSION, 0, version, 0, 0, 0});
+        isVersionPending = false;
+    }
+}
+
+
+/*********************************************************************************************************//**
+ * ab hier die privaten Methoden
+*************************************************************************************************************/
+
+/**
+ * @brief Einträge aus Index und Wert übernehmen. Zuerst werden alle Indizes geprüft, so dass bei einem
+ *        ungültigen Eintrag nichts übernommen wird.
+ *
+ * @param entries Die Einträge.
+ * @param length Länge aller Einträge in Bytes (Vielfaches von @em STATE_ENTRY_LENGTH).
+ * @return @em true falls alle Einträge gültig waren.
+ */
+bool StateSyncClass::applyEntries(const uint8_t *entries, const uint8_t length) {
+    for (uint8_t pos = 0; pos < length; pos += STATE_ENTRY_LENGTH) {
+        if (entries[pos] >= STATE_WORD_COUNT) {
+            return false;
+        }
+    }
+    for (uint8_t pos = 0; pos < length; pos += STATE_ENTRY_LENGTH) {
+        const uint32_t value = (static_cast<uint32_t>(entries[pos + 1]) << 24)
+                               | (static_cast<uint32_t>(entries[pos + 2]) << 16)
+                               | (static_cast<uint32_t>(entries[pos + 3]) << 8) | entries[pos + 4];
+        setWord(entries[pos], value);
+    }
+    return true;
+}
+
+
+/**
+ * @brief Eine unvollständige oder fehlerhafte Momentaufnahme verwerfen. Der Zustand gilt dann als
+ *        nicht abgeglichen (Version 0), der PC erfährt das über @em STATE_VERSION.
+ */
+void StateSyncClass::abortSnapshot() {
+    if (receiving) {
+        receiving = false;
+        leds.endUpdate();
+    }
+    version = 0;
+    rejected++;
+    isVersionPending = true;
+}
+
+
+/**
+ * @brief Ein Zustandswort lesen: die LED-Matrix bzw. die Modi der Geräte.
+ */
+uint32_t StateSyncClass::getWord(const uint8_t index) {
+    if (index == STATE_WORD_MODES) {
+        return devices.get<ClockDavtronM803>().getModes();
+    }
+    return leds.getStateWord(index);
+}
+
+
+/**
+ * @brief Ein Zustandswort setzen: die LED-Matrix bzw. die Modi der Geräte.
+ */
+void StateSyncClass::setWord(const uint8_t index, const uint32_t value) {
+    if (index == STATE_WORD_MODES) {
+        devices.get<ClockDavtronM803>().setModes(static_cast<uint16_t>(value));
+    } else {
+        leds.setStateWord(index, value);
+    }
+}
@@ -0,0 +1,105 @@
+/*********************************************************************************************************//**
+ * @file statesync.hpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Interface der Klasse @em StateSyncClass: Abgleich des Anzeigezustands mit dem PC.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+#include <ledmatrix.hpp>
+
+const uint8_t STATE_WORD_MODES = LED_STATE_WORDS;           ///< Index des Zustandsworts mit den Modi der Geräte
+const uint8_t STATE_WORD_COUNT = STATE_WORD_MODES + 1;      ///< Anzahl aller Zustandsworte
+const uint8_t STATE_ENTRY_LENGTH = 5;                       ///< Länge eines Eintrags: Index (1 Byte), Wert (4 Bytes)
+const uint16_t STATE_SYNC_TIMEOUT = 500;    ///< Zeit in ms, in der eine Momentaufnahme vollständig ankommen muss
+
+const uint8_t STATE_FLAG_FIRST = 0x01;      ///< Erster Record einer Momentaufnahme
+const uint8_t STATE_FLAG_LAST = 0x02;       ///< Letzter Record einer Momentaufnahme
+
+static_assert(STATE_WORD_COUNT <= 32, "pendingWords hat nur 32 Bits.");
+
+
+/*********************************************************************************************************//**
+ * @brief Abgleich des logischen Anzeigezustands zwischen Arduino und PC (nur Binärprotokoll).
+ *
+ * Der Zustand besteht aus @em STATE_WORD_COUNT Zustandsworten zu je 32 Bits: die LED-Matrix (ein/aus und
+ * Blinken je Zeile, damit auch der Inhalt der Display-Felder) und die Modi der Geräte. Nicht übertragene
+ * Zustandsworte einer Momentaufnahme sind 0, so dass nur die belegten Worte übertragen werden müssen.
+ *
+ * - PC → Arduino: @em STATE_SNAPSHOT mit einer Versionsnummer, verteilt auf einen oder mehrere Records.
+ *   Sie wird erst mit dem letzten Record sichtbar. Danach schickt der PC nur noch Änderungen
+ *   (@em STATE_DELTA) von Version zu Version. Passt die Basisversion einer Änderung nicht, wird sie
+ *   verworfen und der Arduino meldet seine Version mit @em STATE_VERSION; der PC sendet dann eine neue
+ *   Momentaufnahme.
+ * - Arduino → PC: auf @em STATE_QUERY bzw. `CTRL;STAT` werden alle belegten Zustandsworte und
+ *   abschließend die Version gesendet.
+ *
+ * Nach dem Start ist die Version 0, d.h. der Arduino hat noch keinen Zustand vom PC erhalten.
+ *
+ ************************************************************************************************************/
+class StateSyncClass {
+public:
+    /**
+     * @brief Einen Record @em STATE_SNAPSHOT verarbeiten.
+     *
+     * @param payload Version (1 Byte), Flags (1 Byte), dann Einträge aus Index und Wert.
+     * @param length Länge der Nutzdaten.
+     * @param now Aktuelle Zeit in Millisekunden.
+     */
+    void receiveSnapshot(const uint8_t *payload, uint8_t length, unsigned long now);
+
+
+    /**
+     * @brief Einen Record @em STATE_DELTA verarbeiten.
+     *
+     * @param payload Basisversion (1 Byte), neue Version (1 Byte), dann Einträge aus Index und Wert.
+     * @param length Länge der Nutzdaten.
+     */
+    void receiveDelta(const uint8_t *payload, uint8_t length);
+
+
+    /**
+     * @brief Alle belegten Zustandsworte und die Version an den PC senden.
+     */
+    void requestReport();
+
+
+    /**
+     * @brief Der Anzeigezustand wurde lokal verändert (z.B. nach dem Rohdaten-Modus): Version 0 an den
+     *        PC melden, damit er eine neue Momentaufnahme sendet.
+     */
+    void invalidate();
+
+
+    /**
+     * @brief Anstehende Zustandsworte in die Sendewarteschlange stellen und eine unvollständige
+     *        Momentaufnahme nach @em STATE_SYNC_TIMEOUT verwerfen.
+     * @note Diese Methode muss einmal je loop() aufgerufen werden.
+     *
+     * @param now Aktuelle Zeit in Millisekunden.
+     */
+    void update(unsigned long now);
+
+
+    inline uint8_t getVersion() const { return version; }               ///< Aktuelle Version des Zustands
+    inline uint16_t getRejected() const { return rejected; }            ///< Anzahl verworfener Records
+
+private:
+    uint8_t version = 0;            ///< Aktuelle Version des Zustands; 0 = noch nicht abgeglichen
+    bool receiving = false;         ///< Eine Momentaufnahme wird gerade empfangen
+    unsigned long receiveStart = 0; ///< Beginn des Empfangs der Momentaufnahme
+    uint32_t pendingWords = 0;      ///< Je Zustandswort ein Bit: muss noch an den PC gesendet werden
+    bool isVersionPending = false;  ///< Die Version muss noch an den PC gesendet werden
+    uint16_t rejected = 0;          ///< Anzahl verworfener Records
+
+    bool applyEntries(const uint8_t *entries, uint8_t length);
+    void abortSnapshot();
+    static uint32_t getWord(uint8_t index);
+    static void setWord(uint8_t index, uint32_t value);
+};
@@ -8,29 +8,34 @@
  * Copyright © 2017 - 2020 Christian Harraeus. All rights reserved.
 ************************************************************************************************************/
 
-#include <buffer.hpp>
-#include <event.hpp>
 #include <switch.hpp>
+#include <devices.hpp>
+#include <frameclock.hpp>
+#include <txqueue.hpp>
+
+extern TxQueueClass txQueue;
 
 /// @brief Dauer, ab wann ein Schalter lange eingeschaltet ist (3000 Millisekunden)
 const unsigned long LONG_ON = 3000;
 
 
 /// @brief Logischen Schalter auf "eingeschaltet" setzen
-void Switch::setOn() {
+void Switch::setOn(const unsigned long &now) {
     status = LOW;
     changed = true;
-    switchPressTime = millis();     // Einschalt"zeit" merken
+    switchPressTime = now;          // Einschalt"zeit" merken
+    lastChangeTime = switchPressTime;
     longOnSent = false;
     longOn = false;
     onTime = 0;
 }
 
 
-void Switch::setOff() {
+void Switch::setOff(const unsigned long &now) {
     status = HIGH;
     changed = true;
-    onTime = calcTimeDiff(switchPressTime, millis());   // Differenz zwischen Ein- und Ausschalt"zeit" merken
+    lastChangeTime = now;
+    onTime = calcTimeDiff(switchPressTime, lastChangeTime);   // Differenz zwischen Ein- und Ausschalt"zeit" merken
     longOnSent = true;
     longOn = false;
 }
@@ -49,47 +54,42 @@ void Switch::updateOnTime(const unsigned long &newOnTime) {
 }
 
 
-void Switch::transmitStatus(uint8_t &row, uint8_t &col) {
+void Switch::transmitStatus(uint8_t &row, uint8_t &col, const bool withTimestamp, const unsigned long epoch) {
     // switchState = 0: Switch is off
     // switchState = 1: Switch is on
     // switchState = 2: Switch is long on
     uint8_t switchState = 0;
+    unsigned long edgeTime = lastChangeTime;    // Zeitpunkt der Flanke
     if ((! longOnSent) && longOn) {
         // wenn der Schalter lang gedrückt ist und dieser Lang-Gedrückt-Status noch
         // nicht übertragen wurde, den Status "LON" (Long on) übertragen.
         longOnSent = true;
         changed = false;
         switchState = 2;
+        edgeTime = switchPressTime + LONG_ON;   // der Schalter ist seit genau diesem Zeitpunkt "lange an"
     } else {
         // Den An- (1) / Aus- (0) Status des Schalters übertragen.
         switchState = ((getStatus() == LOW) ? 1 : 0);
     }
+    // Flanken vor Sitzungsbeginn (z.B. beim Senden aller Schalter) werden auf den Sitzungsbeginn gelegt.
+    unsigned long timestamp = (static_cast<long>(edgeTime - epoch) > 0) ? (edgeTime - epoch) : 0;
     // Ereignis senden
     // Diese Methode muss überschrieben werden.
-    transmit(row, col, switchState);
+    transmit(row, col, switchState, withTimestamp, timestamp);
 }
 
 
-void Switch::transmit(uint8_t &row, uint8_t &col, uint8_t &switchState) {
+void Switch::transmit(uint8_t &row, uint8_t &col, uint8_t &switchState,
+                      const bool withTimestamp, const unsigned long timestamp) {
     // switchState = 0: Switch is off
     // switchState = 1: Switch is on
     // switchState = 2: Switch is long on
-
-    // c-string with data to be sent (e.g. via the serial port)
-    char charsToSend[MAX_BUFFER_LENGTH] = "S;S;";
-
-    // temp memory for typecast int --> c-string
-    char charRowCol[MAX_PARA_LENGTH * 2] = "";
-
-    // set charsToSend according to value of data
-    if (switchState == 2) {
-        strcat(charsToSend, "LON;");
-    } else {
-        strcat(charsToSend, ((switchState == 1) ? "ON;" : "OFF;"));
+    if (devices.onSwitch(row, col, switchState, frameClock.getNow())) {
+        return;     // das Gerät verarbeitet den Schalter selbst und meldet nur das Ergebnis an den PC
     }
-    snprintf (charRowCol, MAX_PARA_LENGTH * 2, "%u;%u", row, col);
-    strcat(charsToSend, charRowCol);
-    Serial.println(charsToSend);
+    // Die Nachricht wird nur in die Sendewarteschlange gestellt und erst beim nächsten
+    // txQueue.flush() formatiert und gesendet.
+    txQueue.addSwitchEvent(row, col, switchState, withTimestamp, timestamp);
 }
 
 
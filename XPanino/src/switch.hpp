@@ -26,15 +26,19 @@ public:
     /**
      * @brief Setzt den Status des Schalters auf "on" und setzt den Zeitstempel, wann der Schalter
      *        eingeschaltet wurde.
+     *
+     * @param now Aktueller Zeitstempel in Millisekunden, z.B. frameClock.getNow()
      */
-    void setOn();
+    void setOn(const unsigned long &now);
 
 
     /**
      * @brief Setzt den Status des Schalters auf "off" und berechnet die Zeit, wie lange der
      *        Schalter eingeschaltet war.
+     *
+     * @param now Aktueller Zeitstempel in Millisekunden, z.B. frameClock.getNow()
      */
-    void setOff();
+    void setOff(const unsigned long &now);
 
 
     /**
@@ -64,22 +68,37 @@ public:
      * Wenn das Ausgabeformat geändert werden soll, muss eine von der Klasse @em Switch abgeleitete, neue
      * Klasse erstellt werden, und dort die Methode @transmit überschrieben werden.
      *
+     * Optional wird der Zeitpunkt der Flanke relativ zum Beginn der Sitzung (@em epoch) mitgesendet.
+     * Damit kann der PC den genauen Zeitpunkt und die Reihenfolge der Schalterbetätigungen
+     * rekonstruieren, unabhängig davon, wann die Nachricht ankommt.
+     *
      * @see Methode @transmit
+     *
+     * @param row Row of switch in the switch matrix
+     * @param col Column of switch in the switch matrix
+     * @param withTimestamp @em true ==> den Zeitpunkt der Flanke mitsenden.
+     * @param epoch Zeitstempel in Millisekunden des Sitzungsbeginns, z.B. millis()
      */
-    void transmitStatus(uint8_t &row, uint8_t &col);
+    void transmitStatus(uint8_t &row, uint8_t &col, bool withTimestamp = false, unsigned long epoch = 0);
 
 
     /**
      * @brief Physical transmitssion of the data. This method has to be overwritten in every derived class.
      *
+     * Die Nachricht wird in die Sendewarteschlange (@em TxQueueClass) gestellt und dort je nach
+     * Übertragungsprotokoll formatiert und ohne Blockieren gesendet.
+     *
      * @param row Row of switch in the switch matrix
      * @param col Column of switch in the switch matrix
      * @param switchState C-string with the string data to submit:
      *                      switchState = 0: Switch is off
      *                      switchState = 1: Switch is on
      *                      switchState = 2: Switch is long on
+     * @param withTimestamp @em true ==> @em timestamp mitsenden.
+     * @param timestamp Zeitpunkt der Flanke in Millisekunden seit Sitzungsbeginn.
      */
-    void transmit(uint8_t &row, uint8_t &col, uint8_t &switchState);
+    void transmit(uint8_t &row, uint8_t &col, uint8_t &switchState,
+                  bool withTimestamp, unsigned long timestamp);
 
 
     /**
@@ -127,12 +146,27 @@ public:
      */
     uint8_t getStatusNoChange() const { return status; }
 
+
+    /**
+     * @brief Prüfen, ob der Schalter noch prellt, d.h. ob die letzte Statusänderung weniger als
+     *        @em debounceTime Millisekunden zurückliegt.
+     *
+     * @param now Aktueller Zeitstempel in Millisekunden, z.B. millis()
+     * @param debounceTime Zeit in Millisekunden zum Entprellen
+     *
+     * @return @em true wenn eine neue Statusänderung (noch) ignoriert werden muss.
+     */
+    inline bool isBouncing(const unsigned long &now, const unsigned int &debounceTime) const {
+        return calcTimeDiff(lastChangeTime, now) < debounceTime;
+    }
+
 private:
     uint8_t status {HIGH};   ///< Status 0 --> eingeschaltet, Status 1 --> ausgeschaltet
     bool longOn {false};     ///< true => falls Schalter ist länger als 3 Sek\. an
     bool longOnSent {true};  ///< true => Ereignis wurde schon gesetzt und muss nicht nochmal gefeuert werden
     unsigned long switchPressTime {0};  ///< Zeitstempel wann Schalter eingeschaltet wurde
     unsigned long onTime {0};  ///< Dauer wie lange der Schalter eingeschaltet war
+    unsigned long lastChangeTime {0};   ///< Zeitstempel der letzten Statusänderung (ein oder aus)
     bool changed {false};    ///< true => Schalterstatus wurde seit der letzten Änderung nicht abgefragt
     uint8_t history;         ///< notwendig für debounce(); macht evtl. switchPressTime, onTime überflüssig
 
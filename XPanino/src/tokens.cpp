@@ -0,0 +1,64 @@
+/*********************************************************************************************************//**
+ * @file tokens.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Hashtabelle für die Umwandlung der Device- und Event-Strings in numerische IDs.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#include <tokens.hpp>
+
+
+/**
+ * @brief Das bekannte Token ermitteln, das auf dem Platz @em slot der Hashtabelle liegt.
+ *
+ * @return uint8_t Die ID bzw. 0 (= NONE), falls der Platz frei ist.
+ */
+constexpr uint8_t findTokenId(const uint8_t slot, const uint8_t id = 1) {
+    return (id >= TOKEN_COUNT) ? 0 : ((tokenSlot(id) == slot) ? id : findTokenId(slot, id + 1));
+}
+
+
+/**
+ * @brief Ein Platz der Hashtabelle: das dort liegende gepackte Token und seine ID.
+ */
+struct TokenSlot {
+    uint32_t token;     ///< Gepacktes Token zum Vergleich; 0 bei freiem Platz
+    uint8_t id;         ///< ID des Tokens
+};
+
+/// @brief Eintrag der Hashtabelle für den Platz @em slot beim Compilieren erzeugen.
+constexpr TokenSlot makeTokenSlot(const uint8_t slot) {
+    return {packToken(TOKEN_NAMES[findTokenId(slot)]), findTokenId(slot)};
+}
+
+// Die Hashtabelle wird vollständig beim Compilieren berechnet und liegt im Flash.
+#define TOKEN_SLOTS_8(base) makeTokenSlot((base) + 0), makeTokenSlot((base) + 1), \
+                            makeTokenSlot((base) + 2), makeTokenSlot((base) + 3), \
+                            makeTokenSlot((base) + 4), makeTokenSlot((base) + 5), \
+                            makeTokenSlot((base) + 6), makeTokenSlot((base) + 7)
+
+static_assert(TOKEN_TABLE_SIZE == 128, "TOKEN_SLOT_TABLE muss an TOKEN_TABLE_SIZE angepasst werden.");
+const TokenSlot TOKEN_SLOT_TABLE[TOKEN_TABLE_SIZE] PROGMEM = {
+    TOKEN_SLOTS_8(0), TOKEN_SLOTS_8(8), TOKEN_SLOTS_8(16), TOKEN_SLOTS_8(24),
+    TOKEN_SLOTS_8(32), TOKEN_SLOTS_8(40), TOKEN_SLOTS_8(48), TOKEN_SLOTS_8(56),
+    TOKEN_SLOTS_8(64), TOKEN_SLOTS_8(72), TOKEN_SLOTS_8(80), TOKEN_SLOTS_8(88),
+    TOKEN_SLOTS_8(96), TOKEN_SLOTS_8(104), TOKEN_SLOTS_8(112), TOKEN_SLOTS_8(120)
+};
+
+#undef TOKEN_SLOTS_8
+
+
+TokenId internToken(const char *token) {
+    const uint32_t packed = packToken(token);
+    if (packed == 0) {
+        return TokenId::NONE;
+    }
+    TokenSlot slot;
+    memcpy_P(&slot, &TOKEN_SLOT_TABLE[hashToken(packed)], sizeof(slot));
+    // Auf dem Platz kann auch ein anderes (bekanntes) Token liegen; dann ist das Token unbekannt.
+    return (slot.token == packed) ? static_cast<TokenId>(slot.id) : TokenId::NONE;
+}
@@ -0,0 +1,140 @@
+/*********************************************************************************************************//**
+ * @file tokens.hpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Numerische IDs der Devices und Events sowie die perfekte Hashfunktion für deren Ermittlung.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Die Device- und Event-Strings der Kommandostrings (vgl. kommunikation.md) werden beim Parsen einmalig
+ * in eine numerische ID (@em TokenId) umgewandelt. Danach wird nur noch mit den IDs gearbeitet.
+ *
+ * Die Zuordnung String --> ID erfolgt über eine perfekte Hashfunktion, d.h. jedes bekannte Token hat
+ * einen eigenen Platz in der Hashtabelle. Das wird schon beim Compilieren geprüft. Kommt beim Hinzufügen
+ * eines Tokens eine Kollision heraus, muss ein anderer @em TOKEN_HASH_MULTIPLIER gewählt werden.
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+
+const uint8_t TOKEN_HASH_BITS = 7;                      ///< Anzahl Bits des Hashwertes
+const uint8_t TOKEN_TABLE_SIZE = 1 << TOKEN_HASH_BITS;  ///< Anzahl Plätze der Hashtabelle
+const uint32_t TOKEN_HASH_MULTIPLIER = 0x9E37833B;      ///< Multiplikator der Hashfunktion (kollisionsfrei gewählt)
+const uint8_t TOKEN_MAX_LENGTH = 4;                     ///< Max. Länge eines Tokens (ohne '\0')
+
+
+/*********************************************************************************************************//**
+ * @brief IDs aller bekannten Devices (@em DEV_...) und Events (@em EV_...).
+ *
+ * Die Devices stehen am Anfang, damit die Tabelle der Devices im Dispatcher mit der ID indiziert
+ * werden kann. Die Reihenfolge muss mit @em TOKEN_NAMES übereinstimmen.
+ *
+ ************************************************************************************************************/
+enum class TokenId : uint8_t {
+    NONE,           ///< Unbekanntes bzw. leeres Token
+    // Devices
+    DEV_M803, DEV_XPDR, DEV_CTRL,
+    DEV_COM1, DEV_COM2, DEV_NAV1, DEV_NAV2,
+    DEV_PB, DEV_PA1, DEV_PA2, DEV_PM, DEV_PX, DEV_PC1, DEV_PC2,
+    DEV_LED,
+    DEVICE_COUNT,   ///< Ab hier kommen die Events
+    // Events für alle Geräte
+    EV_ON = DEVICE_COUNT, EV_LON, EV_OFF,
+    // Zustandsmeldungen für Transponder und Uhr (werden in der Eventqueue zusammengefasst)
+    EV_CODE, EV_F, EV_TIME, EV_LT, EV_UT, EV_ET, EV_FT, EV_V, EV_Q, EV_A, EV_C,
+    // Steuerkommandos
+    EV_DIAG, EV_SCAN, EV_BRST, EV_RSW, EV_HELO, EV_BIN, EV_TS, EV_BAUD, EV_TEST, EV_HB, EV_STAT, EV_LOG, EV_TRC, EV_PERF,
+    // Sammelaktualisierung der LED-Matrix
+    EV_BAT,
+    COUNT           ///< Anzahl der IDs
+};
+
+const uint8_t DEVICE_TOKEN_COUNT = static_cast<uint8_t>(TokenId::DEVICE_COUNT);  ///< Anzahl der Device-IDs inkl. NONE
+const uint8_t TOKEN_COUNT = static_cast<uint8_t>(TokenId::COUNT);                ///< Anzahl aller IDs inkl. NONE
+
+/// Die Strings zu den IDs in der Reihenfolge von @em TokenId. Werden nur beim Compilieren verwendet.
+constexpr char TOKEN_NAMES[][TOKEN_MAX_LENGTH + 1] = {
+    "",
+    "M803", "XPDR", "CTRL",
+    "COM1", "COM2", "NAV1", "NAV2",
+    "PB", "PA1", "PA2", "PM", "PX", "PC1", "PC2",
+    "LED",
+    "ON", "LON", "OFF",
+    "CODE", "F", "TIME", "LT", "UT", "ET", "FT", "V", "Q", "A", "C",
+    "DIAG", "SCAN", "BRST", "RSW", "HELO", "BIN", "TS", "BAUD", "TEST", "HB", "STAT", "LOG", "TRC", "PERF",
+    "BAT"
+};
+
+
+/**
+ * @brief Ein Token (max. 4 Zeichen) in einen uint32_t packen; das erste Zeichen steht im höchsten Byte.
+ *
+ * @param token Das Token.
+ * @param index Position des nächsten Zeichens (nur für die Rekursion).
+ * @param packed Bisher gepackte Zeichen (nur für die Rekursion).
+ * @return uint32_t Das gepackte Token.
+ */
+constexpr uint32_t packToken(const char *token, const uint8_t index = 0, const uint32_t packed = 0) {
+    return ((index == TOKEN_MAX_LENGTH) || (token[index] == '\0'))
+        ? packed
+        : packToken(token, index + 1, (packed << 8) | static_cast<uint8_t>(token[index]));
+}
+
+
+/**
+ * @brief Hashwert (= Platz in der Hashtabelle) eines gepackten Tokens (multiplikatives Hashing).
+ */
+constexpr uint8_t hashToken(const uint32_t packed) {
+    return static_cast<uint8_t>(static_cast<uint32_t>(packed * TOKEN_HASH_MULTIPLIER) >> (32 - TOKEN_HASH_BITS));
+}
+
+
+/// @brief Platz eines bekannten Tokens in der Hashtabelle.
+constexpr uint8_t tokenSlot(const uint8_t id) { return hashToken(packToken(TOKEN_NAMES[id])); }
+
+
+/// @brief Prüfen, ob das Token @em id mit keinem der Tokens ab @em other kollidiert.
+constexpr bool isUniqueSlot(const uint8_t id, const uint8_t other) {
+    return (other >= TOKEN_COUNT) || ((tokenSlot(id) != tokenSlot(other)) && isUniqueSlot(id, other + 1));
+}
+
+
+/// @brief Prüfen, ob die Hashfunktion für alle bekannten Tokens kollisionsfrei (perfekt) ist.
+constexpr bool isPerfectHash(const uint8_t id = 1) {
+    return (id >= TOKEN_COUNT) || (isUniqueSlot(id, id + 1) && isPerfectHash(id + 1));
+}
+
+
+static_assert(sizeof(TOKEN_NAMES) / sizeof(TOKEN_NAMES[0]) == TOKEN_COUNT, "TOKEN_NAMES passt nicht zu TokenId.");
+static_assert(isPerfectHash(), "Hashkollision: anderen TOKEN_HASH_MULTIPLIER wählen.");
+
+
+/**
+ * @brief Einen Device- oder Event-String in die zugehörige ID umwandeln.
+ *
+ * Der Aufwand ist unabhängig von der Anzahl der bekannten Tokens.
+ *
+ * @param token Der String (in Großbuchstaben).
+ * @return TokenId Die ID bzw. @em TokenId::NONE, falls das Token unbekannt ist.
+ */
+TokenId internToken(const char *token);
+
+
+/// @brief Prüfen, ob die ID ein Device bezeichnet.
+inline bool isDeviceToken(const TokenId id) {
+    return (id != TokenId::NONE) && (static_cast<uint8_t>(id) < DEVICE_TOKEN_COUNT);
+}
+
+
+/**
+ * @brief Prüfen, ob die Event-ID eine Zustandsmeldung bezeichnet.
+ *
+ * Bei einer Zustandsmeldung (z.B. Uhrzeit, OAT, QNH, Flightlevel) zählt nur der neueste Wert. Alle anderen
+ * Events sind Aktionen, die vollständig und in der richtigen Reihenfolge abgearbeitet werden müssen.
+ */
+inline bool isStateToken(const TokenId id) {
+    return (id >= TokenId::EV_CODE) && (id <= TokenId::EV_C);
+}
@@ -0,0 +1,51 @@
+/*********************************************************************************************************//**
+ * @file trace.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Implementierung der Klasse @em TraceClass.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#include <trace.hpp>
+#include <txqueue.hpp>
+
+extern TxQueueClass txQueue;
+
+
+/*********************************************************************************************************//**
+ * TraceClass - public Methoden
+ *
+ ************************************************************************************************************/
+
+void TraceClass::start() {
+    head = 0;
+    count = 0;
+    overwritten = 0;
+    dumpRemaining = 0;
+    isDumpEndPending = false;
+    recording = (TRACE_BUFFER_SIZE > 0);
+}
+
+
+void TraceClass::requestDump() {
+    recording = false;
+    dumpRemaining = count;
+    isDumpEndPending = true;
+}
+
+
+void TraceClass::update() {
+    while ((dumpRemaining > 0) && (txQueue.getCount() < TX_REPORT_LIMIT)) {
+        const TraceEntry &entry = entries[(head - dumpRemaining) & (TRACE_STORAGE_SIZE - 1)];
+        txQueue.addMessage({TxMessageType::TRACE, static_cast<uint8_t>(entry.point), entry.arg, 0, 0, entry.time});
+        dumpRemaining--;
+    }
+    if ((dumpRemaining == 0) && isDumpEndPending && (txQueue.getCount() < TX_REPORT_LIMIT)) {
+        txQueue.addMessage({TxMessageType::TRACE, static_cast<uint8_t>(TracePoint::DUMP_END), overwritten, 0, 0,
+                            static_cast<uint16_t>(micros() >> 2)});
+        isDumpEndPending = false;
+    }
+}
@@ -0,0 +1,148 @@
+/*********************************************************************************************************//**
+ * @file trace.hpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Interface der Klasse @em TraceClass: Ablaufprotokoll des loop() im RAM.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+
+/// Anzahl Einträge im Ringpuffer (Zweierpotenz, max. 128); 0 = Trace-Punkte werden nicht übersetzt.
+#ifndef TRACE_BUFFER_SIZE
+    #define TRACE_BUFFER_SIZE 32
+#endif
+
+static_assert((TRACE_BUFFER_SIZE & (TRACE_BUFFER_SIZE - 1)) == 0, "TRACE_BUFFER_SIZE muss eine Zweierpotenz sein.");
+static_assert(TRACE_BUFFER_SIZE <= 128, "TRACE_BUFFER_SIZE ist zu groß für den Index.");
+
+/// Größe des Arrays: auch ohne Trace-Punkte mindestens ein Eintrag, damit die Klasse übersetzbar bleibt.
+const uint8_t TRACE_STORAGE_SIZE = (TRACE_BUFFER_SIZE > 0) ? TRACE_BUFFER_SIZE : 1;
+
+
+/*********************************************************************************************************//**
+ * @brief Die Trace-Punkte. Die Werte werden mit übertragen, daher neue Punkte nur am Ende anhängen
+ *        (siehe tools/trace2json.py).
+ *
+ ************************************************************************************************************/
+enum class TracePoint : uint8_t {
+    LOOP,           ///< Beginn eines loop()-Durchlaufs
+    SCAN_START,     ///< Beginn der Abfrage der Schaltermatrix
+    SCAN_END,       ///< Ende der Abfrage; Argument: 1 = planmäßige Abfrage durchgeführt
+    PARSE,          ///< Kommando bzw. Frame vom PC empfangen; Argument: Event-ID bzw. Länge des Frames
+    DISPATCH_START, ///< Beginn der Abarbeitung der Eventqueue; Argument: Anzahl Events
+    DISPATCH_END,   ///< Ende der Abarbeitung der Eventqueue
+    TX_DEPTH,       ///< Füllstand der Sendewarteschlange vor dem Senden
+    REFRESH_START,  ///< Beginn des Refreshs der LED-Matrix
+    REFRESH_END,    ///< Ende des Refreshs der LED-Matrix
+    OVERFLOW,       ///< Warteschlange voll; Argument: 0 = Eventqueue, 1 = Sendewarteschlange
+    DUMP_END        ///< Nur beim Auslesen: Ende des Mitschnitts; Argument: Anzahl überschriebener Einträge (max. 255)
+};
+
+
+/**
+ * @brief Einen Trace-Punkt aufzeichnen, falls der Mitschnitt läuft.
+ *
+ * @param point Name des Trace-Punkts (ohne TracePoint::).
+ * @param arg Argument (uint8_t).
+ */
+#if TRACE_BUFFER_SIZE > 0
+    #define TRACE(point, arg) trace.record(TracePoint::point, static_cast<uint8_t>(arg))
+#else
+    #define TRACE(point, arg) do { } while (false)
+#endif
+
+
+/*********************************************************************************************************//**
+ * @brief Ein Eintrag im Ringpuffer (4 Bytes).
+ *
+ ************************************************************************************************************/
+class TraceEntry {
+public:
+    uint16_t time;      ///< Zeitpunkt in Einheiten von 4 µs (= Auflösung von micros() bei 16 MHz), läuft nach 262 ms über
+    TracePoint point;   ///< Trace-Punkt
+    uint8_t arg;        ///< Argument des Trace-Punkts
+};
+
+
+/*********************************************************************************************************//**
+ * @brief Ablaufprotokoll im RAM: die letzten @em TRACE_BUFFER_SIZE Trace-Punkte mit Zeitstempel.
+ *
+ * Mit `CTRL;TRC;1` beginnt ein neuer Mitschnitt, `CTRL;TRC;0` hält ihn an. `CTRL;TRC;D` hält ihn ebenfalls
+ * an und sendet alle Einträge vom ältesten zum neuesten über die Sendewarteschlange an den PC, im
+ * Binärprotokoll als Records @em TRACE_ENTRY, im Klartextprotokoll als `T;<Punkt>;<Argument>;<Zeit hex>`.
+ * Den Abschluss bildet der Eintrag @em DUMP_END. tools/trace2json.py wandelt den Mitschnitt in das
+ * JSON-Format von Chrome-Tracing bzw. Perfetto um.
+ *
+ * Ein Trace-Punkt kostet ohne laufenden Mitschnitt nur die Abfrage von @em recording, sonst
+ * zusätzlich micros() und das Schreiben von 4 Bytes. Mit TRACE_BUFFER_SIZE = 0 entfallen die Trace-Punkte.
+ *
+ ************************************************************************************************************/
+class TraceClass {
+public:
+    /**
+     * @brief Einen Trace-Punkt aufzeichnen. Ist der Puffer voll, wird der älteste Eintrag überschrieben.
+     * @note Nicht direkt aufrufen, sondern über das Makro TRACE().
+     *
+     * @param point Trace-Punkt.
+     * @param arg Argument.
+     */
+    inline void record(const TracePoint point, const uint8_t arg) {
+        if (recording) {
+            TraceEntry &entry = entries[head & (TRACE_STORAGE_SIZE - 1)];
+            entry.time = static_cast<uint16_t>(micros() >> 2);
+            entry.point = point;
+            entry.arg = arg;
+            head++;
+            if (count < TRACE_STORAGE_SIZE) {
+                count++;
+            } else if (overwritten < 0xFF) {
+                overwritten++;
+            }
+        }
+    }
+
+
+    /**
+     * @brief Einen neuen Mitschnitt beginnen; ein laufendes Auslesen wird abgebrochen.
+     */
+    void start();
+
+
+    /**
+     * @brief Den Mitschnitt anhalten. Die Einträge bleiben bis zum nächsten start() erhalten.
+     */
+    inline void stop() { recording = false; }
+
+
+    /**
+     * @brief Den Mitschnitt anhalten und alle Einträge an den PC senden.
+     */
+    void requestDump();
+
+
+    /**
+     * @brief Anstehende Einträge des Mitschnitts in die Sendewarteschlange stellen.
+     * @note Diese Methode muss einmal je loop() aufgerufen werden.
+     */
+    void update();
+
+
+    inline bool isRecording() const { return recording; }              ///< Läuft ein Mitschnitt?
+
+private:
+    TraceEntry entries[TRACE_STORAGE_SIZE];     ///< Ringpuffer
+    uint8_t head = 0;               ///< Position des nächsten Eintrags (nur die unteren Bits werden verwendet)
+    uint8_t count = 0;              ///< Anzahl gültiger Einträge
+    uint8_t overwritten = 0;        ///< Anzahl überschriebener Einträge (max. 255)
+    bool recording = false;         ///< Der Mitschnitt läuft
+    uint8_t dumpRemaining = 0;      ///< Noch zu sendende Einträge
+    bool isDumpEndPending = false;  ///< Der Abschluss des Mitschnitts muss noch gesendet werden
+};
+
+extern TraceClass trace;
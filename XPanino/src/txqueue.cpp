@@ -0,0 +1,402 @@
+/*********************************************************************************************************//**
+ * @file txqueue.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Implementierung der Klasse @em TxQueueClass.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#include <txqueue.hpp>
+#include <diagnostics.hpp>
+#include <frameclock.hpp>
+#include <link.hpp>
+#include <linkspeed.hpp>
+#include <looptiming.hpp>
+#include <protocol.hpp>
+#include <trace.hpp>
+#include <xpdr.hpp>
+
+extern LinkClass linkLayer;
+extern LinkSpeedClass linkSpeed;
+extern LoopTimingClass loopTiming;
+extern ProtocolClass protocol;
+
+/// Max. Nutzdaten eines Records, den die Sendewarteschlange erzeugt (LOOP_STATS)
+const uint8_t TX_PAYLOAD_LENGTH = LOOP_STATS_LENGTH;
+static_assert(TX_PAYLOAD_LENGTH >= 8, "Der Puffer für die Nutzdaten ist zu klein.");
+
+
+/*********************************************************************************************************//**
+ * TxQueueClass - public Methoden
+ *
+ ************************************************************************************************************/
+
+bool TxQueueClass::addSwitchEvent(const uint8_t row, const uint8_t col, const uint8_t switchState,
+                                  const bool withTimestamp, const uint32_t timestamp) {
+    TxMessage message {TxMessageType::SWITCH_EVENT, row, col,
+                       static_cast<uint8_t>(withTimestamp ? (switchState | TX_WITH_TIMESTAMP) : switchState),
+                       0, timestamp};
+    return addTracked(message);
+}
+
+
+bool TxQueueClass::canAddSwitchEvent() const {
+    return (! isFull()) && ((! protocol.isBinary()) || linkLayer.hasWindowSpace());
+}
+
+
+bool TxQueueClass::addSnapshot(const uint8_t *rowBits, const uint8_t rows) {
+    uint32_t value = 0;
+    for (uint8_t row = 0; row < rows; ++row) {
+        value = (value << 8) | rowBits[row];
+    }
+    return addMessage({TxMessageType::SNAPSHOT, rows, 0, 0, 0, value});
+}
+
+
+bool TxQueueClass::addTimeSync(const uint32_t time) {
+    return addMessage({TxMessageType::TIME_SYNC, 0, 0, 0, 0, time});
+}
+
+
+bool TxQueueClass::addXpdrReport(const uint8_t item, const uint16_t value) {
+    TxMessage message {TxMessageType::XPDR_REPORT, item, 0, 0, 0, value};
+    return addTracked(message);
+}
+
+
+bool TxQueueClass::addMessage(const TxMessage &message) {
+    if (isFull()) {
+        dropped++;
+        TRACE(OVERFLOW, 1);
+        return false;
+    }
+    messages[(head + count) % TX_QUEUE_SIZE] = message;
+    count++;
+    highWater = max(highWater, count);
+    return true;
+}
+
+
+bool TxQueueClass::addReply(const TxReply reply, const uint16_t value) {
+    if (protocol.isBinary()) {
+        return false;   // Klartext hat im COBS-Datenstrom nichts verloren
+    }
+    return addMessage({TxMessageType::REPLY, static_cast<uint8_t>(reply), 0, 0, 0, value});
+}
+
+
+void TxQueueClass::flush() {
+    if (linkSpeed.isSwitching()) {
+        return;     // erst muss die Bestätigung mit der alten Baudrate vollständig gesendet sein
+    }
+    if ((count == 0) && ! linkLayer.isAckPending()) {
+        return;
+    }
+    if (protocol.isBinary()) {
+        flushBinary();
+    } else {
+        flushAscii();
+    }
+}
+
+
+/*********************************************************************************************************//**
+ * ab hier die privaten Methoden
+*************************************************************************************************************/
+
+/**
+ * @brief Eine Nachricht gesichert in die Warteschlange stellen: im Binärprotokoll erhält sie eine Folgenummer
+ *        und bleibt bis zur Bestätigung durch den PC im Sendefenster.
+ *
+ * @param message Die Nachricht; @em seq wird gesetzt.
+ * @return @em true falls die Nachricht aufgenommen wurde, @em false falls Warteschlange oder Sendefenster voll sind.
+ */
+bool TxQueueClass::addTracked(TxMessage &message) {
+    if (! canAddSwitchEvent()) {
+        dropped++;
+        TRACE(OVERFLOW, 1);
+        return false;
+    }
+    if (protocol.isBinary()) {
+        linkLayer.track(message, frameClock.getNow());  // bis zur Bestätigung durch den PC im Sendefenster halten
+    }
+    return addMessage(message);
+}
+
+
+/**
+ * @brief Klartextprotokoll: die anstehenden Nachrichten zeilenweise sammeln und mit einem
+ *        einzigen Schreibvorgang senden, soweit sie in den freien Sendepuffer passen.
+ *
+ * Nach den Antworten @em TxReply::BIN_OK und @em TxReply::BAUD wird nicht weiter gesammelt: alles Weitere
+ * gilt erst im Binärprotokoll bzw. mit der neuen Baudrate.
+ */
+void TxQueueClass::flushAscii() {
+    char staging[TX_STAGING_LENGTH];
+    uint8_t length = 0;
+    const uint8_t space = static_cast<uint8_t>(min(Serial.availableForWrite(), static_cast<int>(TX_STAGING_LENGTH)));
+    bool isBinaryRequested = false;
+    bool isBaudSwitchRequested = false;
+    while ((count > 0) && ! isBinaryRequested && ! isBaudSwitchRequested) {
+        const TxMessage &message = messages[head];
+        const uint8_t lineLength = formatAscii(message, &staging[length], space - length);
+        if (lineLength == 0) {
+            break;  // passt nicht mehr; Rest im nächsten loop()
+        }
+        if (message.type == TxMessageType::REPLY) {
+            isBinaryRequested = (message.row == static_cast<uint8_t>(TxReply::BIN_OK));
+            isBaudSwitchRequested = (message.row == static_cast<uint8_t>(TxReply::BAUD));
+        }
+        length += lineLength;
+        head = (head + 1) % TX_QUEUE_SIZE;
+        count--;
+    }
+    if (length > 0) {
+        Serial.write(reinterpret_cast<const uint8_t *>(staging), length);
+    }
+    if (isBinaryRequested) {
+        protocol.setMode(ProtocolMode::BINARY);
+    }
+    if (isBaudSwitchRequested) {
+        linkSpeed.onReplySent();
+    }
+}
+
+
+/**
+ * @brief Binärprotokoll: die anstehenden Nachrichten als Records in einem einzigen Frame senden,
+ *        soweit der kodierte Frame in den freien Sendepuffer passt.
+ */
+void TxQueueClass::flushBinary() {
+    // Kodierter Frame = Records + CRC + COBS-Kopfbyte + Trennzeichen
+    const uint8_t FRAME_OVERHEAD = 3;
+    int space = Serial.availableForWrite();
+    uint8_t payload[TX_PAYLOAD_LENGTH];
+    uint8_t payloadLength = 0;
+    uint16_t opcode = 0;
+
+    protocol.beginFrame();
+    if (linkLayer.isAckPending() && (RECORD_HEADER_LENGTH + 1 + FRAME_OVERHEAD <= space)) {
+        // Bestätigung an den PC immer als erstes im Frame mitsenden
+        linkLayer.takeAck(payload[0]);
+        protocol.addRecord(ACK, payload, 1);
+    }
+    while (count > 0) {
+        const TxMessage &message = messages[head];
+        if ((message.type == TxMessageType::LOOP_HISTOGRAM) || (message.type == TxMessageType::REPLY)) {
+            // kein eigener Record: das Histogramm steckt in LOOP_STATS, Antworten gibt es nur im Klartext
+            head = (head + 1) % TX_QUEUE_SIZE;
+            count--;
+            continue;
+        }
+        switch (message.type) {
+            case TxMessageType::SWITCH_EVENT: {
+                const uint16_t opcodes[] = {SWITCH_OFF, SWITCH_ON, SWITCH_LON};
+                opcode = opcodes[message.state & ~TX_WITH_TIMESTAMP];
+                payload[0] = message.seq;
+                payload[1] = message.row;
+                payload[2] = message.col;
+                putUint32(&payload[3], message.value);
+                payloadLength = ((message.state & TX_WITH_TIMESTAMP) != 0) ? 7 : 3;
+                break;
+            }
+            case TxMessageType::SNAPSHOT: {
+                opcode = SWITCH_SNAPSHOT;
+                putUint32(payload, message.value << (8 * (4 - message.row)));
+                payloadLength = message.row;
+                break;
+            }
+            case TxMessageType::STATE_WORD: {
+                opcode = STATE_REPORT;
+                payload[0] = message.col;
+                payload[1] = message.row;
+                putUint32(&payload[2], message.value);
+                payloadLength = 6;
+                break;
+            }
+            case TxMessageType::STATE_VERSION: {
+                opcode = STATE_VERSION;
+                payload[0] = message.col;
+                payloadLength = 1;
+                break;
+            }
+            case TxMessageType::LOG: {
+                opcode = LOG_MESSAGE;
+                payload[0] = message.row;
+                putUint32(&payload[1], message.value);
+                payloadLength = 5;
+                break;
+            }
+            case TxMessageType::TRACE: {
+                opcode = TRACE_ENTRY;
+                payload[0] = message.row;
+                payload[1] = message.col;
+                putUint16(&payload[2], static_cast<uint16_t>(message.value));
+                payloadLength = 4;
+                break;
+            }
+            case TxMessageType::XPDR_REPORT: {
+                // Folgenummer, dann je nach XpdrReport: Code (uint16_t), Betriebsmodus (uint8_t), IDT ohne Nutzdaten
+                const uint16_t opcodes[] = {XPDR_SET_CODE, XPDR_SET_MODE, XPDR_IDENT};
+                const uint8_t lengths[] = {3, 2, 1};
+                opcode = opcodes[message.row];
+                payloadLength = lengths[message.row];
+                payload[0] = message.seq;
+                if (payloadLength == 3) {
+                    putUint16(&payload[1], static_cast<uint16_t>(message.value));
+                } else {
+                    payload[1] = static_cast<uint8_t>(message.value);
+                }
+                break;
+            }
+            case TxMessageType::DIAG_VALUE: {
+                // Name (4 Zeichen, ggf. mit Nullen aufgefüllt) und Wert
+                char name[DIAG_NAME_LENGTH + 1];
+                DiagnosticsClass::getName(message.row, name);
+                memset(payload, 0, DIAG_NAME_LENGTH);
+                memcpy(payload, name, strlen(name));
+                putUint32(&payload[DIAG_NAME_LENGTH], message.value);
+                payloadLength = DIAG_NAME_LENGTH + 4;
+                break;
+            }
+            case TxMessageType::LOOP_STATS: {
+                // Abschnitt, Min, Mittel, Max, Budget, Überschreitungen und Histogramm
+                const LoopStage stage = static_cast<LoopStage>(message.row);
+                const LoopStageStats &stats = loopTiming.getStats(stage);
+                opcode = LOOP_STATS;
+                payload[0] = message.row;
+                putUint16(&payload[1], loopTiming.getMinimum(stage));
+                putUint16(&payload[3], loopTiming.getAverage(stage));
+                putUint16(&payload[5], stats.max);
+                putUint16(&payload[7], stats.budget);
+                putUint16(&payload[9], stats.overruns);
+                for (uint8_t bucket = 0; bucket < LOOP_HISTOGRAM_BUCKETS; ++bucket) {
+                    putUint16(&payload[11 + 2 * bucket], stats.histogram[bucket]);
+                }
+                payloadLength = LOOP_STATS_LENGTH;
+                break;
+            }
+            default: {
+                opcode = TIME_SYNC;
+                putUint32(payload, message.value);
+                payloadLength = 4;
+            }
+        }
+        if (protocol.getFrameLength() + RECORD_HEADER_LENGTH + payloadLength + FRAME_OVERHEAD > space) {
+            break;  // passt nicht mehr; Rest im nächsten loop()
+        }
+        if (! protocol.addRecord(opcode, payload, payloadLength)) {
+            break;  // Frame ist voll
+        }
+        head = (head + 1) % TX_QUEUE_SIZE;
+        count--;
+    }
+    protocol.endFrame();
+}
+
+
+/**
+ * @brief Eine Nachricht im Klartextprotokoll formatieren, z.B. @em S;S;ON;2;3 oder @em S;M;00040000.
+ *
+ * Die Zeile wird direkt in den Zielpuffer geschrieben; passt sie nicht, bleibt der Rest des Zielpuffers
+ * ungenutzt.
+ *
+ * @param message Die Nachricht.
+ * @param line Zielpuffer.
+ * @param size Größe des Zielpuffers.
+ * @return Länge der formatierten Zeile inkl. "\r\n" oder 0, falls der Zielpuffer zu klein ist.
+ */
+uint8_t TxQueueClass::formatAscii(const TxMessage &message, char *line, const uint8_t size) {
+    int length = 0;
+    switch (message.type) {
+        case TxMessageType::SWITCH_EVENT: {
+            const char *states[] = {"OFF", "ON", "LON"};
+            length = snprintf(line, size, "S;S;%s;%u;%u",
+                              states[message.state & ~TX_WITH_TIMESTAMP], message.row, message.col);
+            if (((message.state & TX_WITH_TIMESTAMP) != 0) && (length >= 0) && (length < size)) {
+                // Zeitstempel hexadezimal, um die Nachricht kurz zu halten
+                length += snprintf(&line[length], size - length, ";%lX", static_cast<unsigned long>(message.value));
+            }
+            break;
+        }
+        case TxMessageType::SNAPSHOT: {
+            // führende Nullen, damit jede Zeile genau zwei Hex-Ziffern hat
+            length = snprintf(line, size, "S;M;%0*lX", 2 * message.row, static_cast<unsigned long>(message.value));
+            break;
+        }
+        case TxMessageType::STATE_WORD: {
+            length = snprintf(line, size, "Z;W;%u;%lX", message.row, static_cast<unsigned long>(message.value));
+            break;
+        }
+        case TxMessageType::STATE_VERSION: {
+            length = snprintf(line, size, "Z;V;%u", message.col);
+            break;
+        }
+        case TxMessageType::LOG: {
+            length = snprintf(line, size, "L;%u;%X;%X", message.row,
+                              static_cast<uint16_t>(message.value >> 16), static_cast<uint16_t>(message.value));
+            break;
+        }
+        case TxMessageType::TRACE: {
+            length = snprintf(line, size, "T;%u;%u;%X", message.row, message.col, static_cast<uint16_t>(message.value));
+            break;
+        }
+        case TxMessageType::XPDR_REPORT: {
+            const char *modes[] = {"OFF", "SBY", "TST", "ON", "ALT"};   // Reihenfolge von XpdrMode
+            if (message.row == static_cast<uint8_t>(XpdrReport::CODE)) {
+                length = snprintf(line, size, "X;CODE;%04u", static_cast<uint16_t>(message.value));
+            } else if (message.row == static_cast<uint8_t>(XpdrReport::MODE)) {
+                length = snprintf(line, size, "X;MODE;%s", modes[message.value]);
+            } else {
+                length = snprintf(line, size, "X;IDT");
+            }
+            break;
+        }
+        case TxMessageType::DIAG_VALUE: {
+            char name[DIAG_NAME_LENGTH + 1];
+            DiagnosticsClass::getName(message.row, name);
+            length = snprintf(line, size, "D;%s;%lu", name, static_cast<unsigned long>(message.value));
+            break;
+        }
+        case TxMessageType::LOOP_STATS: {
+            const LoopStage stage = static_cast<LoopStage>(message.row);
+            const LoopStageStats &stats = loopTiming.getStats(stage);
+            length = snprintf(line, size, "P;%u;%u;%u;%u;%u;%u", message.row, loopTiming.getMinimum(stage),
+                              loopTiming.getAverage(stage), stats.max, stats.budget, stats.overruns);
+            break;
+        }
+        case TxMessageType::LOOP_HISTOGRAM: {
+            const LoopStageStats &stats = loopTiming.getStats(static_cast<LoopStage>(message.row));
+            length = snprintf(line, size, "H;%u", message.row);
+            for (uint8_t bucket = 0; (bucket < LOOP_HISTOGRAM_BUCKETS) && (length >= 0) && (length < size); ++bucket) {
+                length += snprintf(&line[length], size - length, ";%u", stats.histogram[bucket]);
+            }
+            break;
+        }
+        case TxMessageType::REPLY: {
+            switch (static_cast<TxReply>(message.row)) {
+                case TxReply::HELLO:     length = snprintf(line, size, "XPanino"); break;
+                case TxReply::BIN_OK:    length = snprintf(line, size, "CTRL;BIN;OK"); break;
+                case TxReply::ASC_OK:    length = snprintf(line, size, "CTRL;ASC;OK"); break;
+                case TxReply::BAUD:      length = snprintf(line, size, "CTRL;BAUD;%u", static_cast<uint16_t>(message.value)); break;
+                case TxReply::BAUD_OK:   length = snprintf(line, size, "CTRL;BAUD;OK"); break;
+                case TxReply::BAUD_FAIL: length = snprintf(line, size, "CTRL;BAUD;FAIL"); break;
+                default:                 length = snprintf(line, size, "CTRL;TEST;%s", LINK_SPEED_TEST_PATTERN);
+            }
+            break;
+        }
+        default: {
+            length = snprintf(line, size, "S;T;%lX", static_cast<unsigned long>(message.value));
+        }
+    }
+    if ((length < 0) || (length + 2 > size)) {
+        return 0;
+    }
+    line[length] = '\r';
+    line[length + 1] = '\n';
+    return static_cast<uint8_t>(length + 2);
+}
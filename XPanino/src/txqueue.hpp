@@ -0,0 +1,193 @@
+/*********************************************************************************************************//**
+ * @file txqueue.hpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Interface der Klasse @em TxQueueClass: nicht blockierende Sendewarteschlange.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ ************************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+
+const uint8_t TX_QUEUE_SIZE = 8;            ///< Anzahl Nachrichten, die die Sendewarteschlange aufnehmen kann
+const uint8_t TX_STAGING_LENGTH = 64;       ///< Max. Anzahl Bytes, die je loop() im Klartextprotokoll gesendet werden
+const uint8_t TX_REPORT_LIMIT = TX_QUEUE_SIZE / 2;  ///< Berichte (Diagnose, Laufzeiten, Ablaufprotokoll) lassen die andere Hälfte frei
+
+
+/*********************************************************************************************************//**
+ * @brief Aufzählungstyp für die Arten von Nachrichten an den PC.
+ *
+ ************************************************************************************************************/
+enum class TxMessageType : uint8_t {
+    SWITCH_EVENT,   ///< Schalterereignis: row, col, Status und ggf. Zeitstempel
+    SNAPSHOT,       ///< Momentaufnahme aller Schalter: ein Byte je Matrixzeile
+    TIME_SYNC,      ///< Zeitsynchronisation: Millisekunden seit Sitzungsbeginn
+    STATE_WORD,     ///< Zustandswort für den Abgleich mit dem PC: Index, Version, Wert (siehe StateSyncClass)
+    STATE_VERSION,  ///< Aktuelle Version des Zustands
+    LOG,            ///< Log-Meldung: ID und zwei Argumente (siehe LoggerClass)
+    TRACE,          ///< Eintrag des Ablaufprotokolls: Trace-Punkt, Argument, Zeit (siehe TraceClass)
+    XPDR_REPORT,    ///< Ergebnis am Transponder: Art (siehe XpdrReport) und Wert
+    DIAG_VALUE,     ///< Diagnosewert: Position (siehe DiagnosticsClass) und Wert
+    LOOP_STATS,     ///< Laufzeiten eines Abschnitts des loop(); die Werte werden erst beim Senden gelesen
+    LOOP_HISTOGRAM, ///< Histogramm eines Abschnitts; nur im Klartextprotokoll, binär ist es Teil von LOOP_STATS
+    REPLY           ///< Antwort auf ein Steuerkommando, nur im Klartextprotokoll: Art (siehe TxReply) und Wert
+};
+
+
+/*********************************************************************************************************//**
+ * @brief Antworten auf Steuerkommandos im Klartextprotokoll.
+ *
+ ************************************************************************************************************/
+enum class TxReply : uint8_t {
+    HELLO,          ///< Kennung `XPanino`
+    BIN_OK,         ///< `CTRL;BIN;OK`; danach wird auf das Binärprotokoll umgeschaltet
+    ASC_OK,         ///< `CTRL;ASC;OK`
+    BAUD,           ///< `CTRL;BAUD;<kBaud>`; danach wird auf die neue Baudrate umgeschaltet
+    BAUD_OK,        ///< `CTRL;BAUD;OK`
+    BAUD_FAIL,      ///< `CTRL;BAUD;FAIL`
+    TEST            ///< Testmuster `CTRL;TEST;U*U*U*` mit der neuen Baudrate
+};
+
+
+/*********************************************************************************************************//**
+ * @brief Eine typisierte Nachricht an den PC. Die Formatierung erfolgt erst beim Senden, je nach
+ *        aktivem Übertragungsprotokoll.
+ *
+ ************************************************************************************************************/
+class TxMessage {
+public:
+    TxMessageType type;     ///< Art der Nachricht
+    uint8_t row;            ///< SWITCH_EVENT: Row des Schalters; STATE_WORD: Index; LOG: ID der Meldung; TRACE: Trace-Punkt; XPDR_REPORT, REPLY: Art; DIAG_VALUE: Position; LOOP_*: Abschnitt
+    uint8_t col;            ///< SWITCH_EVENT: Col des Schalters; STATE_WORD, STATE_VERSION: Version; TRACE: Argument
+    uint8_t state;          ///< SWITCH_EVENT: 0 = aus, 1 = ein, 2 = lange ein; Bit 7 = mit Zeitstempel
+    uint8_t seq;            ///< SWITCH_EVENT im Binärprotokoll: Folgenummer (siehe LinkClass)
+    uint32_t value;         ///< Zeitstempel, Zeit, die Bytes der Momentaufnahme, das Zustandswort oder die Log-Argumente
+};
+
+const uint8_t TX_WITH_TIMESTAMP = 0x80;     ///< Flag in TxMessage::state: Zeitstempel mitsenden
+
+
+/*********************************************************************************************************//**
+ * @brief Sendewarteschlange für die Nachrichten an den PC.
+ *
+ * Nachrichten werden nur in die Warteschlange gestellt. Einmal je loop() fasst flush() so viele
+ * Nachrichten, wie in den Sendepuffer der seriellen Schnittstelle passen, zu einem einzigen
+ * Schreibvorgang zusammen -- im Binärprotokoll zu einem Frame. Es wird nie auf den Sendepuffer
+ * gewartet; was nicht passt, wird im nächsten loop() gesendet. Ist die Warteschlange voll, wird
+ * die neue Nachricht verworfen und gezählt.
+ *
+ ************************************************************************************************************/
+class TxQueueClass {
+public:
+    /**
+     * @brief Ein Schalterereignis in die Warteschlange stellen.
+     *
+     * @param row Row des Schalters in der Schaltermatrix
+     * @param col Col des Schalters in der Schaltermatrix
+     * @param switchState 0 = aus, 1 = ein, 2 = lange ein
+     * @param withTimestamp @em true ==> @em timestamp mitsenden.
+     * @param timestamp Zeitpunkt der Flanke in Millisekunden seit Sitzungsbeginn.
+     *
+     * @return @em true falls die Nachricht aufgenommen wurde, @em false falls die Warteschlange voll ist.
+     */
+    bool addSwitchEvent(uint8_t row, uint8_t col, uint8_t switchState, bool withTimestamp, uint32_t timestamp);
+
+
+    /**
+     * @brief Prüfen, ob ein weiteres Schalterereignis bzw. eine Meldung des Transponders aufgenommen werden
+     *        kann. Im Binärprotokoll muss dazu auch im Sendefenster der gesicherten Übertragung Platz sein.
+     */
+    bool canAddSwitchEvent() const;
+
+
+    /**
+     * @brief Eine fertige Nachricht in die Warteschlange stellen (z.B. für eine Wiederholung).
+     *
+     * @param message Die Nachricht.
+     * @return @em true falls die Nachricht aufgenommen wurde, @em false falls die Warteschlange voll ist.
+     */
+    bool addMessage(const TxMessage &message);
+
+
+    /**
+     * @brief Eine Momentaufnahme aller Schalter in die Warteschlange stellen.
+     *
+     * @param rowBits Je Matrixzeile ein Byte, beginnend mit Zeile 0; max. vier Zeilen.
+     * @param rows Anzahl Matrixzeilen.
+     *
+     * @return @em true falls die Nachricht aufgenommen wurde, @em false falls die Warteschlange voll ist.
+     */
+    bool addSnapshot(const uint8_t *rowBits, uint8_t rows);
+
+
+    /**
+     * @brief Eine Zeitsynchronisation in die Warteschlange stellen.
+     *
+     * @param time Millisekunden seit Sitzungsbeginn.
+     *
+     * @return @em true falls die Nachricht aufgenommen wurde, @em false falls die Warteschlange voll ist.
+     */
+    bool addTimeSync(uint32_t time);
+
+
+    /**
+     * @brief Ein Ergebnis der Bedienung des Transponders in die Warteschlange stellen. Wie Schalterereignisse
+     *        wird die Meldung im Binärprotokoll gesichert übertragen (siehe LinkClass).
+     *
+     * @param item Art der Meldung (siehe XpdrReport): Code, Betriebsmodus oder IDT.
+     * @param value Code (z.B. 7000) bzw. Betriebsmodus (siehe XpdrMode).
+     *
+     * @return @em true falls die Nachricht aufgenommen wurde, @em false falls Warteschlange oder Sendefenster
+     *         voll sind.
+     */
+    bool addXpdrReport(uint8_t item, uint16_t value);
+
+
+    /**
+     * @brief Eine Antwort auf ein Steuerkommando in die Warteschlange stellen. Antworten gibt es nur im
+     *        Klartextprotokoll; im Binärprotokoll wird nichts aufgenommen.
+     *
+     * Nach @em TxReply::BIN_OK wird beim Senden auf das Binärprotokoll umgeschaltet, nach @em TxReply::BAUD
+     * meldet die Warteschlange das Senden an die LinkSpeedClass und hält bis zum Umschalten der Baudrate an.
+     *
+     * @param reply Art der Antwort.
+     * @param value Wert, z.B. die Baudrate in kBaud bei @em TxReply::BAUD.
+     * @return @em true falls die Antwort aufgenommen wurde, sonst @em false.
+     */
+    bool addReply(TxReply reply, uint16_t value = 0);
+
+
+    /**
+     * @brief Die anstehenden Nachrichten senden, soweit sie ohne Warten in den Sendepuffer passen.
+     * @note Diese Methode muss einmal je loop() aufgerufen werden.
+     */
+    void flush();
+
+
+    /**
+     * @brief Prüfen, ob die Warteschlange voll ist.
+     *
+     * @return @em true falls keine weitere Nachricht aufgenommen werden kann.
+     */
+    inline bool isFull() const { return count == TX_QUEUE_SIZE; }
+
+    inline uint8_t getCount() const { return count; }                  ///< Anzahl anstehender Nachrichten
+    inline uint8_t getHighWater() const { return highWater; }          ///< Max. Anzahl anstehender Nachrichten
+    inline uint16_t getDropped() const { return dropped; }             ///< Anzahl verworfener Nachrichten
+
+private:
+    TxMessage messages[TX_QUEUE_SIZE];  ///< Ringpuffer der Nachrichten
+    uint8_t head = 0;                   ///< Index der ältesten Nachricht
+    uint8_t count = 0;                  ///< Anzahl anstehender Nachrichten
+    uint8_t highWater = 0;              ///< Max. Anzahl anstehender Nachrichten
+    uint16_t dropped = 0;               ///< Anzahl verworfener Nachrichten, weil die Warteschlange voll war
+
+    bool addTracked(TxMessage &message);
+    void flushAscii();
+    void flushBinary();
+    static uint8_t formatAscii(const TxMessage &message, char *line, uint8_t size);
+};
@@ -1,7 +1,7 @@
 /*********************************************************************************************************//**
  * @file xpdr.cpp
  * @author Christian Harraeus <christian@harraeus.de>
- * @brief Implementierung der Klasse @em ClockDavtronM803
+ * @brief Implementierung der Klasse @em TransponderKT76C
  * @version 0.2
  * @date 2022-12-08
  *
@@ -9,5 +9,411 @@
  ************************************************************************************************************/
 
 #include <xpdr.hpp>
+#include <logger.hpp>
+#include <txqueue.hpp>
 
-// Konstanten der möglichen Event-Strings
+extern LedMatrix leds;
+extern TxQueueClass txQueue;
+
+/**
+ * Die Schalter des Transponders in der Schaltermatrix des Arduino Uno (siehe Verdrahtungsplan.md und
+ * DavtronM803.md): Row 0 und 1 (Pins A0 und A1) mit den Cols 0 bis 7 (Pins 6 bis 13). Die Schalter der
+ * Uhr liegen auf Row 2 und 3 (A2, A3) mit den Cols 6 und 7 (Pins 12, 13) und gehen an den PC.
+ */
+const XpdrKey XPDR_KEYS[XPDR_KEY_ROWS][XPDR_KEY_COLS] PROGMEM = {
+    {XpdrKey::IDT, XpdrKey::VFR, XpdrKey::CLR,
+     XpdrKey::MODE_OFF, XpdrKey::MODE_SBY, XpdrKey::MODE_TST, XpdrKey::MODE_ON, XpdrKey::MODE_ALT},
+    {XpdrKey::DIGIT_0, XpdrKey::DIGIT_1, XpdrKey::DIGIT_2, XpdrKey::DIGIT_3,
+     XpdrKey::DIGIT_4, XpdrKey::DIGIT_5, XpdrKey::DIGIT_6, XpdrKey::DIGIT_7}
+};
+
+
+/*********************************************************************************************************//**
+ * TransponderKT76C - public Methoden
+ *
+ ************************************************************************************************************/
+
+TransponderKT76C::TransponderKT76C() {
+    strcpy(activeCode, XPDR_DEFAULT_VFR_CODE);
+    strcpy(previousCode, XPDR_DEFAULT_VFR_CODE);
+    strcpy(vfrCode, XPDR_DEFAULT_VFR_CODE);
+    entry[0] = '\0';
+
+    leds.defineDisplayField(XPDR_FL_DISPLAY, 0, {0, 8});        ///< Die 1. 7-Segment-Anzeige liegt auf der Row 0 und den Cols 8 bis 15: Hunderterstelle.
+    leds.defineDisplayField(XPDR_FL_DISPLAY, 1, {1, 8});        ///< Die 2. 7-Segment-Anzeige liegt auf der Row 1 und den Cols 8 bis 15: Zehnerstelle.
+    leds.defineDisplayField(XPDR_FL_DISPLAY, 2, {2, 8});        ///< Die 3. 7-Segment-Anzeige liegt auf der Row 2 und den Cols 8 bis 15: Einerstelle.
+    leds.defineDisplayField(XPDR_SQUAWK_DISPLAY, 0, {3, 8});    ///< Die 1. 7-Segment-Anzeige liegt auf der Row 3 und den Cols 8 bis 15: Tausenderstelle.
+    leds.defineDisplayField(XPDR_SQUAWK_DISPLAY, 1, {4, 8});    ///< Die 2. 7-Segment-Anzeige liegt auf der Row 4 und den Cols 8 bis 15: Hunderterstelle.
+    leds.defineDisplayField(XPDR_SQUAWK_DISPLAY, 2, {5, 8});    ///< Die 3. 7-Segment-Anzeige liegt auf der Row 5 und den Cols 8 bis 15: Zehnerstelle.
+    leds.defineDisplayField(XPDR_SQUAWK_DISPLAY, 3, {6, 8});    ///< Die 4. 7-Segment-Anzeige liegt auf der Row 6 und den Cols 8 bis 15: Einerstelle.
+}
+
+
+void TransponderKT76C::processEvent(EventClass *event) {
+    switch (event->eventId) {
+        case TokenId::EV_CODE: {
+            // Eine laufende Eingabe hat Vorrang; der Code vom PC wird trotzdem der aktive Code.
+            if (isValidCode(event->parameter1)) {
+                setActiveCode(event->parameter1, false);
+            }
+            break;
+        }
+        case TokenId::EV_F: {
+            const int16_t level = static_cast<int16_t>(atoi(event->parameter1));
+            flightLevel = min(max(level, XPDR_FL_MIN), XPDR_FL_MAX);
+            isChanged = true;
+            break;
+        }
+        default: Device::processEvent(event);
+    }
+}
+
+
+bool TransponderKT76C::onSwitch(const uint8_t row, const uint8_t col, const uint8_t switchState,
+                                const unsigned long now) {
+    const XpdrKey key = keyAt(row, col);
+    if (key == XpdrKey::NONE) {
+        return false;
+    }
+    if (switchState == 2) {
+        return true;    // "lange ein" misst der Transponder selbst (VFR)
+    }
+    const bool isPressed = (switchState == 1);
+    if (isPressed == isKeyPressed(key)) {
+        return true;    // keine Änderung, z.B. beim erneuten Senden aller Schalter
+    }
+    pressedKeys ^= keyBit(key);
+    if (isPressed && (key == XpdrKey::VFR)) {
+        // Beginn jedes Drucks merken, auch wenn die Tasten gerade gesperrt sind; sonst misst tick() "VFR lang"
+        // ab einem veralteten Zeitpunkt.
+        vfrPressTime = now;
+        isVfrLongDone = false;
+    }
+    if (isPressed) {
+        onKeyPressed(key, now);
+    } else {
+        onKeyReleased(key);
+    }
+    return true;
+}
+
+
+void TransponderKT76C::setBusPower(const bool battery, const bool avionics1, const bool avionics2) {
+    Device::setBusPower(battery, avionics1, avionics2);
+    applySelector(false, 0);    // beim Einschalten in Stellung TST kein Lampentest, sondern SBY
+}
+
+
+void TransponderKT76C::setLinkUp(const bool isUp) {
+    if (isUp && ! linkUp) {
+        // Der PC hat die Meldungen während der Trennung nicht bekommen: Betriebsmodus und Code neu melden.
+        report(XpdrReport::MODE);
+        report(XpdrReport::CODE);
+    }
+    linkUp = isUp;
+    entryLength = 0;
+    isChanged = true;
+}
+
+
+void TransponderKT76C::tick(const unsigned long now) {
+    if ((entryLength > 0) && (now - lastKeyTime >= XPDR_ENTRY_TIMEOUT)) {
+        entryLength = 0;    // unvollständige Eingabe: wieder den aktiven Code anzeigen
+        isChanged = true;
+    }
+    if (isKeyPressed(XpdrKey::VFR) && ! isVfrLongDone
+        && (now - vfrPressTime >= XPDR_VFR_LONG_PRESS)) {
+        isVfrLongDone = true;
+        if (isCodeEntryAllowed()) {
+            entryLength = 0;
+            setActiveCode(previousCode, true);
+        }
+    }
+    if (isIdentActive && (now - identTime >= XPDR_IDENT_TIME)) {
+        isIdentActive = false;
+        isChanged = true;
+    }
+    if ((mode == XpdrMode::TST) && (now - testTime >= XPDR_TEST_TIME)) {
+        setMode(XpdrMode::SBY);
+    }
+    transmitReports();
+}
+
+
+void TransponderKT76C::show() {
+    if (! isChanged) {
+        return;
+    }
+    isChanged = false;
+    leds.beginUpdate();
+    leds.ledBlinkOff(XPDR_LED_R, BLINK_SLOW);
+    if (mode == XpdrMode::OFF) {
+        leds.display(XPDR_FL_DISPLAY, "   ");
+        leds.display(XPDR_SQUAWK_DISPLAY, "    ");
+        leds.ledOff(XPDR_LED_ALT);
+        leds.ledOff(XPDR_LED_R);
+    } else if (mode == XpdrMode::TST) {
+        leds.display(XPDR_FL_DISPLAY, "8.8.8.");    // Lampentest: alle Segmente inkl. Dezimalpunkt
+        leds.display(XPDR_SQUAWK_DISPLAY, "8.8.8.8.");
+        leds.ledOn(XPDR_LED_ALT);
+        leds.ledOn(XPDR_LED_R);
+    } else if (! linkUp) {
+        leds.display(XPDR_FL_DISPLAY, "   ");
+        leds.display(XPDR_SQUAWK_DISPLAY, "noFS");
+        leds.ledOff(XPDR_LED_ALT);
+        leds.ledOff(XPDR_LED_R);
+    } else {
+        char digits[XPDR_CODE_LENGTH + 1];
+        snprintf(digits, sizeof(digits), "%03d", flightLevel % 1000);   // schon begrenzt; "% 1000" für den Compiler
+        leds.display(XPDR_FL_DISPLAY, digits);
+        if (entryLength > 0) {
+            // Eingabe: die eingegebenen Stellen, die restlichen als "-"
+            memset(digits, '-', XPDR_CODE_LENGTH);
+            memcpy(digits, entry, entryLength);
+            digits[XPDR_CODE_LENGTH] = '\0';
+            leds.display(XPDR_SQUAWK_DISPLAY, digits);
+        } else {
+            leds.display(XPDR_SQUAWK_DISPLAY, activeCode);
+        }
+        if (mode == XpdrMode::ALT) {
+            leds.ledOn(XPDR_LED_ALT);
+        } else {
+            leds.ledOff(XPDR_LED_ALT);
+        }
+        if (isIdentActive) {
+            leds.ledOn(XPDR_LED_R);         // nach IDT leuchtet der Reply-Indikator dauernd
+        } else if (mode == XpdrMode::ALT) {
+            leds.ledOn(XPDR_LED_R);         // Antworten auf Abfragen simulieren
+            leds.ledBlinkOn(XPDR_LED_R, BLINK_SLOW);
+        } else {
+            leds.ledOff(XPDR_LED_R);
+        }
+    }
+    leds.endUpdate();
+}
+
+
+/*********************************************************************************************************//**
+ * ab hier die privaten Methoden
+*************************************************************************************************************/
+
+/**
+ * @brief Die Taste bzw. Schalterstellung des Transponders an einer Position der Schaltermatrix.
+ *
+ * @return Die Taste bzw. @em XpdrKey::NONE, falls der Schalter nicht zum Transponder gehört.
+ */
+XpdrKey TransponderKT76C::keyAt(const uint8_t row, const uint8_t col) {
+    if ((row >= XPDR_KEY_ROWS) || (col >= XPDR_KEY_COLS)) {
+        return XpdrKey::NONE;
+    }
+    return static_cast<XpdrKey>(pgm_read_byte(&XPDR_KEYS[row][col]));
+}
+
+
+/**
+ * @brief Eine Taste wurde gedrückt bzw. der Betriebsmodus-Wahlschalter in eine Stellung gedreht.
+ */
+void TransponderKT76C::onKeyPressed(const XpdrKey key, const unsigned long now) {
+    if (key >= XpdrKey::MODE_OFF) {
+        selector = static_cast<XpdrMode>(static_cast<uint8_t>(key) - static_cast<uint8_t>(XpdrKey::MODE_OFF));
+        applySelector(true, now);
+        return;
+    }
+    if (! isCodeEntryAllowed()) {
+        return;
+    }
+    switch (key) {
+        case XpdrKey::CLR: {
+            clearDigit(now);
+            break;
+        }
+        case XpdrKey::VFR: {
+            if (isKeyPressed(XpdrKey::IDT) && (mode == XpdrMode::SBY)) {
+                // IDT festhalten und VFR drücken: den aktiven Code als VFR-Code programmieren
+                strcpy(vfrCode, activeCode);
+                isVfrLongDone = true;
+                LOG(XPDR_VFR_PROGRAMMED, static_cast<uint16_t>(atoi(vfrCode)), 0);
+            }
+            break;
+        }
+        case XpdrKey::IDT: {
+            if ((mode == XpdrMode::ON) || (mode == XpdrMode::ALT)) {
+                isIdentActive = true;
+                identTime = now;
+                isChanged = true;
+                report(XpdrReport::IDENT);
+            }
+            break;
+        }
+        default: {
+            enterDigit(static_cast<char>('0' + static_cast<uint8_t>(key)), now);
+        }
+    }
+}
+
+
+/**
+ * @brief Eine Taste wurde losgelassen. Nur VFR löst beim Loslassen aus: kurz = VFR-Code einstellen.
+ */
+void TransponderKT76C::onKeyReleased(const XpdrKey key) {
+    if ((key != XpdrKey::VFR) || isVfrLongDone || ! isCodeEntryAllowed()) {
+        return;
+    }
+    entryLength = 0;
+    strcpy(previousCode, activeCode);
+    setActiveCode(vfrCode, true);
+}
+
+
+/**
+ * @brief Eine Stelle des Codes eingeben; mit der vierten Stelle wird der Code aktiv und an den PC gemeldet.
+ */
+void TransponderKT76C::enterDigit(const char digit, const unsigned long now) {
+    entry[entryLength++] = digit;
+    entry[entryLength] = '\0';
+    lastKeyTime = now;
+    isChanged = true;
+    if (entryLength == XPDR_CODE_LENGTH) {
+        entryLength = 0;
+        setActiveCode(entry, true);
+    }
+}
+
+
+/**
+ * @brief Die zuletzt eingegebene Stelle löschen. Ohne laufende Eingabe wird die letzte Stelle des aktiven
+ *        Codes gelöscht und die Eingabe damit begonnen.
+ */
+void TransponderKT76C::clearDigit(const unsigned long now) {
+    if (entryLength == 0) {
+        memcpy(entry, activeCode, XPDR_CODE_LENGTH);
+        entryLength = XPDR_CODE_LENGTH;
+    }
+    entry[--entryLength] = '\0';
+    lastKeyTime = now;
+    isChanged = true;
+}
+
+
+/**
+ * @brief Einen neuen aktiven Code setzen.
+ *
+ * @param code Der Code, 4 Ziffern 0 bis 7.
+ * @param isReported @em true = am Transponder eingestellt und an den PC melden; @em false = vom PC.
+ */
+void TransponderKT76C::setActiveCode(const char *code, const bool isReported) {
+    if (strcmp(code, activeCode) != 0) {
+        memcpy(activeCode, code, XPDR_CODE_LENGTH + 1);
+        isChanged = true;
+    }
+    if (isReported) {
+        report(XpdrReport::CODE);
+    }
+}
+
+
+/**
+ * @brief Den Betriebsmodus aus der Stellung des Wahlschalters und der Stromversorgung bestimmen.
+ *
+ * @param isTestAllowed @em true = der Wahlschalter wurde gedreht; nur dann startet in Stellung TST der
+ *                      Lampentest. Sonst (z.B. beim Einschalten des Stroms) gilt TST wie SBY.
+ * @param now Aktuelle Zeit in Millisekunden (Beginn des Lampentests).
+ */
+void TransponderKT76C::applySelector(const bool isTestAllowed, const unsigned long now) {
+    XpdrMode newMode = isDevicePowerAvailable() ? selector : XpdrMode::OFF;
+    if (newMode == XpdrMode::TST) {
+        if (isTestAllowed) {
+            testTime = now;
+        } else {
+            newMode = XpdrMode::SBY;
+        }
+    }
+    setMode(newMode);
+}
+
+
+/**
+ * @brief Den Betriebsmodus wechseln und an den PC melden.
+ */
+void TransponderKT76C::setMode(const XpdrMode newMode) {
+    if (newMode == mode) {
+        return;
+    }
+    mode = newMode;
+    entryLength = 0;
+    if ((mode != XpdrMode::ON) && (mode != XpdrMode::ALT)) {
+        isIdentActive = false;
+    }
+    isChanged = true;
+    LOG(XPDR_MODE, static_cast<uint8_t>(mode), 0);
+    report(XpdrReport::MODE);
+}
+
+
+/**
+ * @brief Eine Meldung an den PC vormerken. Gesendet wird sie in transmitReports() mit dem dann aktuellen Wert.
+ */
+void TransponderKT76C::report(const XpdrReport item) {
+    pendingReports |= static_cast<uint8_t>(1U << static_cast<uint8_t>(item));
+}
+
+
+/**
+ * @brief Die vorgemerkten Meldungen gesichert an den PC senden, solange der Flugsimulator online ist.
+ *
+ * Ist die Sendewarteschlange oder das Sendefenster voll, bleiben die restlichen Meldungen vorgemerkt und
+ * werden beim nächsten tick() gesendet.
+ */
+void TransponderKT76C::transmitReports() {
+    if (! linkUp) {
+        return;
+    }
+    for (uint8_t item = 0; pendingReports != 0; ++item) {
+        const uint8_t itemBit = static_cast<uint8_t>(1U << item);
+        if ((pendingReports & itemBit) == 0) {
+            continue;
+        }
+        if (! txQueue.canAddSwitchEvent()) {
+            return;
+        }
+        uint16_t value = 0;
+        if (item == static_cast<uint8_t>(XpdrReport::CODE)) {
+            value = static_cast<uint16_t>(atoi(activeCode));
+        } else if (item == static_cast<uint8_t>(XpdrReport::MODE)) {
+            value = static_cast<uint8_t>(mode);
+        }
+        if (! txQueue.addXpdrReport(item, value)) {
+            return;
+        }
+        pendingReports &= static_cast<uint8_t>(~itemBit);
+    }
+}
+
+
+/**
+ * @brief Prüfen, ob der Transponder eingeschaltet ist und Werte vom Flugsimulator anzeigt.
+ */
+bool TransponderKT76C::isOperating() const {
+    return (mode == XpdrMode::SBY) || (mode == XpdrMode::ON) || (mode == XpdrMode::ALT);
+}
+
+
+/**
+ * @brief Prüfen, ob die Tasten aktiv sind: nicht in OFF und TST und nur mit Flugsimulator.
+ */
+bool TransponderKT76C::isCodeEntryAllowed() const {
+    return isOperating() && linkUp;
+}
+
+
+/**
+ * @brief Prüfen, ob ein String ein gültiger Transponder-Code ist: genau 4 Ziffern 0 bis 7.
+ */
+bool TransponderKT76C::isValidCode(const char *code) {
+    for (uint8_t index = 0; index < XPDR_CODE_LENGTH; ++index) {
+        if ((code[index] < '0') || (code[index] > '7')) {
+            return false;
+        }
+    }
+    return code[XPDR_CODE_LENGTH] == '\0';
+}
@@ -11,27 +11,198 @@
 #pragma once
 
 #include <Arduino.h>
-#include <buffer.hpp>
+#include <event.hpp>
 #include <device.hpp>
 #include <Switchmatrix.hpp>
 #include <ledmatrix.hpp>
 
 const char DEVICE_XPDR[] = "XPDR";
+const uint8_t XPDR_FL_DISPLAY = 2;      ///< Display-Feld für den Flightlevel (linkes Display)
+const uint8_t XPDR_SQUAWK_DISPLAY = 3;  ///< Display-Feld für den Transponder-Code (rechtes Display)
+const LedMatrixPos XPDR_LED_ALT = {6, 4};   ///< Die LED "ALT" liegt auf Row=6 und Col=4.
+const LedMatrixPos XPDR_LED_R = {7, 4};     ///< Die LED "R" (Reply-Indikator) liegt auf Row=7 und Col=4.
+
+const uint8_t XPDR_CODE_LENGTH = 4;             ///< Anzahl Stellen des Transponder-Codes
+const char XPDR_DEFAULT_VFR_CODE[] = "7000";    ///< Voreingestellter VFR-Code
+const unsigned long XPDR_ENTRY_TIMEOUT = 4000;  ///< Unvollständige Eingabe verwerfen nach ... ms ohne Taste
+const unsigned long XPDR_VFR_LONG_PRESS = 2000; ///< VFR-Taste mind. ... ms gedrückt: vorherigen Code wiederherstellen
+const unsigned long XPDR_IDENT_TIME = 18000;    ///< Reply-Indikator leuchtet nach IDT ... ms
+const unsigned long XPDR_TEST_TIME = 4000;      ///< Lampentest dauert ... ms, danach SBY
+const int16_t XPDR_FL_MIN = -10;                ///< Kleinster anzeigbarer Flightlevel
+const int16_t XPDR_FL_MAX = 999;                ///< Größter anzeigbarer Flightlevel
 
 /**************************************************************************************************
  * Status-Aufzählungstpyen
  *
  **************************************************************************************************/
 
+/***************************************************************************************************
+ * @brief Betriebsmodi des Transponders; gleichzeitig die Stellungen des Betriebsmodus-Wahlschalters.
+ *
+ */
+enum class XpdrMode : uint8_t {
+    OFF,        ///< Ausgeschaltet, alle Anzeigen dunkel
+    SBY,        ///< Standby: Anzeige von Flightlevel und Code, keine Antworten
+    TST,        ///< Lampentest: alle Segmente und LEDs an, danach SBY
+    ON,         ///< Antworten auf Mode A/C/S-Abfragen
+    ALT         ///< Wie ON, zusätzlich mit Höhe; die LED "R" blinkt
+};
+
+/***************************************************************************************************
+ * @brief Tasten und Schalterstellungen des Transponders.
+ *
+ */
+enum class XpdrKey : uint8_t {
+    DIGIT_0, DIGIT_1, DIGIT_2, DIGIT_3, DIGIT_4, DIGIT_5, DIGIT_6, DIGIT_7,     ///< Code-Entry-Tasten 0 bis 7
+    CLR,        ///< Letzte eingegebene Stelle löschen
+    VFR,        ///< VFR-Code einstellen (kurz) bzw. vorherigen Code wiederherstellen (lang)
+    IDT,        ///< Squawk Ident
+    MODE_OFF, MODE_SBY, MODE_TST, MODE_ON, MODE_ALT,    ///< Stellungen des Betriebsmodus-Wahlschalters
+    NONE        ///< Kein Schalter des Transponders
+};
+
+const uint8_t XPDR_KEY_ROWS = 2;    ///< Anzahl Matrixzeilen mit Schaltern des Transponders (ab Row 0)
+const uint8_t XPDR_KEY_COLS = 8;    ///< Anzahl Matrixspalten mit Schaltern des Transponders (ab Col 0)
+
+/***************************************************************************************************
+ * @brief Meldungen des Transponders an den PC (siehe TxQueueClass::addXpdrReport()).
+ *
+ */
+enum class XpdrReport : uint8_t {
+    CODE,       ///< Neuer Code ist aktiv; Wert = Code, z.B. 7000
+    MODE,       ///< Neuer Betriebsmodus; Wert = XpdrMode
+    IDENT       ///< IDT wurde gedrückt
+};
+
+
 /** ************************************************************************************************
  * @brief Modell des Transponders KT76C
  *
- * @todo Doku ergänzen
+ * Die ganze Bedienung läuft auf dem Arduino (siehe KT76C.md): Betriebsmodi, Eingabe des Codes mit
+ * Rücksprung nach 4 Sekunden, VFR-Taste, IDT mit Reply-Indikator, Lampentest und die Anzeige des
+ * Flightlevels. Die Tasten des Transponders gehen daher nicht als Schalterereignisse an den PC; der PC
+ * bekommt nur die Ergebnisse: den fertigen Code, den Betriebsmodus und IDT.
+ *
+ * Vom PC kommen der aktuelle Code (@em XPDR;CODE) und der Flightlevel (@em XPDR;F).
  *
  **************************************************************************************************/
 class TransponderKT76C : public Device {
 public:
+    static constexpr TokenId DEVICE_ID = TokenId::DEV_XPDR;    ///< ID für die Zuordnung der Events
+
+    TransponderKT76C();
+
+
+    /**
+     * @brief Code und Flightlevel vom PC übernehmen.
+     *
+     * @param event Das Event @em CODE oder @em F; alle anderen werden nur protokolliert.
+     */
+    void processEvent(EventClass *event);
+
+
+    /**
+     * @brief Einen Schalter der Schaltermatrix verarbeiten, falls er zum Transponder gehört.
+     *
+     * @param row Row des Schalters in der Schaltermatrix.
+     * @param col Col des Schalters in der Schaltermatrix.
+     * @param switchState 0 = aus, 1 = ein, 2 = lange ein.
+     * @param now Aktuelle Zeit in Millisekunden.
+     * @return @em true falls der Schalter zum Transponder gehört; er wird dann nicht an den PC gesendet.
+     */
+    bool onSwitch(uint8_t row, uint8_t col, uint8_t switchState, unsigned long now);
+
+
+    /**
+     * @brief Die Stromversorgung setzen; ohne Strom ist der Transponder aus.
+     *
+     * @param battery @em true = Batteriestrom verfügbar.
+     * @param avionics1 @em true = Avionicsbus 1 versorgt.
+     * @param avionics2 @em true = Avionicsbus 2 versorgt.
+     */
+    void setBusPower(bool battery, bool avionics1, bool avionics2);
+
+    /**
+     * @brief Prüfen, ob ein Schalter der Schaltermatrix zum Transponder gehört.
+     *
+     * @param row Row des Schalters in der Schaltermatrix.
+     * @param col Col des Schalters in der Schaltermatrix.
+     * @return @em true falls der Schalter eine Taste bzw. Stellung des Transponders ist.
+     */
+    inline bool ownsSwitch(const uint8_t row, const uint8_t col) const { return keyAt(row, col) != XpdrKey::NONE; }
+
+
+    /**
+     * @brief Verbindung zum Flugsimulator hergestellt bzw. getrennt.
+     *
+     * Ohne Flugsimulator bleibt das linke Display dunkel und das rechte zeigt "noFS"; die Tasten (außer dem
+     * Betriebsmodus-Wahlschalter) werden ignoriert.
+     *
+     * @param isUp @em true = Flugsimulator online.
+     */
+    void setLinkUp(bool isUp);
+
+
+    /**
+     * @brief Beim nächsten @em show() alles neu anzeigen.
+     */
+    inline void redraw() { isChanged = true; }
+
+
+    /**
+     * @brief Die Zeitüberwachungen (Rücksprung der Eingabe, VFR lang, IDT und Lampentest) und das Senden
+     *        der vorgemerkten Meldungen an den PC.
+     * @note Diese Methode muss einmal je loop() vor @em show() aufgerufen werden.
+     *
+     * @param now Aktuelle Zeit in Millisekunden.
+     */
+    void tick(unsigned long now);
+
+
+    /**
+     * @brief Flightlevel, Code und LEDs anzeigen, falls sich etwas geändert hat.
+     */
+    void show();
+
+
+    inline XpdrMode getMode() const { return mode; }                ///< Aktueller Betriebsmodus
+    inline const char *getCode() const { return activeCode; }       ///< Aktiver Code, 4 Ziffern 0 bis 7
 
 private:
-    int dummy = 0;
-};
\ No newline at end of file
+    XpdrMode mode = XpdrMode::OFF;          ///< Aktueller Betriebsmodus
+    XpdrMode selector = XpdrMode::OFF;      ///< Stellung des Betriebsmodus-Wahlschalters
+    char activeCode[XPDR_CODE_LENGTH + 1];  ///< Aktiver Code
+    char previousCode[XPDR_CODE_LENGTH + 1];    ///< Code vor dem letzten Druck auf VFR
+    char vfrCode[XPDR_CODE_LENGTH + 1];     ///< Programmierter VFR-Code
+    char entry[XPDR_CODE_LENGTH + 1];       ///< Die bisher eingegebenen Stellen
+    uint8_t entryLength = 0;                ///< Anzahl eingegebener Stellen; 0 = keine Eingabe
+    int16_t flightLevel = 0;                ///< Flightlevel vom PC
+    uint16_t pressedKeys = 0;               ///< Je XpdrKey ein Bit: Taste ist gedrückt
+    uint8_t pendingReports = 0;             ///< Je XpdrReport ein Bit: Meldung an den PC steht noch aus
+    bool linkUp = true;                     ///< Flugsimulator ist online
+    bool isIdentActive = false;             ///< Reply-Indikator leuchtet nach IDT
+    bool isVfrLongDone = false;             ///< VFR lang wurde beim aktuellen Druck schon ausgeführt
+    bool isChanged = true;                  ///< Die Anzeige muss aktualisiert werden
+    unsigned long lastKeyTime = 0;          ///< Zeitpunkt der letzten Taste während der Eingabe
+    unsigned long vfrPressTime = 0;         ///< Zeitpunkt, ab dem VFR gedrückt ist
+    unsigned long identTime = 0;            ///< Zeitpunkt von IDT
+    unsigned long testTime = 0;             ///< Beginn des Lampentests
+
+    /// Bit einer Taste in @em pressedKeys
+    static inline uint16_t keyBit(const XpdrKey key) { return 1U << static_cast<uint8_t>(key); }
+    inline bool isKeyPressed(const XpdrKey key) const { return (pressedKeys & keyBit(key)) != 0; }
+
+    static XpdrKey keyAt(uint8_t row, uint8_t col);
+    void onKeyPressed(XpdrKey key, unsigned long now);
+    void onKeyReleased(XpdrKey key);
+    void enterDigit(char digit, unsigned long now);
+    void clearDigit(unsigned long now);
+    void setActiveCode(const char *code, bool isReported);
+    void applySelector(bool isTestAllowed, unsigned long now);
+    void setMode(XpdrMode newMode);
+    void report(XpdrReport item);
+    void transmitReports();
+    bool isOperating() const;
+    bool isCodeEntryAllowed() const;
+    static bool isValidCode(const char *code);
+};
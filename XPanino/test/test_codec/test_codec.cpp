@@ -0,0 +1,266 @@
+/*********************************************************************************************************//**
+ * @file test_codec.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief COBS-Rahmen und CRC-8 des Binärprotokolls; Vergleich mit dem Klartextprotokoll.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ * Die kodierten Beispiel-Frames sind mit cobs_decode() und crc8() aus tools/logdecode.py gegengeprüft,
+ * damit Arduino und PC-Werkzeuge dieselbe Kodierung verwenden. Bytes je Aktualisierung und die Laufzeit
+ * des Empfangs werden für beide Protokolle ausgegeben.
+ *
+ ************************************************************************************************************/
+
+#include <unity.h>
+#include <chrono>
+#include <event.hpp>
+#include <parser.hpp>
+#include <protocol.hpp>
+
+extern EventQueueClass eventQueue;
+
+static ProtocolClass protocol;
+
+const uint8_t SQUAWK_7000[] = {0x1B, 0x58};
+const uint8_t SQUAWK_0000[] = {0x00, 0x00};
+
+
+/// Einen Frame mit einem Record kodieren und senden; liefert die gesendeten Bytes inkl. Trennzeichen.
+static std::string encodeFrame(const uint16_t opcode, const uint8_t *payload, const uint8_t length) {
+    protocol.beginFrame();
+    TEST_ASSERT_TRUE(protocol.addRecord(opcode, payload, length));
+    protocol.endFrame();
+    return Serial.hostTakeOutput();
+}
+
+
+/// Bytes wie von der seriellen Schnittstelle an den Empfang übergeben.
+static void receiveBytes(const std::string &bytes) {
+    for (const char inByte : bytes) {
+        protocol.receiveByte(static_cast<uint8_t>(inByte));
+    }
+}
+
+
+/// Die Eventqueue leeren und die Anzahl der Events liefern.
+static uint8_t drainEvents() {
+    uint8_t count = 0;
+    while (eventQueue.getHeadEvent() != nullptr) {
+        eventQueue.removeHeadEvent();
+        ++count;
+    }
+    return count;
+}
+
+
+void setUp() {
+    hostReset();
+    protocol = ProtocolClass();
+    protocol.setMode(ProtocolMode::BINARY);
+    drainEvents();
+}
+
+
+void tearDown() {}
+
+
+/*********************************************************************************************************//**
+ * CRC-8 und COBS
+ ************************************************************************************************************/
+void test_crc8MatchesCheckValue() {
+    // Prüfwert der CRC-8 mit Polynom 0x07 und Startwert 0x00 (CRC-8/SMBUS)
+    const char check[] = "123456789";
+    TEST_ASSERT_EQUAL_HEX8(0xF4, ProtocolClass::crc8(reinterpret_cast<const uint8_t *>(check), 9));
+    TEST_ASSERT_EQUAL_HEX8(0x00, ProtocolClass::crc8(nullptr, 0));
+}
+
+
+void test_encodingMatchesReferenceVectors() {
+    const uint8_t expected[] = {0x07, 0xF1, 0x01, 0x02, 0x1B, 0x58, 0xE4, 0x00};
+    const std::string sent = encodeFrame(XPDR_CODE, SQUAWK_7000, sizeof(SQUAWK_7000));
+    TEST_ASSERT_EQUAL(sizeof(expected), sent.size());
+    TEST_ASSERT_EQUAL_MEMORY(expected, sent.data(), sizeof(expected));
+
+    // Nullen in den Nutzdaten werden durch COBS ersetzt; nur das Trennzeichen ist 0x00
+    const uint8_t expectedZeros[] = {0x04, 0xF1, 0x01, 0x02, 0x01, 0x02, 0xAB, 0x00};
+    const std::string sentZeros = encodeFrame(XPDR_CODE, SQUAWK_0000, sizeof(SQUAWK_0000));
+    TEST_ASSERT_EQUAL(sizeof(expectedZeros), sentZeros.size());
+    TEST_ASSERT_EQUAL_MEMORY(expectedZeros, sentZeros.data(), sizeof(expectedZeros));
+    TEST_ASSERT_EQUAL(sentZeros.size() - 1, sentZeros.find('\0'));
+}
+
+
+void test_roundTripRestoresFrameAndCrc() {
+    const uint8_t payload[] = {0x00, 0x12, 0x00, 0x00, 0x34, 0x00};
+    std::string sent = encodeFrame(0x0100, payload, sizeof(payload));
+    TEST_ASSERT_EQUAL(FRAME_DELIMITER, static_cast<uint8_t>(sent.back()));
+    sent.pop_back();
+
+    uint8_t frame[FRAME_MAX_LENGTH + 1];
+    memcpy(frame, sent.data(), sent.size());
+    const uint8_t length = ProtocolClass::cobsDecode(frame, static_cast<uint8_t>(sent.size()));
+    const uint8_t expected[] = {0x01, 0x00, sizeof(payload), 0x00, 0x12, 0x00, 0x00, 0x34, 0x00};
+    TEST_ASSERT_EQUAL(sizeof(expected) + 1, length);
+    TEST_ASSERT_EQUAL_MEMORY(expected, frame, sizeof(expected));
+    TEST_ASSERT_EQUAL_HEX8(ProtocolClass::crc8(expected, sizeof(expected)), frame[length - 1]);
+}
+
+
+void test_maximumFrameLengthRoundTrips() {
+    // Record-Kopf + Nutzdaten + CRC füllen FRAME_MAX_LENGTH genau aus
+    uint8_t payload[FRAME_MAX_LENGTH - RECORD_HEADER_LENGTH - 1];
+    for (uint8_t i = 0; i < sizeof(payload); ++i) {
+        payload[i] = (i % 3 == 0) ? 0x00 : i;
+    }
+    protocol.beginFrame();
+    TEST_ASSERT_FALSE(protocol.addRecord(0x0100, payload, sizeof(payload) + 1));
+    const std::string sent = encodeFrame(0x0100, payload, sizeof(payload));
+    TEST_ASSERT_EQUAL(FRAME_MAX_LENGTH + 2, sent.size());     // + COBS-Kopf + Trennzeichen
+
+    receiveBytes(sent);
+    TEST_ASSERT_EQUAL(1, protocol.getFramesReceived());
+    TEST_ASSERT_EQUAL(0, protocol.getFrameErrors());
+}
+
+
+void test_recordIsTranslatedIntoEvent() {
+    receiveBytes(encodeFrame(XPDR_CODE, SQUAWK_0000, sizeof(SQUAWK_0000)));
+    TEST_ASSERT_EQUAL(1, protocol.getFramesReceived());
+    const EventClass *event = eventQueue.getHeadEvent();
+    TEST_ASSERT_NOT_NULL(event);
+    TEST_ASSERT_EQUAL(TokenId::DEV_XPDR, event->deviceId);
+    TEST_ASSERT_EQUAL(TokenId::EV_CODE, event->eventId);
+    TEST_ASSERT_EQUAL_STRING("0000", event->parameter1);
+}
+
+
+/*********************************************************************************************************//**
+ * Fehlerhafte Frames
+ ************************************************************************************************************/
+void test_badCrcIsRejected() {
+    const uint8_t corrupted[] = {0x07, 0xF1, 0x01, 0x02, 0x1B, 0x58, 0xE5, 0x00};
+    receiveBytes(std::string(reinterpret_cast<const char *>(corrupted), sizeof(corrupted)));
+    TEST_ASSERT_EQUAL(0, protocol.getFramesReceived());
+    TEST_ASSERT_EQUAL(1, protocol.getFrameErrors());
+    TEST_ASSERT_EQUAL(0, drainEvents());
+}
+
+
+void test_singleBitErrorsAreRejected() {
+    const std::string sent = encodeFrame(XPDR_CODE, SQUAWK_7000, sizeof(SQUAWK_7000));
+    uint16_t received = 0;
+    for (size_t pos = 0; pos + 1 < sent.size(); ++pos) {
+        for (uint8_t bit = 0; bit < 8; ++bit) {
+            std::string corrupted = sent;
+            corrupted[pos] = static_cast<char>(corrupted[pos] ^ (1 << bit));
+            receiveBytes(corrupted);
+            received += drainEvents();
+        }
+    }
+    TEST_ASSERT_EQUAL(0, received);
+    TEST_ASSERT_EQUAL(0, protocol.getFramesReceived());
+}
+
+
+void test_invalidCobsCodeIsRejected() {
+    // Der erste Block verweist über das Frame-Ende hinaus
+    const uint8_t invalid[] = {0x09, 0xF1, 0x01, 0x00};
+    receiveBytes(std::string(reinterpret_cast<const char *>(invalid), sizeof(invalid)));
+    TEST_ASSERT_EQUAL(1, protocol.getFrameErrors());
+    uint8_t frame[] = {0x05, 0x01, 0x02};
+    TEST_ASSERT_EQUAL(0, ProtocolClass::cobsDecode(frame, sizeof(frame)));
+}
+
+
+void test_overlongFrameIsDiscardedAndReceptionRecovers() {
+    receiveBytes(std::string(FRAME_MAX_LENGTH + 10, '\x01') + '\0');
+    TEST_ASSERT_EQUAL(1, protocol.getFrameErrors());
+
+    receiveBytes(encodeFrame(XPDR_CODE, SQUAWK_7000, sizeof(SQUAWK_7000)));
+    TEST_ASSERT_EQUAL(1, protocol.getFramesReceived());
+    TEST_ASSERT_EQUAL(1, drainEvents());
+}
+
+
+void test_recordBeyondFrameEndIsRejected() {
+    // Länge im Record-Kopf größer als die Nutzdaten; CRC ist gültig
+    const uint8_t raw[] = {0xF1, 0x01, 0x05, 0x1B, 0x58};
+    uint8_t encoded[] = {0x07, 0xF1, 0x01, 0x05, 0x1B, 0x58, ProtocolClass::crc8(raw, sizeof(raw)), 0x00};
+    receiveBytes(std::string(reinterpret_cast<const char *>(encoded), sizeof(encoded)));
+    TEST_ASSERT_EQUAL(1, protocol.getFramesReceived());
+    TEST_ASSERT_EQUAL(1, protocol.getFrameErrors());
+    TEST_ASSERT_EQUAL(0, drainEvents());
+}
+
+
+/*********************************************************************************************************//**
+ * Vergleich mit dem Klartextprotokoll
+ ************************************************************************************************************/
+
+/**
+ * @brief Bytes je Aktualisierung und Laufzeit des Empfangs (auf dem PC) für beide Protokolle ausgeben.
+ */
+void test_benchmarkAgainstAscii() {
+    const uint8_t time[] = {0x00, 0x01, 0xE2, 0x40};   // 123456
+    struct Update {
+        const char *ascii;
+        uint16_t opcode;
+        const uint8_t *payload;
+        uint8_t length;
+    };
+    const Update updates[] = {
+        {"XPDR;CODE;7000\n", XPDR_CODE, SQUAWK_7000, sizeof(SQUAWK_7000)},
+        {"M803;UT;123456\n", M803_UT, time, sizeof(time)},
+    };
+    const uint16_t repetitions = 50000;     // getFramesReceived() zählt mit uint16_t
+    for (const Update &update : updates) {
+        const std::string binary = encodeFrame(update.opcode, update.payload, update.length);
+        const size_t asciiLength = strlen(update.ascii);
+        TEST_ASSERT_LESS_THAN(asciiLength, binary.size());
+
+        ParserClass parser;
+        auto start = std::chrono::steady_clock::now();
+        for (uint16_t i = 0; i < repetitions; ++i) {
+            for (size_t pos = 0; pos < asciiLength; ++pos) {
+                if (parser.receiveChar(update.ascii[pos])) {
+                    eventQueue.addEvent(parser.getEvent());
+                }
+            }
+            drainEvents();
+        }
+        const double asciiNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        for (uint16_t i = 0; i < repetitions; ++i) {
+            receiveBytes(binary);
+            drainEvents();
+        }
+        const double binaryNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        TEST_ASSERT_EQUAL(repetitions, protocol.getFramesReceived());
+
+        printf("%-16.*s Klartext %2u Bytes %6.1f ns, binär %2u Bytes %6.1f ns\n",
+               static_cast<int>(asciiLength - 1), update.ascii, static_cast<unsigned>(asciiLength),
+               asciiNs / repetitions, static_cast<unsigned>(binary.size()), binaryNs / repetitions);
+        protocol = ProtocolClass();
+        protocol.setMode(ProtocolMode::BINARY);
+    }
+}
+
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_crc8MatchesCheckValue);
+    RUN_TEST(test_encodingMatchesReferenceVectors);
+    RUN_TEST(test_roundTripRestoresFrameAndCrc);
+    RUN_TEST(test_maximumFrameLengthRoundTrips);
+    RUN_TEST(test_recordIsTranslatedIntoEvent);
+    RUN_TEST(test_badCrcIsRejected);
+    RUN_TEST(test_singleBitErrorsAreRejected);
+    RUN_TEST(test_invalidCobsCodeIsRejected);
+    RUN_TEST(test_overlongFrameIsDiscardedAndReceptionRecovers);
+    RUN_TEST(test_recordBeyondFrameEndIsRejected);
+    RUN_TEST(test_benchmarkAgainstAscii);
+    return UNITY_END();
+}
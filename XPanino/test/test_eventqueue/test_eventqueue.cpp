@@ -0,0 +1,326 @@
+/*********************************************************************************************************//**
+ * @file test_eventqueue.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Belastungstest der Eventqueue: Überlauf der Indizes, volle Queue und Zusammenfassen von Zustandsmeldungen.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ * Neben gezielten Fällen läuft eine zufällige (reproduzierbare) Folge von Erzeuger- und Verbraucherschritten
+ * gegen ein einfaches Modell der Eventqueue mit std::deque. Wie auf dem Uno zählen im env:native
+ * -Wl,--wrap=malloc -Wl,--wrap=free die Anforderungen von Heap-Speicher (MemoryMonitorClass); die Eventqueue
+ * darf keine stellen. Der Aufwand je addEvent()/Abholen wird im ungünstigsten Fall gemessen und begrenzt.
+ *
+ ************************************************************************************************************/
+
+#include <unity.h>
+#include <chrono>
+#include <deque>
+#include <event.hpp>
+#include <memmonitor.hpp>
+
+const double MAX_NS_PER_OPERATION = 1000.0;     ///< Obergrenze auf dem PC für addEvent() und Abholen zusammen
+
+
+/// Ein Event mit laufender Nummer in parameter1 anlegen.
+static EventClass makeEvent(const TokenId deviceId, const TokenId eventId, const uint16_t number) {
+    EventClass event;
+    event.deviceId = deviceId;
+    event.eventId = eventId;
+    snprintf(event.parameter1, MAX_PARA_LENGTH, "%u", number);
+    return event;
+}
+
+
+/// Ein Event, das nicht zusammengefasst wird (Schalter-Ereignis).
+static EventClass makePlainEvent(const uint16_t number) { return makeEvent(TokenId::DEV_PB, TokenId::EV_ON, number); }
+
+/// Eine Zustandsmeldung, die zusammengefasst wird.
+static EventClass makeCodeEvent(const uint16_t number) { return makeEvent(TokenId::DEV_XPDR, TokenId::EV_CODE, number); }
+
+
+/// Das älteste Event abholen, seine Nummer liefern und es entfernen.
+static long takeNumber(EventQueueClass &queue) {
+    const EventClass *event = queue.getHeadEvent();
+    if (event == nullptr) {
+        return -1;
+    }
+    const long number = atol(event->parameter1);
+    queue.removeHeadEvent();
+    return number;
+}
+
+
+void setUp() {}
+
+void tearDown() {}
+
+
+void test_fifoOrderSurvivesIndexWrap() {
+    EventQueueClass queue;
+    uint16_t added = 0;
+    uint16_t taken = 0;
+    // Mehr als 256 Events, damit head und tail (uint8_t) mehrmals überlaufen; Füllstand wechselt
+    for (uint16_t round = 0; round < 400; ++round) {
+        const uint8_t burst = static_cast<uint8_t>(1 + round % EVENT_QUEUE_SIZE);
+        for (uint8_t i = 0; (i < burst) && (queue.getCount() < EVENT_QUEUE_SIZE); ++i) {
+            TEST_ASSERT_TRUE(queue.addEvent(makePlainEvent(added++)));
+        }
+        while (queue.getCount() > round % 3) {
+            TEST_ASSERT_EQUAL(taken++, takeNumber(queue));
+        }
+    }
+    while (queue.getCount() > 0) {
+        TEST_ASSERT_EQUAL(taken++, takeNumber(queue));
+    }
+    TEST_ASSERT_GREATER_THAN(600, added);
+    TEST_ASSERT_EQUAL(added, taken);
+    TEST_ASSERT_EQUAL(0, queue.getDropped());
+    TEST_ASSERT_EQUAL(EVENT_QUEUE_SIZE, queue.getHighWater());
+    TEST_ASSERT_NULL(queue.getHeadEvent());
+}
+
+
+void test_fullQueueDropsNewestAndReportsOnce() {
+    EventQueueClass queue;
+    for (uint8_t i = 0; i < EVENT_QUEUE_SIZE; ++i) {
+        TEST_ASSERT_TRUE(queue.addEvent(makePlainEvent(i)));
+    }
+    TEST_ASSERT_FALSE(queue.addEvent(makeEvent(TokenId::DEV_PA1, TokenId::EV_OFF, 100)));
+    TEST_ASSERT_FALSE(queue.addEvent(makeEvent(TokenId::DEV_PA2, TokenId::EV_LON, 101)));
+    TEST_ASSERT_EQUAL(EVENT_QUEUE_SIZE, queue.getCount());
+    TEST_ASSERT_EQUAL(2, queue.getDropped());
+
+    TokenId deviceId;
+    TokenId eventId;
+    TEST_ASSERT_TRUE(queue.takeDropped(deviceId, eventId));
+    TEST_ASSERT_EQUAL(TokenId::DEV_PA2, deviceId);     // das zuletzt verworfene Event
+    TEST_ASSERT_EQUAL(TokenId::EV_LON, eventId);
+    TEST_ASSERT_FALSE(queue.takeDropped(deviceId, eventId));
+
+    // Die ältesten Events bleiben erhalten
+    for (uint8_t i = 0; i < EVENT_QUEUE_SIZE; ++i) {
+        TEST_ASSERT_EQUAL(i, takeNumber(queue));
+    }
+    TEST_ASSERT_TRUE(queue.addEvent(makePlainEvent(200)));
+    TEST_ASSERT_FALSE(queue.takeDropped(deviceId, eventId));
+}
+
+
+void test_addEventSendsNothing() {
+    hostReset();
+    EventQueueClass queue;
+    for (uint8_t i = 0; i < 2 * EVENT_QUEUE_SIZE; ++i) {
+        queue.addEvent(makePlainEvent(i));
+    }
+    TEST_ASSERT_EQUAL(EVENT_QUEUE_SIZE, queue.getDropped());
+    TEST_ASSERT_EQUAL_STRING("", Serial.hostTakeOutput().c_str());
+}
+
+
+void test_pendingStateIsReplacedInPlace() {
+    EventQueueClass queue;
+    queue.addEvent(makePlainEvent(1));
+    queue.addEvent(makeCodeEvent(1200));
+    queue.addEvent(makePlainEvent(2));
+    TEST_ASSERT_TRUE(queue.addEvent(makeCodeEvent(7000)));
+    TEST_ASSERT_TRUE(queue.addEvent(makeCodeEvent(7700)));
+    TEST_ASSERT_EQUAL(3, queue.getCount());
+    TEST_ASSERT_EQUAL(2, queue.getSuperseded());
+
+    // Position der ersten Meldung, Wert der letzten
+    TEST_ASSERT_EQUAL(1, takeNumber(queue));
+    TEST_ASSERT_EQUAL(7700, takeNumber(queue));
+    TEST_ASSERT_EQUAL(2, takeNumber(queue));
+}
+
+
+void test_headEventIsNeverReplaced() {
+    EventQueueClass queue;
+    queue.addEvent(makeCodeEvent(1200));    // am Kopf: könnte gerade verarbeitet werden
+    queue.addEvent(makeCodeEvent(7000));
+    TEST_ASSERT_EQUAL(2, queue.getCount());
+    TEST_ASSERT_EQUAL(0, queue.getSuperseded());
+    queue.addEvent(makeCodeEvent(7700));
+    TEST_ASSERT_EQUAL(2, queue.getCount());
+    TEST_ASSERT_EQUAL(1200, takeNumber(queue));
+    TEST_ASSERT_EQUAL(7700, takeNumber(queue));
+}
+
+
+void test_stateReplacesEvenWhenQueueIsFull() {
+    EventQueueClass queue;
+    queue.addEvent(makePlainEvent(0));
+    queue.addEvent(makeCodeEvent(1200));
+    for (uint8_t i = 2; i < EVENT_QUEUE_SIZE; ++i) {
+        queue.addEvent(makePlainEvent(i));
+    }
+    TEST_ASSERT_TRUE(queue.addEvent(makeCodeEvent(7000)));
+    TEST_ASSERT_EQUAL(0, queue.getDropped());
+    TEST_ASSERT_FALSE(queue.addEvent(makeEvent(TokenId::DEV_M803, TokenId::EV_TIME, 1)));  // andere Meldung
+    TEST_ASSERT_EQUAL(1, queue.getDropped());
+}
+
+
+/**
+ * @brief Zufällige Folge von Erzeuger- und Verbraucherschritten gegen ein Modell mit std::deque.
+ */
+void test_randomOperationsMatchModel() {
+    EventQueueClass queue;
+    std::deque<EventClass> model;
+    unsigned long modelDropped = 0;
+    unsigned long modelSuperseded = 0;
+    uint32_t seed = 2024;
+    uint16_t number = 0;
+
+    for (uint32_t step = 0; step < 100000; ++step) {
+        seed = seed * 1103515245 + 12345;
+        const uint8_t dice = static_cast<uint8_t>((seed >> 16) % 100);
+        if (dice < 55) {
+            // Erzeuger: teils Schalter, teils Zustandsmeldungen zweier Devices
+            const EventClass event = (dice < 25) ? makePlainEvent(number)
+                                   : ((dice < 40) ? makeCodeEvent(number)
+                                                  : makeEvent(TokenId::DEV_M803, TokenId::EV_UT, number));
+            ++number;
+            bool isReplaced = false;
+            if (isStateToken(event.eventId)) {
+                for (size_t i = 1; (i < model.size()) && ! isReplaced; ++i) {
+                    if ((model[i].deviceId == event.deviceId) && (model[i].eventId == event.eventId)) {
+                        model[i] = event;
+                        isReplaced = true;
+                        ++modelSuperseded;
+                    }
+                }
+            }
+            if (! isReplaced) {
+                if (model.size() >= EVENT_QUEUE_SIZE) {
+                    ++modelDropped;
+                } else {
+                    model.push_back(event);
+                }
+            }
+            queue.addEvent(event);
+        } else {
+            // Verbraucher
+            const EventClass *head = queue.getHeadEvent();
+            if (model.empty()) {
+                TEST_ASSERT_NULL(head);
+            } else {
+                TEST_ASSERT_NOT_NULL(head);
+                TEST_ASSERT_EQUAL(model.front().deviceId, head->deviceId);
+                TEST_ASSERT_EQUAL_STRING(model.front().parameter1, head->parameter1);
+                queue.removeHeadEvent();
+                model.pop_front();
+            }
+        }
+        TEST_ASSERT_EQUAL(model.size(), queue.getCount());
+    }
+    TEST_ASSERT_EQUAL(modelDropped, queue.getDropped());
+    TEST_ASSERT_EQUAL(modelSuperseded, queue.getSuperseded());
+    TEST_ASSERT_GREATER_THAN(0, modelDropped);
+    TEST_ASSERT_GREATER_THAN(0, modelSuperseded);
+    TEST_ASSERT_LESS_OR_EQUAL(EVENT_QUEUE_SIZE, queue.getHighWater());
+}
+
+
+/*********************************************************************************************************//**
+ * Heap und Aufwand je Operation
+ ************************************************************************************************************/
+void test_addTakeAndCoalesceUseNoHeap() {
+    #ifndef MEM_WRAP_MALLOC
+    TEST_IGNORE_MESSAGE("nur mit -DMEM_WRAP_MALLOC -Wl,--wrap=malloc -Wl,--wrap=free (env:native)");
+    #endif
+    // Die Zähler sind wirksam
+    const uint16_t probeAllocations = MemoryMonitorClass::getAllocations();
+    void *volatile probe = malloc(16);
+    free(probe);
+    TEST_ASSERT_EQUAL(probeAllocations + 1, MemoryMonitorClass::getAllocations());
+
+    const EventClass plain = makePlainEvent(1);
+    const EventClass code = makeCodeEvent(7000);
+    const uint16_t allocations = MemoryMonitorClass::getAllocations();
+    const uint16_t frees = MemoryMonitorClass::getFrees();
+    EventQueueClass queue;
+    TokenId deviceId;
+    TokenId eventId;
+    for (uint16_t round = 0; round < 1000; ++round) {
+        queue.addEvent(code);
+        for (uint8_t i = 0; i <= EVENT_QUEUE_SIZE; ++i) {
+            queue.addEvent(plain);      // zuletzt bei voller Eventqueue: verworfen
+            queue.addEvent(code);       // zusammengefasst
+        }
+        queue.takeDropped(deviceId, eventId);
+        while (queue.getHeadEvent() != nullptr) {
+            queue.removeHeadEvent();
+        }
+    }
+    TEST_ASSERT_GREATER_THAN(0, queue.getDropped());
+    TEST_ASSERT_GREATER_THAN(0, queue.getSuperseded());
+    TEST_ASSERT_EQUAL(allocations, MemoryMonitorClass::getAllocations());
+    TEST_ASSERT_EQUAL(frees, MemoryMonitorClass::getFrees());
+}
+
+
+/**
+ * @brief Aufwand je addEvent() und Abholen (getHeadEvent(), removeHeadEvent()) im ungünstigsten Fall:
+ *        bei fast voller Eventqueue eine Zustandsmeldung, die keine wartende ersetzt. addEvent() vergleicht
+ *        dann alle EVENT_QUEUE_SIZE - 1 wartenden Plätze; mehr Arbeit gibt es je Operation nicht.
+ */
+void test_workPerOperationIsBounded() {
+    const TokenId states[] = {TokenId::EV_CODE, TokenId::EV_F, TokenId::EV_TIME, TokenId::EV_LT, TokenId::EV_UT,
+                              TokenId::EV_ET, TokenId::EV_FT, TokenId::EV_V, TokenId::EV_Q, TokenId::EV_A,
+                              TokenId::EV_C};
+    const uint8_t stateCount = sizeof(states) / sizeof(states[0]);
+    static_assert(stateCount > EVENT_QUEUE_SIZE, "Zu wenige Zustandsmeldungen für den ungünstigsten Fall.");
+    EventClass events[stateCount];
+    for (uint8_t i = 0; i < stateCount; ++i) {
+        events[i] = makeEvent(TokenId::DEV_XPDR, states[i], i);
+        TEST_ASSERT_TRUE(isStateToken(states[i]));
+    }
+
+    const uint32_t repetitions = 1000000;
+    const EventClass plain = makePlainEvent(1);
+    double nsPerOperation[2];
+    for (uint8_t worstCase = 0; worstCase < 2; ++worstCase) {
+        EventQueueClass queue;
+        uint8_t next = 0;
+        if (worstCase != 0) {
+            // Die zuletzt gesendeten EVENT_QUEUE_SIZE - 1 Meldungen warten; die nächste ist keine davon
+            for (; next < EVENT_QUEUE_SIZE - 1; ++next) {
+                queue.addEvent(events[next]);
+            }
+        }
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < repetitions; ++i) {
+            queue.addEvent((worstCase != 0) ? events[next] : plain);
+            next = (next + 1 == stateCount) ? 0 : next + 1;
+            if (queue.getHeadEvent() != nullptr) {
+                queue.removeHeadEvent();
+            }
+        }
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        nsPerOperation[worstCase] = ns / repetitions;
+        TEST_ASSERT_EQUAL(0, queue.getDropped());
+        TEST_ASSERT_EQUAL(0, queue.getSuperseded());
+        TEST_ASSERT_EQUAL((worstCase != 0) ? EVENT_QUEUE_SIZE - 1 : 0, queue.getCount());
+    }
+    printf("Eventqueue: addEvent() + Abholen %.1f ns bei leerer, %.1f ns bei fast voller Eventqueue\n",
+           nsPerOperation[0], nsPerOperation[1]);
+    TEST_ASSERT_TRUE(nsPerOperation[1] < MAX_NS_PER_OPERATION);
+}
+
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_fifoOrderSurvivesIndexWrap);
+    RUN_TEST(test_fullQueueDropsNewestAndReportsOnce);
+    RUN_TEST(test_addEventSendsNothing);
+    RUN_TEST(test_pendingStateIsReplacedInPlace);
+    RUN_TEST(test_headEventIsNeverReplaced);
+    RUN_TEST(test_stateReplacesEvenWhenQueueIsFull);
+    RUN_TEST(test_randomOperationsMatchModel);
+    RUN_TEST(test_addTakeAndCoalesceUseNoHeap);
+    RUN_TEST(test_workPerOperationIsBounded);
+    return UNITY_END();
+}
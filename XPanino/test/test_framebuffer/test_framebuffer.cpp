@@ -0,0 +1,339 @@
+/*********************************************************************************************************//**
+ * @file test_framebuffer.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Rohdaten-Modus: LED-Matrix direkt vom PC, Frame-Zähler und erreichbare Bildrate.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ * Die Records werden wie vom PC als kodierte Frames über ProtocolClass::receiveByte() empfangen. Für
+ * Bildrate und Latenz laufen setup() und loop() aus main.cpp mit der simulierten Uhr; die Bytes kommen
+ * im Takt der ausgehandelten Baudrate an, die Anzeige wird an den Pins der Schieberegister mitgelesen.
+ * Geprüft werden mindestens 30 Bilder je Sekunde, die Latenz bis zum Refresh und der Empfangspuffer.
+ *
+ ************************************************************************************************************/
+
+#include <unity.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <commands.hpp>
+#include <event.hpp>
+#include <framebuffer.hpp>
+#include <heartbeat.hpp>
+#include <ledmatrix.hpp>
+#include <link.hpp>
+#include <linkspeed.hpp>
+#include <protocol.hpp>
+#include <scheduler.hpp>
+#include <statesync.hpp>
+#include <txqueue.hpp>
+
+extern EventQueueClass eventQueue;
+extern FramebufferClass framebuffer;
+extern HeartbeatClass heartbeat;
+extern LedMatrix leds;
+extern LinkClass linkLayer;
+extern LinkSpeedClass linkSpeed;
+extern ProtocolClass protocol;
+extern SchedulerClass scheduler;
+extern StateSyncClass stateSync;
+extern TxQueueClass txQueue;
+
+void setup();
+void loop();
+void serialEvent();
+
+const uint8_t HALF_ROWS = LED_ROWS / 2;     ///< Zeilen je Record bei einer vollständigen Matrix
+
+
+/// Einen Record FRAMEBUFFER mit den Zeilen aus rowMask aufbauen; Zeile n hat den Wert base + n.
+static std::vector<uint8_t> makeRecord(const uint8_t frame, const uint8_t rowMask, const uint32_t base) {
+    std::vector<uint8_t> record {frame, rowMask};
+    for (uint8_t row = 0; row < LED_ROWS; ++row) {
+        if ((rowMask & (1 << row)) != 0) {
+            for (int shift = 24; shift >= 0; shift -= 8) {
+                record.push_back(static_cast<uint8_t>((base + row) >> shift));
+            }
+        }
+    }
+    return record;
+}
+
+
+/// Einen Record wie vom PC kodiert senden; liefert die Anzahl Bytes auf der Leitung.
+static size_t receiveRecord(const uint16_t opcode, const std::vector<uint8_t> &payload) {
+    protocol.beginFrame();
+    TEST_ASSERT_TRUE(protocol.addRecord(opcode, payload.data(), static_cast<uint8_t>(payload.size())));
+    protocol.endFrame();
+    const std::string bytes = Serial.hostTakeOutput();
+    for (const char inByte : bytes) {
+        protocol.receiveByte(static_cast<uint8_t>(inByte));
+    }
+    return bytes.size();
+}
+
+
+/// Eine vollständige Matrix als zwei Records mit demselben Frame-Zähler senden.
+static size_t receiveFullFrame(const uint8_t frame, const uint32_t base) {
+    const uint8_t lowRows = (1 << HALF_ROWS) - 1;
+    return receiveRecord(FRAMEBUFFER, makeRecord(frame, lowRows, base))
+           + receiveRecord(FRAMEBUFFER, makeRecord(frame, static_cast<uint8_t>(~lowRows), base));
+}
+
+
+void setUp() {
+    hostReset();
+    protocol = ProtocolClass();
+    protocol.setMode(ProtocolMode::BINARY);
+    linkLayer = LinkClass();
+    leds = LedMatrix();
+    framebuffer = FramebufferClass();
+    stateSync = StateSyncClass();
+    framebuffer.setActive(true);
+}
+
+
+void tearDown() {}
+
+
+void test_recordsAreRejectedWhenInactive() {
+    framebuffer.setActive(false);
+    receiveRecord(FRAMEBUFFER, makeRecord(1, 0x01, 0x100));
+    TEST_ASSERT_EQUAL(1, framebuffer.getRejected());
+    TEST_ASSERT_EQUAL_HEX32(0, leds.getStateWord(0));
+}
+
+
+void test_fullMatrixInTwoRecordsIsOneFrame() {
+    receiveFullFrame(1, 0xA0000000);
+    TEST_ASSERT_EQUAL(1, framebuffer.getFrames());
+    for (uint8_t row = 0; row < LED_ROWS; ++row) {
+        TEST_ASSERT_EQUAL_HEX32(0xA0000000 + row, leds.getStateWord(row));
+    }
+    TEST_ASSERT_EQUAL(0, framebuffer.getRejected());
+}
+
+
+void test_onlyDirtyRowsAreChanged() {
+    receiveFullFrame(1, 0x100);
+    receiveRecord(FRAMEBUFFER, makeRecord(2, 0x24, 0x200));    // Zeilen 2 und 5
+    TEST_ASSERT_EQUAL_HEX32(0x202, leds.getStateWord(2));
+    TEST_ASSERT_EQUAL_HEX32(0x205, leds.getStateWord(5));
+    TEST_ASSERT_EQUAL_HEX32(0x103, leds.getStateWord(3));
+    TEST_ASSERT_EQUAL(2, framebuffer.getFrames());
+}
+
+
+void test_gapsInFrameCounterAreLostFrames() {
+    receiveRecord(FRAMEBUFFER, makeRecord(250, 0x01, 0));
+    receiveRecord(FRAMEBUFFER, makeRecord(251, 0x01, 0));
+    receiveRecord(FRAMEBUFFER, makeRecord(254, 0x01, 0));      // 252 und 253 fehlen
+    receiveRecord(FRAMEBUFFER, makeRecord(1, 0x01, 0));        // Überlauf; 255 und 0 fehlen
+    TEST_ASSERT_EQUAL(4, framebuffer.getFrames());
+    TEST_ASSERT_EQUAL(4, framebuffer.getLostFrames());
+}
+
+
+void test_malformedRecordsChangeNothing() {
+    std::vector<uint8_t> shortRecord = makeRecord(1, 0x03, 0x300);
+    shortRecord.pop_back();                                     // zweite Zeile unvollständig
+    receiveRecord(FRAMEBUFFER, shortRecord);
+    receiveRecord(FRAMEBUFFER, {1});                            // ohne Zeilenmaske
+    TEST_ASSERT_EQUAL(2, framebuffer.getRejected());
+    TEST_ASSERT_EQUAL(0, framebuffer.getFrames());
+    TEST_ASSERT_EQUAL_HEX32(0, leds.getStateWord(0));
+}
+
+
+void test_leavingModeInvalidatesStateSync() {
+    leds.setStateWord(LED_ROWS, 0xFF);                          // Blinken wird im Rohdaten-Modus umgangen
+    framebuffer.setActive(false);
+    framebuffer.setActive(true);
+    TEST_ASSERT_EQUAL_HEX32(0, leds.getStateWord(LED_ROWS));
+    const uint8_t snapshot[] = {4, STATE_FLAG_FIRST | STATE_FLAG_LAST};
+    stateSync.receiveSnapshot(snapshot, sizeof(snapshot), 0);
+    TEST_ASSERT_EQUAL(4, stateSync.getVersion());
+    receiveFullFrame(1, 0x100);
+    receiveRecord(FRAMEBUFFER_MODE, {0});
+    TEST_ASSERT_FALSE(framebuffer.isActive());
+    TEST_ASSERT_EQUAL(0, stateSync.getVersion());
+    for (uint8_t row = 0; row < LED_ROWS; ++row) {
+        TEST_ASSERT_EQUAL_HEX32(0, leds.getStateWord(row));
+    }
+}
+
+
+/*********************************************************************************************************//**
+ * Bildrate und Latenz mit setup() und loop() aus main.cpp
+ ************************************************************************************************************/
+const uint8_t CLOCK = PIN4;     ///< Pins der Schieberegister wie in ledmatrix.cpp
+const uint8_t DATA_IN = PIN5;
+const uint8_t STRB = PIN3;
+
+const unsigned long PASS_MICROS = 250;      ///< Simulierte Zeit je loop()-Durchlauf zusätzlich zur LED-Ansteuerung
+const uint8_t RATE_FRAMES = 20;             ///< Anzahl der Bilder, die ohne Pause nacheinander gesendet werden
+const unsigned long MAX_LATENCY_MICROS = 2000;  ///< Höchstens zwei Durchläufe vom letzten Byte bis zur Anzeige
+const uint8_t RX_BUFFER_SIZE = 64;          ///< Empfangspuffer der seriellen Schnittstelle des Uno
+
+static uint64_t shiftRegister = 0;          ///< Inhalt der Schieberegister
+static uint8_t lastClockLevel = LOW;        ///< Pegel an CLOCK, um die steigende Flanke zu erkennen
+static uint32_t latchedRows[LED_ROWS];      ///< Zuletzt an die Outputs geschaltete Columns je Row
+
+/// Nachbildung der Schieberegister der LED-Matrix: 32 Column-Bits, dann 8 Row-Bits; STRB = HIGH übernimmt.
+static void onPinWrite(const uint8_t pin, const uint8_t level) {
+    if ((pin == CLOCK) && (level == HIGH) && (lastClockLevel == LOW)) {
+        shiftRegister = (shiftRegister << 1) | hostGetPinLevel(DATA_IN);
+    }
+    if (pin == CLOCK) {
+        lastClockLevel = level;
+    }
+    if ((pin == STRB) && (level == HIGH)) {
+        const uint8_t rowBits = static_cast<uint8_t>(shiftRegister & 0xFF);
+        for (uint8_t row = 0; row < LED_ROWS; ++row) {
+            if (rowBits == (1U << row)) {
+                latchedRows[row] = static_cast<uint32_t>(shiftRegister >> 8);
+            }
+        }
+    }
+}
+
+
+/// Zeigen die Outputs der Schieberegister das Bild mit dem Wert base (Zeile n = base + n)?
+static bool isShown(const uint32_t base) {
+    for (uint8_t row = 0; row < LED_ROWS; ++row) {
+        if (latchedRows[row] != base + row) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/// Ergebnis eines Durchgangs bei einer Baudrate.
+struct RateResult {
+    double fps;                     ///< Angezeigte Bilder je Sekunde
+    double lineFps;                 ///< Bilder je Sekunde, die die Leitung zulässt
+    unsigned long maxLatency;       ///< Längste Zeit in µs vom letzten Byte eines Bildes bis zur Anzeige
+    size_t maxRxPending;            ///< Höchste Belegung des Empfangspuffers vor serialEvent()
+    uint8_t skipped;                ///< Bilder, die vom nächsten überholt und nie angezeigt wurden
+};
+
+
+/**
+ * @brief RATE_FRAMES vollständige Bilder ohne Pause mit der ausgehandelten Baudrate empfangen.
+ *
+ * Die Bytes kommen im Abstand von 10 Bits (8N1) an; jeder Durchlauf besteht aus serialEvent() und loop()
+ * wie im Arduino-Core. Als Anzeige zählt der erste Refresh, nach dem alle Zeilen das neue Bild zeigen.
+ */
+static RateResult runFrames(const unsigned long baud) {
+    // Die Bilder wie der PC kodieren
+    std::string wire;
+    std::vector<size_t> frameEnd;
+    for (uint8_t frame = 1; frame <= RATE_FRAMES; ++frame) {
+        const uint8_t lowRows = (1 << HALF_ROWS) - 1;
+        const uint32_t base = static_cast<uint32_t>(frame) << 24;
+        for (const uint8_t rowMask : {lowRows, static_cast<uint8_t>(~lowRows)}) {
+            const std::vector<uint8_t> record = makeRecord(frame, rowMask, base);
+            protocol.beginFrame();
+            TEST_ASSERT_TRUE(protocol.addRecord(FRAMEBUFFER, record.data(), static_cast<uint8_t>(record.size())));
+            protocol.endFrame();
+            wire += Serial.hostTakeOutput();
+        }
+        frameEnd.push_back(wire.size());
+    }
+
+    Serial.begin(baud);
+    const double byteMicros = 10.0 * 1000000.0 / baud;
+    const unsigned long start = micros();
+    RateResult result {0.0, baud / (10.0 * wire.size() / RATE_FRAMES), 0, 0, 0};
+    size_t delivered = 0;
+    uint8_t next = 0;                           // nächstes noch nicht angezeigtes Bild
+    uint8_t shown = 0;
+    unsigned long lastShown = start;
+    while ((next < RATE_FRAMES) && (micros() - start < 1000000UL)) {
+        // Alle bis jetzt vollständig übertragenen Bytes in den Empfangspuffer legen
+        const size_t arrived = std::min(wire.size(), static_cast<size_t>((micros() - start) / byteMicros));
+        if (arrived > delivered) {
+            Serial.hostReceive(reinterpret_cast<const uint8_t *>(wire.data() + delivered), arrived - delivered);
+            delivered = arrived;
+        }
+        result.maxRxPending = std::max(result.maxRxPending, static_cast<size_t>(Serial.available()));
+        serialEvent();
+        loop();
+        hostAdvanceMicros(PASS_MICROS);
+        Serial.hostTakeOutput();
+        // Sind in einem Durchlauf mehrere Bilder angekommen, wird nur das letzte angezeigt
+        for (uint8_t frame = next; frame < RATE_FRAMES; ++frame) {
+            if ((delivered >= frameEnd[frame]) && isShown(static_cast<uint32_t>(frame + 1) << 24)) {
+                const unsigned long received = start + static_cast<unsigned long>(frameEnd[frame] * byteMicros);
+                result.maxLatency = std::max(result.maxLatency, micros() - received);
+                result.skipped += frame - next;
+                lastShown = micros();
+                ++shown;
+                next = frame + 1;
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL(RATE_FRAMES, next);
+    TEST_ASSERT_EQUAL(RATE_FRAMES, framebuffer.getFrames());
+    TEST_ASSERT_EQUAL(0, framebuffer.getLostFrames());
+    result.fps = shown * 1000000.0 / (lastShown - start);
+    return result;
+}
+
+
+/**
+ * @brief Bildrate und Latenz einer vollständigen Matrix (zwei Frames auf der Leitung) je Baudrate:
+ *        vom Empfang über serialEvent() bis zum Refresh in loop(), gemessen an den Schieberegistern.
+ */
+void test_frameRateAtNegotiatedBaud() {
+    scheduler = SchedulerClass();
+    txQueue = TxQueueClass();
+    eventQueue = EventQueueClass();
+    linkSpeed = LinkSpeedClass();
+    heartbeat = HeartbeatClass();
+    hostSetMillis(1000);
+    setup();
+    Serial.hostTakeOutput();
+    protocol.setMode(ProtocolMode::BINARY);
+    framebuffer.setActive(true);
+    shiftRegister = 0;
+    lastClockLevel = LOW;
+    memset(latchedRows, 0, sizeof(latchedRows));
+    hostSetPinHook(onPinWrite);
+
+    const unsigned long bauds[] = {250000UL, 500000UL, 1000000UL};
+    for (const unsigned long baud : bauds) {
+        framebuffer = FramebufferClass();
+        framebuffer.setActive(true);
+        const RateResult result = runFrames(baud);
+        printf("Rohdaten-Modus %7lu Baud: %6.1f Bilder/s (Leitung %6.1f), Latenz höchstens %4lu µs, "
+               "Empfangspuffer höchstens %2u Bytes, %u überholt\n",
+               baud, result.fps, result.lineFps, result.maxLatency, static_cast<unsigned>(result.maxRxPending), result.skipped);
+        TEST_ASSERT_TRUE(result.fps >= 30.0);
+        TEST_ASSERT_TRUE(result.maxLatency <= MAX_LATENCY_MICROS);
+        // Bis 500 kBaud begrenzt nur die Leitung die Bildrate. Bei 1 MBaud kommen während eines Durchlaufs
+        // mit Refresh mehr Bytes an, als der Empfangspuffer fasst, und Bilder werden überholt.
+        if (baud <= 500000UL) {
+            TEST_ASSERT_EQUAL(0, result.skipped);
+            TEST_ASSERT_TRUE(result.fps >= 0.9 * result.lineFps);
+            TEST_ASSERT_TRUE(result.maxRxPending < RX_BUFFER_SIZE);
+        }
+    }
+    hostSetPinHook(nullptr);
+}
+
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_recordsAreRejectedWhenInactive);
+    RUN_TEST(test_fullMatrixInTwoRecordsIsOneFrame);
+    RUN_TEST(test_onlyDirtyRowsAreChanged);
+    RUN_TEST(test_gapsInFrameCounterAreLostFrames);
+    RUN_TEST(test_malformedRecordsChangeNothing);
+    RUN_TEST(test_leavingModeInvalidatesStateSync);
+    RUN_TEST(test_frameRateAtNegotiatedBaud);
+    return UNITY_END();
+}
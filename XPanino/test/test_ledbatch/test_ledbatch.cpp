@@ -0,0 +1,299 @@
+/*********************************************************************************************************//**
+ * @file test_ledbatch.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Sammelkommandos für die LED-Matrix: alle Änderungen gemeinsam oder gar keine.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ * Ein gültiges Sammelkommando erzeugt genau ein Event @em LED;BAT und ändert die LED-Matrix erst, wenn
+ * das Event verarbeitet wird. Ist eine Änderung fehlerhaft, bleibt die LED-Matrix unverändert. Mehrere
+ * wartende Sammelkommandos werden in der Reihenfolge ihrer Events angewendet; ein gesicherter Frame ohne
+ * Platz wird nicht bestätigt. Zum Schluss wird der Aufwand für Empfang und Anwendung je Änderung gemessen.
+ *
+ ************************************************************************************************************/
+
+#include <unity.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <commands.hpp>
+#include <dispatcher.hpp>
+#include <event.hpp>
+#include <ledbatch.hpp>
+#include <ledmatrix.hpp>
+#include <link.hpp>
+#include <protocol.hpp>
+
+extern DispatcherClass dispatcher;
+extern EventQueueClass eventQueue;
+extern LedBatchClass ledBatch;
+extern LedMatrix leds;
+extern LinkClass linkLayer;
+extern ProtocolClass protocol;
+
+const uint8_t ON = static_cast<uint8_t>(LedBatchOp::LED_ON);
+const uint8_t OFF = static_cast<uint8_t>(LedBatchOp::LED_OFF);
+const uint8_t BLINK = static_cast<uint8_t>(LedBatchOp::BLINK_ON);
+const uint8_t DISP = static_cast<uint8_t>(LedBatchOp::DISPLAY);
+
+
+/// Das anstehende Event wie der Dispatcher an die LedBatchClass übergeben.
+static void dispatch(LedBatchClass &batch) {
+    EventClass *event = eventQueue.getHeadEvent();
+    TEST_ASSERT_NOT_NULL(event);
+    TEST_ASSERT_EQUAL(TokenId::DEV_LED, event->deviceId);
+    TEST_ASSERT_EQUAL(TokenId::EV_BAT, event->eventId);
+    batch.processEvent(event);
+    eventQueue.removeHeadEvent();
+}
+
+
+/// Ein Sammelkommando wie der PC als Frame kodieren; mit Folgenummer als gesicherter Frame.
+static std::string encodeFromPc(const std::vector<uint8_t> &payload, const int sequence = -1) {
+    ProtocolClass pc;
+    pc.beginFrame();
+    if (sequence >= 0) {
+        const uint8_t seq = static_cast<uint8_t>(sequence);
+        pc.addRecord(SEQUENCE, &seq, 1);
+    }
+    TEST_ASSERT_TRUE(pc.addRecord(LED_BATCH, payload.data(), static_cast<uint8_t>(payload.size())));
+    pc.endFrame();
+    return Serial.hostTakeOutput();
+}
+
+
+/// Bytes des PCs an den Arduino übergeben.
+static void deliver(const std::string &bytes) {
+    for (const char inByte : bytes) {
+        protocol.receiveByte(static_cast<uint8_t>(inByte));
+    }
+}
+
+
+void setUp() {
+    hostReset();
+    eventQueue = EventQueueClass();
+    leds = LedMatrix();
+    ledBatch = LedBatchClass();
+    protocol = ProtocolClass();
+    protocol.setMode(ProtocolMode::BINARY);
+    linkLayer = LinkClass();
+}
+
+
+void tearDown() {}
+
+
+void test_validBatchIsAppliedWithItsEvent() {
+    LedBatchClass batch;
+    const uint8_t payload[] = {ON, 0, 1,  ON, 7, 31,  BLINK, 2, 3, BLINK_NORMAL};
+    TEST_ASSERT_TRUE(batch.receive(payload, sizeof(payload)));
+    TEST_ASSERT_EQUAL(1, eventQueue.getCount());
+    TEST_ASSERT_FALSE(leds.isLedOn({0, 1}));    // erst mit dem Event
+
+    dispatch(batch);
+    TEST_ASSERT_TRUE(leds.isLedOn({0, 1}));
+    TEST_ASSERT_TRUE(leds.isLedOn({7, 31}));
+    TEST_ASSERT_TRUE(leds.isLedBlinkOn({2, 3}));
+    TEST_ASSERT_EQUAL(1, batch.getApplied());
+    TEST_ASSERT_EQUAL(0, batch.getRejected());
+
+    batch.processEvent(nullptr);                // nichts mehr zwischengespeichert
+    TEST_ASSERT_EQUAL(1, batch.getApplied());
+}
+
+
+void test_invalidChangeRejectsWholeBatch() {
+    LedBatchClass batch;
+    const uint8_t corpus[][7] = {
+        {ON, 0, 1,  ON, LED_ROWS, 0, 0},        // Zeile außerhalb der Matrix
+        {ON, 0, 1,  OFF, 0, LED_COLS, 0},       // Spalte außerhalb der Matrix
+        {ON, 0, 1,  BLINK, 0, 2, NO_OF_SPEED_CLASSES},
+        {ON, 0, 1,  9, 0, 0, 0},                // unbekannte Art
+        {ON, 0, 1,  DISP, MAX_DISPLAY_FIELDS, 0, 0},
+    };
+    for (const auto &payload : corpus) {
+        TEST_ASSERT_FALSE(batch.receive(payload, sizeof(payload)));
+    }
+    // Letzte Änderung unvollständig bzw. zu viele Zeichen für das Display-Feld
+    const uint8_t truncated[] = {ON, 0, 1,  OFF, 0};
+    TEST_ASSERT_FALSE(batch.receive(truncated, sizeof(truncated)));
+    const uint8_t tooLong[] = {ON, 0, 1,  DISP, 0, MAX_7SEGMENT_UNITS * 2 + 1};
+    TEST_ASSERT_FALSE(batch.receive(tooLong, sizeof(tooLong)));
+    TEST_ASSERT_FALSE(batch.receive(truncated, 0));
+
+    TEST_ASSERT_EQUAL(8, batch.getRejected());
+    TEST_ASSERT_EQUAL(0, eventQueue.getCount());
+    TEST_ASSERT_FALSE(leds.isLedOn({0, 1}));    // auch die gültige erste Änderung nicht angewendet
+}
+
+
+void test_rejectedBatchKeepsPendingOne() {
+    LedBatchClass batch;
+    const uint8_t valid[] = {ON, 1, 1};
+    const uint8_t invalid[] = {ON, 1, 2,  OFF, LED_ROWS, 0};
+    TEST_ASSERT_TRUE(batch.receive(valid, sizeof(valid)));
+    TEST_ASSERT_FALSE(batch.receive(invalid, sizeof(invalid)));
+    dispatch(batch);
+    TEST_ASSERT_TRUE(leds.isLedOn({1, 1}));
+    TEST_ASSERT_FALSE(leds.isLedOn({1, 2}));
+}
+
+
+void test_batchesAreAppliedInOrderOfTheirEvents() {
+    LedBatchClass batch;
+    const uint8_t first[] = {ON, 3, 4,  ON, 3, 5};
+    const uint8_t second[] = {OFF, 3, 4};
+    TEST_ASSERT_TRUE(batch.receive(first, sizeof(first)));
+    TEST_ASSERT_TRUE(batch.receive(second, sizeof(second)));
+    TEST_ASSERT_EQUAL(2, eventQueue.getCount());    // je Sammelkommando ein Event
+    TEST_ASSERT_EQUAL(0, batch.getApplied());       // beim Empfang wird nichts angewendet
+    TEST_ASSERT_FALSE(leds.isLedOn({3, 4}));
+
+    dispatch(batch);
+    TEST_ASSERT_TRUE(leds.isLedOn({3, 4}));
+    TEST_ASSERT_TRUE(leds.isLedOn({3, 5}));
+    dispatch(batch);
+    TEST_ASSERT_FALSE(leds.isLedOn({3, 4}));
+    TEST_ASSERT_TRUE(leds.isLedOn({3, 5}));
+    TEST_ASSERT_EQUAL(2, batch.getApplied());
+}
+
+
+void test_fullBatchQueueRejectsBatch() {
+    LedBatchClass batch;
+    const uint8_t payload[] = {ON, 0, 0};
+    for (uint8_t i = 0; i < LED_BATCH_QUEUE_SIZE; ++i) {
+        TEST_ASSERT_TRUE(batch.receive(payload, sizeof(payload)));
+    }
+    TEST_ASSERT_EQUAL(0, batch.getFree());
+    const uint8_t late[] = {ON, 0, 1};
+    TEST_ASSERT_FALSE(batch.receive(late, sizeof(late)));
+    TEST_ASSERT_EQUAL(1, batch.getRejected());
+    TEST_ASSERT_EQUAL(LED_BATCH_QUEUE_SIZE, eventQueue.getCount());
+    while (eventQueue.getCount() > 0) {
+        dispatch(batch);
+    }
+    TEST_ASSERT_FALSE(leds.isLedOn({0, 1}));
+    TEST_ASSERT_EQUAL(LED_BATCH_QUEUE_SIZE, batch.getFree());
+}
+
+
+void test_fullEventQueueRejectsBatch() {
+    LedBatchClass batch;
+    EventClass filler {};
+    filler.deviceId = TokenId::DEV_PB;
+    filler.eventId = TokenId::EV_ON;
+    while (eventQueue.getCount() < EVENT_QUEUE_SIZE) {
+        eventQueue.addEvent(filler);
+    }
+    const uint8_t payload[] = {ON, 0, 0};
+    TEST_ASSERT_FALSE(batch.receive(payload, sizeof(payload)));
+    TEST_ASSERT_EQUAL(1, batch.getRejected());
+    batch.processEvent(nullptr);
+    TEST_ASSERT_FALSE(leds.isLedOn({0, 0}));
+}
+
+
+/*********************************************************************************************************//**
+ * Empfang über das Binärprotokoll
+ ************************************************************************************************************/
+void test_batchesBetweenOtherEventsKeepTheirOrder() {
+    ProtocolClass pc;
+    const uint8_t on[] = {ON, 4, 4};
+    const uint8_t code[] = {0x1B, 0x58};
+    const uint8_t off[] = {OFF, 4, 4};
+    pc.beginFrame();
+    pc.addRecord(LED_BATCH, on, sizeof(on));
+    pc.addRecord(XPDR_CODE, code, sizeof(code));
+    pc.addRecord(LED_BATCH, off, sizeof(off));
+    pc.endFrame();
+    deliver(Serial.hostTakeOutput());
+    TEST_ASSERT_EQUAL(3, eventQueue.getCount());
+
+    const TokenId expected[] = {TokenId::EV_BAT, TokenId::EV_CODE, TokenId::EV_BAT};
+    const bool ledOnAfter[] = {true, true, false};
+    for (uint8_t i = 0; i < 3; ++i) {
+        EventClass *event = eventQueue.getHeadEvent();
+        TEST_ASSERT_EQUAL(expected[i], event->eventId);
+        if (event->eventId == TokenId::EV_BAT) {
+            ledBatch.processEvent(event);
+        }
+        eventQueue.removeHeadEvent();
+        TEST_ASSERT_EQUAL(ledOnAfter[i], leds.isLedOn({4, 4}));
+    }
+}
+
+
+void test_sequencedFrameWithoutRoomIsNotAcknowledged() {
+    for (uint8_t seq = 0; seq < LED_BATCH_QUEUE_SIZE; ++seq) {
+        deliver(encodeFromPc({ON, 5, seq}, seq));
+        uint8_t acked = 0;
+        TEST_ASSERT_TRUE(linkLayer.takeAck(acked));
+        TEST_ASSERT_EQUAL(seq, acked);
+    }
+
+    // Ringpuffer voll: der nächste Frame wird weder angenommen noch bestätigt
+    const std::string refused = encodeFromPc({ON, 6, 0}, LED_BATCH_QUEUE_SIZE);
+    deliver(refused);
+    TEST_ASSERT_EQUAL(1, protocol.getFramesRefused());
+    TEST_ASSERT_FALSE(linkLayer.isAckPending());
+    TEST_ASSERT_EQUAL(0, ledBatch.getRejected());
+
+    // Nach dem Abarbeiten nimmt der Arduino die Wiederholung des PCs an
+    dispatcher.dispatchAll();
+    TEST_ASSERT_EQUAL(LED_BATCH_QUEUE_SIZE, ledBatch.getApplied());
+    deliver(refused);
+    uint8_t acked = 0;
+    TEST_ASSERT_TRUE(linkLayer.takeAck(acked));
+    TEST_ASSERT_EQUAL(LED_BATCH_QUEUE_SIZE, acked);
+    dispatcher.dispatchAll();
+    TEST_ASSERT_TRUE(leds.isLedOn({6, 0}));
+    TEST_ASSERT_EQUAL(1, protocol.getFramesRefused());
+}
+
+
+/**
+ * @brief Aufwand auf dem PC für Empfang (receiveByte() inkl. COBS, CRC und Prüfung) und Anwendung
+ *        (Dispatcher) eines Sammelkommandos je Änderung, abhängig von der Anzahl der Änderungen.
+ */
+void test_benchmarkCostPerUpdate() {
+    const uint8_t maxChanges = (FRAME_MAX_LENGTH - 1 - 3) / 3;     // CRC und Record-Kopf abziehen
+    const uint32_t repetitions = 100000;
+    for (uint8_t changes = 1; changes <= maxChanges; changes += 2) {
+        std::vector<uint8_t> payload;
+        for (uint8_t i = 0; i < changes; ++i) {
+            payload.insert(payload.end(), {(i % 2 == 0) ? ON : OFF, static_cast<uint8_t>(i % LED_ROWS), i});
+        }
+        const std::string frame = encodeFromPc(payload);
+        const unsigned long appliedBefore = ledBatch.getApplied();
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < repetitions; ++i) {
+            deliver(frame);
+            dispatcher.dispatchAll();
+        }
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        printf("Sammelkommando: %u Änderungen, %3u Bytes, %.1f ns je Änderung, %.1f ns je Frame\n",
+               changes, static_cast<unsigned>(frame.size()), ns / (static_cast<double>(repetitions) * changes),
+               ns / repetitions);
+        TEST_ASSERT_EQUAL(repetitions, ledBatch.getApplied() - appliedBefore);
+        TEST_ASSERT_EQUAL(0, ledBatch.getRejected());
+    }
+}
+
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_validBatchIsAppliedWithItsEvent);
+    RUN_TEST(test_invalidChangeRejectsWholeBatch);
+    RUN_TEST(test_rejectedBatchKeepsPendingOne);
+    RUN_TEST(test_batchesAreAppliedInOrderOfTheirEvents);
+    RUN_TEST(test_fullBatchQueueRejectsBatch);
+    RUN_TEST(test_fullEventQueueRejectsBatch);
+    RUN_TEST(test_batchesBetweenOtherEventsKeepTheirOrder);
+    RUN_TEST(test_sequencedFrameWithoutRoomIsNotAcknowledged);
+    RUN_TEST(test_benchmarkCostPerUpdate);
+    return UNITY_END();
+}
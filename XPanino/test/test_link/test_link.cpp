@@ -0,0 +1,461 @@
+/*********************************************************************************************************//**
+ * @file test_link.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Gesicherte Übertragung im Binärprotokoll: Sendefenster, kumulative Bestätigung, Wiederholung.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ * Der Test spielt den PC: er dekodiert die gesendeten Frames, bestätigt die Schalterereignisse mit
+ * ACK-Records und schickt eigene Frames mit SEQUENCE-Record. Dazwischen kann der Übertragungsweg Frames
+ * verlieren, verdoppeln, vertauschen und einzelne Bytes verfälschen. Die Zeit kommt über frameClock.setSource()
+ * von einer simulierten Uhr.
+ *
+ ************************************************************************************************************/
+
+#include <unity.h>
+#include <vector>
+#include <event.hpp>
+#include <frameclock.hpp>
+#include <link.hpp>
+#include <protocol.hpp>
+#include <txqueue.hpp>
+
+extern EventQueueClass eventQueue;
+extern FrameClockClass frameClock;
+extern LinkClass linkLayer;
+extern ProtocolClass protocol;
+extern TxQueueClass txQueue;
+
+static unsigned long simulatedTime = 0;     ///< Zeit der simulierten Uhr in ms
+
+/// Zeitquelle für frameClock.
+static unsigned long simulatedClock() { return simulatedTime; }
+
+
+/// Ein Record aus einem vom Arduino gesendeten Frame.
+struct Record {
+    uint16_t opcode;
+    uint8_t seq;    ///< SWITCH_*: Folgenummer; ACK: bestätigte Folgenummer
+    uint8_t row;
+    uint8_t col;
+};
+
+
+/// Einen Durchlauf wie in loop() zum Zeitpunkt now: Überwachung der Übertragung, dann die Sendewarteschlange.
+static void runPass(const unsigned long now) {
+    simulatedTime = now;
+    frameClock.tick();
+    linkLayer.update(frameClock.getNow());
+    txQueue.flush();
+}
+
+
+/// Die gesendeten Bytes in Frames zerlegen, prüfen und die Records liefern.
+static std::vector<std::vector<Record>> takeFrames() {
+    const std::string sent = Serial.hostTakeOutput();
+    std::vector<std::vector<Record>> frames;
+    size_t start = 0;
+    for (size_t end = sent.find('\0'); end != std::string::npos; end = sent.find('\0', start)) {
+        uint8_t frame[FRAME_MAX_LENGTH + 1];
+        memcpy(frame, sent.data() + start, end - start);
+        uint8_t length = ProtocolClass::cobsDecode(frame, static_cast<uint8_t>(end - start));
+        TEST_ASSERT_GREATER_THAN(0, length);
+        TEST_ASSERT_EQUAL_HEX8(ProtocolClass::crc8(frame, length - 1), frame[length - 1]);
+        std::vector<Record> records;
+        for (uint8_t pos = 0; pos + RECORD_HEADER_LENGTH < length; pos += RECORD_HEADER_LENGTH + frame[pos + 2]) {
+            const uint8_t *payload = &frame[pos + RECORD_HEADER_LENGTH];
+            records.push_back({static_cast<uint16_t>((frame[pos] << 8) | frame[pos + 1]), payload[0],
+                               (frame[pos + 2] >= 3) ? payload[1] : static_cast<uint8_t>(0),
+                               (frame[pos + 2] >= 3) ? payload[2] : static_cast<uint8_t>(0)});
+        }
+        frames.push_back(records);
+        start = end + 1;
+    }
+    return frames;
+}
+
+
+/// Alle Records der gesendeten Frames.
+static std::vector<Record> takeRecords() {
+    std::vector<Record> records;
+    for (const std::vector<Record> &frame : takeFrames()) {
+        records.insert(records.end(), frame.begin(), frame.end());
+    }
+    return records;
+}
+
+
+/// Einen Frame des PCs kodieren (die Ausgabe des Arduino muss vorher abgeholt sein).
+static std::string encodeFromPc(const uint16_t opcode, const uint8_t *payload, const uint8_t length,
+                                const int sequence = -1) {
+    ProtocolClass pc;
+    pc.beginFrame();
+    if (sequence >= 0) {
+        const uint8_t seq = static_cast<uint8_t>(sequence);
+        pc.addRecord(SEQUENCE, &seq, 1);
+    }
+    pc.addRecord(opcode, payload, length);
+    pc.endFrame();
+    return Serial.hostTakeOutput();
+}
+
+
+/// Bytes des PCs an den Arduino übergeben.
+static void deliver(const std::string &bytes) {
+    for (const char inByte : bytes) {
+        protocol.receiveByte(static_cast<uint8_t>(inByte));
+    }
+}
+
+
+/// Eine kumulative Bestätigung des PCs senden.
+static void acknowledge(const uint8_t seq) {
+    deliver(encodeFromPc(ACK, &seq, 1));
+}
+
+
+/// Ein Schalterereignis auslösen (Row 0, Col = Nummer des Ereignisses, damit es im Test erkennbar ist).
+static bool pressSwitch(const uint8_t number) {
+    return txQueue.addSwitchEvent(0, number, 1, false, 0);
+}
+
+
+void setUp() {
+    hostReset();
+    simulatedTime = 0;
+    frameClock.setSource(simulatedClock);
+    frameClock.tick();
+    txQueue = TxQueueClass();
+    protocol = ProtocolClass();
+    linkLayer = LinkClass();
+    protocol.setMode(ProtocolMode::BINARY);
+    while (eventQueue.getHeadEvent() != nullptr) {
+        eventQueue.removeHeadEvent();
+    }
+}
+
+
+void tearDown() {
+    frameClock.setSource(nullptr);
+}
+
+
+/*********************************************************************************************************//**
+ * Arduino --> PC
+ ************************************************************************************************************/
+void test_windowAllowsEightUnacknowledgedEvents() {
+    for (uint8_t i = 0; i < LINK_WINDOW_SIZE; ++i) {
+        TEST_ASSERT_TRUE(pressSwitch(i));
+    }
+    TEST_ASSERT_FALSE(txQueue.canAddSwitchEvent());
+    TEST_ASSERT_FALSE(pressSwitch(LINK_WINDOW_SIZE));
+    TEST_ASSERT_EQUAL(1, txQueue.getDropped());
+
+    // Alle acht gehen sofort hinaus, ohne auf Bestätigungen zu warten
+    std::vector<Record> records;
+    for (unsigned long now = 0; now < 10; ++now) {
+        runPass(now);
+        const std::vector<Record> sent = takeRecords();
+        records.insert(records.end(), sent.begin(), sent.end());
+    }
+    TEST_ASSERT_EQUAL(LINK_WINDOW_SIZE, records.size());
+    for (uint8_t i = 0; i < LINK_WINDOW_SIZE; ++i) {
+        TEST_ASSERT_EQUAL_HEX16(SWITCH_ON, records[i].opcode);
+        TEST_ASSERT_EQUAL(i, records[i].seq);
+        TEST_ASSERT_EQUAL(i, records[i].col);
+    }
+    TEST_ASSERT_FALSE(txQueue.canAddSwitchEvent());     // Fenster bleibt bis zur Bestätigung belegt
+}
+
+
+void test_cumulativeAckReleasesWindow() {
+    for (uint8_t i = 0; i < LINK_WINDOW_SIZE; ++i) {
+        pressSwitch(i);
+    }
+    runPass(0);
+    runPass(1);
+    takeRecords();
+
+    acknowledge(4);     // bestätigt 0 bis 4 auf einmal
+    for (uint8_t i = 0; i < 5; ++i) {
+        TEST_ASSERT_TRUE(pressSwitch(LINK_WINDOW_SIZE + i));
+    }
+    TEST_ASSERT_FALSE(txQueue.canAddSwitchEvent());
+
+    // Alte und ungültige Bestätigungen ändern nichts
+    acknowledge(3);
+    acknowledge(200);
+    TEST_ASSERT_FALSE(txQueue.canAddSwitchEvent());
+}
+
+
+void test_retransmitAfterTimeoutGoesBackToOldestUnacknowledged() {
+    for (uint8_t i = 0; i < 4; ++i) {
+        pressSwitch(i);
+    }
+    runPass(0);
+    TEST_ASSERT_EQUAL(4, takeRecords().size());
+    acknowledge(1);     // zur Zeit 0: 2 und 3 bleiben offen
+
+    runPass(LINK_RETRANSMIT_TIMEOUT - 1);
+    TEST_ASSERT_EQUAL(0, takeRecords().size());
+    TEST_ASSERT_EQUAL(0, linkLayer.getRetransmits());
+
+    runPass(LINK_RETRANSMIT_TIMEOUT);
+    const std::vector<Record> resent = takeRecords();
+    TEST_ASSERT_EQUAL(2, resent.size());
+    TEST_ASSERT_EQUAL(2, resent[0].seq);
+    TEST_ASSERT_EQUAL(3, resent[1].seq);
+    TEST_ASSERT_EQUAL(2, linkLayer.getRetransmits());
+
+    // Die Wartezeit beginnt nach der Wiederholung neu
+    runPass(2 * LINK_RETRANSMIT_TIMEOUT - 1);
+    TEST_ASSERT_EQUAL(0, takeRecords().size());
+    acknowledge(3);
+    runPass(5 * LINK_RETRANSMIT_TIMEOUT);
+    TEST_ASSERT_EQUAL(0, takeRecords().size());
+    TEST_ASSERT_EQUAL(2, linkLayer.getRetransmits());
+}
+
+
+void test_sequenceNumbersWrapAfter255() {
+    unsigned long now = 0;
+    for (uint16_t i = 0; i < 600; ++i) {
+        TEST_ASSERT_TRUE(pressSwitch(static_cast<uint8_t>(i % 8)));
+        runPass(now++);
+        const std::vector<Record> records = takeRecords();
+        TEST_ASSERT_EQUAL(1, records.size());
+        TEST_ASSERT_EQUAL(static_cast<uint8_t>(i), records[0].seq);
+        acknowledge(records[0].seq);
+    }
+    runPass(now + 10 * LINK_RETRANSMIT_TIMEOUT);
+    TEST_ASSERT_EQUAL(0, takeRecords().size());
+    TEST_ASSERT_EQUAL(0, linkLayer.getRetransmits());
+}
+
+
+/**
+ * @brief Der Übertragungsweg verliert, verdoppelt und vertauscht Frames in beiden Richtungen (reproduzierbar).
+ *        Der PC übernimmt nur die jeweils nächste Folgenummer; am Ende müssen alle Ereignisse genau einmal
+ *        und in der richtigen Reihenfolge angekommen sein.
+ */
+void test_allEventsArriveDespiteLossDuplicationAndReordering() {
+    const uint16_t EVENT_COUNT = 300;
+    uint32_t seed = 4711;
+    auto chance = [&seed](const uint8_t percent) {
+        seed = seed * 1103515245 + 12345;
+        return ((seed >> 16) % 100) < percent;
+    };
+
+    uint16_t pressed = 0;           // Anzahl ausgelöster Ereignisse
+    uint16_t delivered = 0;         // Anzahl beim PC in Reihenfolge angekommener Ereignisse
+    uint8_t pcExpected = 0;         // Nächste Folgenummer, die der PC erwartet
+    std::vector<std::string> ackChannel;    // Bestätigungen unterwegs zum Arduino
+    std::vector<Record> delayedFrame;       // Frame, der von späteren überholt wird
+    uint16_t reordered = 0;                 // Anzahl überholter Frames
+
+    unsigned long now = 0;
+    for (; (now < 600000) && (delivered < EVENT_COUNT); now += 5) {
+        while ((pressed < EVENT_COUNT) && txQueue.canAddSwitchEvent() && chance(30)) {
+            TEST_ASSERT_TRUE(pressSwitch(static_cast<uint8_t>(pressed % 8)));
+            ++pressed;
+        }
+        runPass(now);
+
+        // Frames zum PC: ein zurückgehaltener Frame kommt erst nach den Frames dieses Durchlaufs an
+        std::vector<std::vector<Record>> dataChannel = takeFrames();
+        std::vector<Record> heldBack;
+        if (! dataChannel.empty() && chance(15)) {
+            heldBack = dataChannel.front();
+            dataChannel.erase(dataChannel.begin());
+        }
+        if (! delayedFrame.empty()) {
+            reordered += dataChannel.empty() ? 0 : 1;
+            dataChannel.push_back(delayedFrame);
+        }
+        delayedFrame = heldBack;
+        for (const std::vector<Record> &frame : dataChannel) {
+            const uint8_t copies = chance(20) ? 0 : (chance(10) ? 2 : 1);     // verloren bzw. doppelt
+            for (uint8_t copy = 0; copy < copies; ++copy) {
+                for (const Record &record : frame) {
+                    if ((record.opcode != SWITCH_ON) || (record.seq != pcExpected)) {
+                        continue;   // Duplikat oder Lücke: verwerfen
+                    }
+                    TEST_ASSERT_EQUAL(delivered % 8, record.col);
+                    ++pcExpected;
+                    ++delivered;
+                }
+            }
+            if (copies > 0) {
+                const uint8_t lastInOrder = static_cast<uint8_t>(pcExpected - 1);
+                ackChannel.push_back(encodeFromPc(ACK, &lastInOrder, 1));
+            }
+        }
+
+        // Bestätigungen: manche gehen verloren, manche überholen einander
+        if ((ackChannel.size() >= 2) && chance(30)) {
+            std::swap(ackChannel[0], ackChannel[1]);
+        }
+        while (! ackChannel.empty() && chance(70)) {
+            if (! chance(15)) {
+                deliver(ackChannel.front());
+            }
+            ackChannel.erase(ackChannel.begin());
+        }
+    }
+    TEST_ASSERT_EQUAL(EVENT_COUNT, delivered);
+    TEST_ASSERT_GREATER_THAN(0, reordered);
+    TEST_ASSERT_GREATER_THAN(0, linkLayer.getRetransmits());
+
+    // Nach der letzten Bestätigung wird nichts mehr wiederholt
+    acknowledge(static_cast<uint8_t>(pcExpected - 1));
+    const unsigned long retransmits = linkLayer.getRetransmits();
+    runPass(now + 10 * LINK_RETRANSMIT_TIMEOUT);
+    TEST_ASSERT_EQUAL(retransmits, linkLayer.getRetransmits());
+    TEST_ASSERT_TRUE(txQueue.canAddSwitchEvent());
+}
+
+
+/*********************************************************************************************************//**
+ * PC --> Arduino
+ ************************************************************************************************************/
+void test_pcFramesAreProcessedInOrderAndAcknowledged() {
+    const uint8_t code[] = {0x1B, 0x58};
+    const std::string frame0 = encodeFromPc(XPDR_CODE, code, sizeof(code), 0);
+    const std::string frame1 = encodeFromPc(XPDR_CODE, code, sizeof(code), 1);
+    const std::string frame2 = encodeFromPc(XPDR_CODE, code, sizeof(code), 2);
+
+    deliver(frame0);
+    deliver(frame0);    // Duplikat
+    deliver(frame2);    // zu früh (frame1 verloren)
+    TEST_ASSERT_EQUAL(1, eventQueue.getCount());
+    TEST_ASSERT_EQUAL(2, linkLayer.getDuplicates());
+
+    runPass(0);
+    std::vector<Record> records = takeRecords();
+    TEST_ASSERT_EQUAL(1, records.size());
+    TEST_ASSERT_EQUAL_HEX16(ACK, records[0].opcode);
+    TEST_ASSERT_EQUAL(0, records[0].seq);
+
+    deliver(frame1);
+    deliver(frame2);
+    runPass(1);
+    records = takeRecords();
+    TEST_ASSERT_EQUAL(1, records.size());
+    TEST_ASSERT_EQUAL(2, records[0].seq);
+    TEST_ASSERT_EQUAL(2, linkLayer.getDuplicates());
+
+    // Ohne SEQUENCE-Record: ungesichert verarbeitet, keine Bestätigung
+    deliver(encodeFromPc(XPDR_CODE, code, sizeof(code)));
+    runPass(2);
+    TEST_ASSERT_EQUAL(0, takeRecords().size());
+}
+
+
+void test_ackIsSentFirstInFrameWithSwitchEvents() {
+    const uint8_t code[] = {0x1B, 0x58};
+    deliver(encodeFromPc(XPDR_CODE, code, sizeof(code), 0));
+    pressSwitch(3);
+    runPass(0);
+    const std::vector<std::vector<Record>> frames = takeFrames();
+    TEST_ASSERT_EQUAL(1, frames.size());
+    TEST_ASSERT_EQUAL(2, frames[0].size());
+    TEST_ASSERT_EQUAL_HEX16(ACK, frames[0][0].opcode);
+    TEST_ASSERT_EQUAL_HEX16(SWITCH_ON, frames[0][1].opcode);
+}
+
+
+/*********************************************************************************************************//**
+ * Verfälschte Bytes
+ ************************************************************************************************************/
+
+/// Jede Variante eines Frames, in der genau ein Byte (außer dem Trennzeichen) verfälscht ist.
+static std::vector<std::string> corruptEachByte(const std::string &frame) {
+    std::vector<std::string> corrupted;
+    for (size_t pos = 0; pos + 1 < frame.size(); ++pos) {
+        std::string bad = frame;
+        bad[pos] = static_cast<char>(bad[pos] ^ ((bad[pos] == '\x5A') ? 0x3C : 0x5A));
+        if (bad[pos] == '\0') {
+            bad[pos] = '\x01';     // ein Trennzeichen mitten im Frame teilt ihn nur; das prüft ein anderer Test
+        }
+        corrupted.push_back(bad);
+    }
+    return corrupted;
+}
+
+
+void test_corruptedAckIsDiscardedAndEventsAreRetransmitted() {
+    for (uint8_t i = 0; i < 3; ++i) {
+        pressSwitch(i);
+    }
+    runPass(0);
+    TEST_ASSERT_EQUAL(3, takeRecords().size());
+
+    const uint8_t lastSeq = 2;
+    for (const std::string &bad : corruptEachByte(encodeFromPc(ACK, &lastSeq, 1))) {
+        deliver(bad);
+    }
+    TEST_ASSERT_EQUAL(0, protocol.getFramesReceived());
+    TEST_ASSERT_GREATER_THAN(0, protocol.getFrameErrors());
+    for (uint8_t i = 3; i < LINK_WINDOW_SIZE; ++i) {
+        TEST_ASSERT_TRUE(pressSwitch(i));
+    }
+    TEST_ASSERT_FALSE(txQueue.canAddSwitchEvent());     // nichts bestätigt: das Fenster ist voll
+    runPass(1);
+    takeRecords();
+
+    runPass(LINK_RETRANSMIT_TIMEOUT - 1);
+    TEST_ASSERT_EQUAL(0, takeRecords().size());
+    std::vector<Record> resent;
+    for (unsigned long now = LINK_RETRANSMIT_TIMEOUT; now < LINK_RETRANSMIT_TIMEOUT + 5; ++now) {
+        runPass(now);
+        const std::vector<Record> sent = takeRecords();
+        resent.insert(resent.end(), sent.begin(), sent.end());
+    }
+    TEST_ASSERT_EQUAL(LINK_WINDOW_SIZE, resent.size());
+    TEST_ASSERT_EQUAL(0, resent[0].seq);
+    TEST_ASSERT_EQUAL(LINK_WINDOW_SIZE, linkLayer.getRetransmits());
+
+    // Die unverfälschte Bestätigung gibt das Fenster wieder frei
+    acknowledge(LINK_WINDOW_SIZE - 1);
+    TEST_ASSERT_TRUE(txQueue.canAddSwitchEvent());
+}
+
+
+void test_corruptedPcFrameIsNeitherProcessedNorAcknowledged() {
+    const uint8_t code[] = {0x1B, 0x58};
+    const std::string frame0 = encodeFromPc(XPDR_CODE, code, sizeof(code), 0);
+    for (const std::string &bad : corruptEachByte(frame0)) {
+        deliver(bad);
+    }
+    TEST_ASSERT_EQUAL(0, eventQueue.getCount());
+    TEST_ASSERT_FALSE(linkLayer.isAckPending());
+    runPass(0);
+    TEST_ASSERT_EQUAL(0, takeRecords().size());
+
+    // Folgenummer 0 wird weiterhin erwartet
+    deliver(frame0);
+    TEST_ASSERT_EQUAL(1, eventQueue.getCount());
+    runPass(1);
+    const std::vector<Record> records = takeRecords();
+    TEST_ASSERT_EQUAL(1, records.size());
+    TEST_ASSERT_EQUAL_HEX16(ACK, records[0].opcode);
+    TEST_ASSERT_EQUAL(0, records[0].seq);
+}
+
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_windowAllowsEightUnacknowledgedEvents);
+    RUN_TEST(test_cumulativeAckReleasesWindow);
+    RUN_TEST(test_retransmitAfterTimeoutGoesBackToOldestUnacknowledged);
+    RUN_TEST(test_sequenceNumbersWrapAfter255);
+    RUN_TEST(test_allEventsArriveDespiteLossDuplicationAndReordering);
+    RUN_TEST(test_pcFramesAreProcessedInOrderAndAcknowledged);
+    RUN_TEST(test_ackIsSentFirstInFrameWithSwitchEvents);
+    RUN_TEST(test_corruptedAckIsDiscardedAndEventsAreRetransmitted);
+    RUN_TEST(test_corruptedPcFrameIsNeitherProcessedNorAcknowledged);
+    return UNITY_END();
+}
@@ -0,0 +1,129 @@
+/*********************************************************************************************************//**
+ * @file test_loop.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Ablaufsteuerung des loop(): feste Raten der Aufgaben und sofortige Abfrage gemeldeter Spalten.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ * setup() und loop() aus main.cpp laufen mit der simulierten Zeit; zwischen zwei Durchläufen vergehen
+ * 250 µs zusätzlich zu den Wartezeiten der Hardware-Ansteuerung. Die Anzahl der Ausführungen je Abschnitt
+ * liefert die Laufzeitmessung (LoopStageStats::count).
+ *
+ ************************************************************************************************************/
+
+#include <unity.h>
+#include <event.hpp>
+#include <heartbeat.hpp>
+#include <link.hpp>
+#include <linkspeed.hpp>
+#include <looptiming.hpp>
+#include <protocol.hpp>
+#include <scheduler.hpp>
+#include <Switchmatrix.hpp>
+#include <txqueue.hpp>
+
+extern EventQueueClass eventQueue;
+extern HeartbeatClass heartbeat;
+extern LinkClass linkLayer;
+extern LinkSpeedClass linkSpeed;
+extern LoopTimingClass loopTiming;
+extern ProtocolClass protocol;
+extern SchedulerClass scheduler;
+extern SwitchMatrix switches;
+extern TxQueueClass txQueue;
+
+void setup();
+void loop();
+void serialEvent();
+
+const unsigned long PASS_MICROS = 250;      ///< Simulierte Zeit zwischen zwei loop()-Durchläufen
+
+static unsigned long passes = 0;            ///< Anzahl der Durchläufe seit dem letzten runFor()
+
+
+/// Durchläufe ausführen, bis die angegebene Zeit vergangen ist; liefert das Gesendete.
+static std::string runFor(const unsigned long ms) {
+    std::string sent;
+    const unsigned long end = millis() + ms;
+    passes = 0;
+    while (static_cast<long>(millis() - end) < 0) {
+        loop();
+        hostAdvanceMicros(PASS_MICROS);
+        sent += Serial.hostTakeOutput();
+        ++passes;
+    }
+    return sent;
+}
+
+
+/// Anzahl Ausführungen eines Abschnitts seit dem letzten Zurücksetzen der Laufzeitmessung.
+static uint16_t runsOf(const LoopStage stage) { return loopTiming.getStats(stage).count; }
+
+
+void setUp() {
+    hostReset();
+    hostSetMillis(1000);
+    scheduler = SchedulerClass();
+    txQueue = TxQueueClass();
+    eventQueue = EventQueueClass();
+    protocol = ProtocolClass();
+    linkLayer = LinkClass();
+    linkSpeed = LinkSpeedClass();
+    heartbeat = HeartbeatClass();
+    setup();
+    Serial.hostTakeOutput();
+    loopTiming = LoopTimingClass();
+}
+
+
+void tearDown() {}
+
+
+void test_tasksRunAtTheirRates() {
+    runFor(1000);
+    TEST_ASSERT_EQUAL(passes, runsOf(LoopStage::REFRESH));      // bei jedem Durchlauf
+    TEST_ASSERT_EQUAL(100, runsOf(LoopStage::SHOW));            // alle 10 ms
+    TEST_ASSERT_EQUAL(1000 + 100, runsOf(LoopStage::TX));       // Senden jede ms, Zeitüberwachung alle 10 ms
+    // Gemeldete Spalten bei jedem Durchlauf, Prüfung der Abfrage jede ms, Senden nach jeder Abfrage (Ruhe: alle 20 ms)
+    TEST_ASSERT_EQUAL(passes + 1000 + 1000 / SCAN_IDLE_INTERVAL, runsOf(LoopStage::SCAN));
+    TEST_ASSERT_EQUAL(0, runsOf(LoopStage::DISPATCH));          // ohne Events nie
+    TEST_ASSERT_EQUAL(0, scheduler.getOverruns());
+    TEST_ASSERT_EQUAL(0, scheduler.getMaxLateness());
+    printf("loop(): %lu Durchläufe/s, davon %u mit Anzeige der Geräte\n", passes, runsOf(LoopStage::SHOW));
+}
+
+
+void test_receivedLineIsDispatchedOnce() {
+    runFor(5);
+    Serial.hostReceive("CTRL;LOG;0\n");
+    serialEvent();
+    runFor(5);
+    TEST_ASSERT_EQUAL(1, runsOf(LoopStage::DISPATCH));
+    TEST_ASSERT_EQUAL(0, eventQueue.getCount());
+}
+
+
+void test_pinChangeIsScannedInNextPass() {
+    // Die periodische Abfrage so selten, dass nur die Interrupt-Meldung den Tastendruck finden kann
+    ScanScheduler &scanScheduler = switches.getScanScheduler();
+    scanScheduler.setRates(60000, 60000, scanScheduler.getBurstWindow());
+    runFor(5);
+
+    hostSetContact(HW_MATRIX_ROWS_LSB_PIN + 2, HW_MATRIX_COLS_LSB_PIN + 6, true);
+    switches.onPinChange();                 // wie die Interrupt-Routine
+    loop();
+    txQueue.flush();                        // ggf. noch nicht gesendet, aber schon in diesem Durchlauf erkannt
+    const std::string sent = Serial.hostTakeOutput();
+    TEST_ASSERT_EQUAL_STRING("S;S;ON;2;6\r\n", sent.c_str());
+}
+
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_tasksRunAtTheirRates);
+    RUN_TEST(test_receivedLineIsDispatchedOnce);
+    RUN_TEST(test_pinChangeIsScannedInNextPass);
+    return UNITY_END();
+}
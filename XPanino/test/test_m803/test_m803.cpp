@@ -0,0 +1,151 @@
+/*********************************************************************************************************//**
+ * @file test_m803.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Uhrzeiten der Uhr Davtron M803: Events vom PC, eigene Zeitbasis und Wiederaufsetzen.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ * Die Events werden direkt an processEvent() übergeben; ihren Zeitstempel liefert frameClock mit einer
+ * simulierten Uhr. Das untere Display (HHMM) wird aus den Zustandswörtern der LED-Matrix gelesen.
+ *
+ ************************************************************************************************************/
+
+#include <unity.h>
+#include <frameclock.hpp>
+#include <m803.hpp>
+
+extern FrameClockClass frameClock;
+extern LedMatrix leds;
+
+const uint8_t LOWER_DISPLAY_ROW = 4;    ///< Erste Stelle des unteren Displays (Rows 4 bis 7, ab Col 16)
+const uint8_t DISPLAY_COL = 16;
+
+static unsigned long simulatedTime = 0;     ///< Zeit der simulierten Uhr in ms
+
+/// Zeitquelle für frameClock.
+static unsigned long simulatedClock() { return simulatedTime; }
+
+
+/// Die simulierte Uhr stellen und den Durchlauf wie in loop() beginnen.
+static unsigned long startPass(const unsigned long now) {
+    simulatedTime = now;
+    return frameClock.tick();
+}
+
+
+/// Eine Uhrzeit vom PC an die Uhr übergeben.
+static void receive(ClockDavtronM803 &clock, const TokenId eventId, const char *parameter1,
+                    const char *parameter2 = "") {
+    EventClass event;
+    event.deviceId = TokenId::DEV_M803;
+    event.eventId = eventId;
+    strcpy(event.parameter1, parameter1);
+    strcpy(event.parameter2, parameter2);
+    clock.processEvent(&event);
+}
+
+
+/// Die Uhr bis @em now weiterlaufen lassen, anzeigen und prüfen, ob das untere Display den Text zeigt.
+static bool showsAt(ClockDavtronM803 &clock, const unsigned long now, const char *text) {
+    const Led7SegmentCharMap charMap;
+    clock.tick(now);
+    clock.show();
+    for (uint8_t i = 0; text[i] != '\0'; ++i) {
+        if (((leds.getStateWord(LOWER_DISPLAY_ROW + i) >> DISPLAY_COL) & 0x7F) != charMap.get7SegBitMap(text[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+void setUp() {
+    hostReset();
+    leds = LedMatrix();
+    simulatedTime = 0;
+    frameClock.setSource(simulatedClock);
+    frameClock.tick();
+}
+
+
+void tearDown() {
+    frameClock.setSource(nullptr);
+}
+
+
+void test_localTimeFromPcIsShownAndRunsOn() {
+    ClockDavtronM803 clock;
+    startPass(5000);
+    receive(clock, TokenId::EV_LT, "235958");
+    TEST_ASSERT_TRUE(showsAt(clock, 5000, "2359"));
+    TEST_ASSERT_TRUE(showsAt(clock, 6999, "2359"));
+    TEST_ASSERT_TRUE(showsAt(clock, 7000, "0000"));    // zwei Sekunden später: Mitternacht
+}
+
+
+void test_timeBaseRestartsWithTheTimeFromPc() {
+    ClockDavtronM803 clock;
+    // Die Uhr läuft seit dem Start; ohne neuen Bezugszeitpunkt würden 100 s nachgeholt
+    startPass(100000);
+    receive(clock, TokenId::EV_LT, "120000");
+    TEST_ASSERT_TRUE(showsAt(clock, 100500, "1200"));
+    TEST_ASSERT_TRUE(showsAt(clock, 159999, "1200"));
+    TEST_ASSERT_TRUE(showsAt(clock, 160000, "1201"));
+}
+
+
+void test_utcAndCombinedTimeReachTheClock() {
+    ClockDavtronM803 clock;
+    ClockModeState mode = ClockModeState::UT;
+    clock.setTimeMode(mode);
+    startPass(1000);
+    receive(clock, TokenId::EV_UT, "081500");
+    TEST_ASSERT_TRUE(showsAt(clock, 1000, "0815"));
+
+    startPass(2000);
+    receive(clock, TokenId::EV_TIME, "101010", "091010");
+    TEST_ASSERT_TRUE(showsAt(clock, 2000, "0910"));
+    mode = ClockModeState::LT;
+    clock.setTimeMode(mode);
+    clock.redraw();
+    TEST_ASSERT_TRUE(showsAt(clock, 2000, "1010"));
+}
+
+
+void test_invalidTimesAreIgnored() {
+    ClockDavtronM803 clock;
+    startPass(1000);
+    receive(clock, TokenId::EV_LT, "120000");
+    const char *corpus[] = {"240000", "126000", "120060", "12000", "12a000", ""};
+    for (const char *time : corpus) {
+        receive(clock, TokenId::EV_LT, time);
+    }
+    TEST_ASSERT_TRUE(showsAt(clock, 1000, "1200"));
+}
+
+
+void test_clockRunsWithoutPcAndResyncsWhenItReturns() {
+    ClockDavtronM803 clock;
+    startPass(1000);
+    receive(clock, TokenId::EV_LT, "120000");
+    clock.setLinkUp(false);                             // Heartbeat abgelaufen: "noFS", die Uhr läuft weiter
+    TEST_ASSERT_TRUE(showsAt(clock, 1000 + 5UL * 60 * 1000, "1205"));
+
+    clock.setLinkUp(true);                              // PC wieder da: seine Uhrzeit gilt sofort
+    startPass(1000 + 5UL * 60 * 1000 + 10);
+    receive(clock, TokenId::EV_LT, "121500");
+    TEST_ASSERT_TRUE(showsAt(clock, 1000 + 5UL * 60 * 1000 + 10, "1215"));
+}
+
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_localTimeFromPcIsShownAndRunsOn);
+    RUN_TEST(test_timeBaseRestartsWithTheTimeFromPc);
+    RUN_TEST(test_utcAndCombinedTimeReachTheClock);
+    RUN_TEST(test_invalidTimesAreIgnored);
+    RUN_TEST(test_clockRunsWithoutPcAndResyncsWhenItReturns);
+    return UNITY_END();
+}
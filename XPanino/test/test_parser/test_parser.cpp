@@ -0,0 +1,233 @@
+/*********************************************************************************************************//**
+ * @file test_parser.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Fehlerhafte Eingaben für den Parser des Klartextprotokolls und Messung des Durchsatzes.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ * Jede Zeile wird Zeichen für Zeichen wie in serialEvent() an receiveChar() übergeben. Geprüft werden die
+ * Feldlängen, das Verwerfen und Zählen fehlerhafter Zeilen (lineErrors) und das Wiederaufsetzen in der
+ * folgenden Zeile. Der Durchsatz wird auf dem PC gemessen und nur ausgegeben.
+ *
+ ************************************************************************************************************/
+
+#include <unity.h>
+#include <chrono>
+#include <parser.hpp>
+
+static ParserClass parser;
+static uint32_t completedLines = 0;     ///< Anzahl der Zeilen, für die receiveChar() ein Event geliefert hat
+
+
+/// Text Zeichen für Zeichen an den Parser übergeben.
+static void feed(const char *text, const size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        if (parser.receiveChar(text[i])) {
+            ++completedLines;
+        }
+    }
+}
+
+static void feed(const char *text) { feed(text, strlen(text)); }
+
+
+/// Prüfen, ob das zuletzt gelesene Event die erwarteten Felder hat.
+static void assertEvent(const char *device, const char *event, const char *parameter1, const char *parameter2) {
+    TEST_ASSERT_EQUAL_STRING(device, parser.getEvent().device);
+    TEST_ASSERT_EQUAL_STRING(event, parser.getEvent().event);
+    TEST_ASSERT_EQUAL_STRING(parameter1, parser.getEvent().parameter1);
+    TEST_ASSERT_EQUAL_STRING(parameter2, parser.getEvent().parameter2);
+}
+
+
+void setUp() {
+    parser = ParserClass();
+    completedLines = 0;
+}
+
+
+void tearDown() {}
+
+
+/*********************************************************************************************************//**
+ * Gültige Zeilen
+ ************************************************************************************************************/
+void test_validLineIsUppercasedAndInterned() {
+    feed("xpdr;code;1234\n");
+    TEST_ASSERT_EQUAL(1, completedLines);
+    assertEvent("XPDR", "CODE", "1234", "");
+    TEST_ASSERT_EQUAL(TokenId::DEV_XPDR, parser.getEvent().deviceId);
+    TEST_ASSERT_EQUAL(TokenId::EV_CODE, parser.getEvent().eventId);
+}
+
+
+void test_crLfAndEmptyLinesGiveOneEvent() {
+    feed("\r\n\r\nLED;ON;12;3\r\n\n\n");
+    TEST_ASSERT_EQUAL(1, completedLines);
+    assertEvent("LED", "ON", "12", "3");
+    TEST_ASSERT_EQUAL(0, parser.getLineErrors());
+}
+
+
+void test_fieldsOfMaximumLengthAreAccepted() {
+    feed("M803;TIME;123456;654321\n");
+    TEST_ASSERT_EQUAL(1, completedLines);
+    assertEvent("M803", "TIME", "123456", "654321");
+}
+
+
+void test_missingFieldsStayEmpty() {
+    feed("CTRL\n");
+    TEST_ASSERT_EQUAL(1, completedLines);
+    assertEvent("CTRL", "", "", "");
+    feed(";;;\n");
+    TEST_ASSERT_EQUAL(2, completedLines);
+    assertEvent("", "", "", "");
+    TEST_ASSERT_EQUAL(TokenId::NONE, parser.getEvent().deviceId);
+}
+
+
+void test_extraFieldsAreIgnored() {
+    feed("LED;ON;1;2;3;4;TOOLONGFIELD\n");
+    TEST_ASSERT_EQUAL(1, completedLines);
+    assertEvent("LED", "ON", "1", "2");
+    TEST_ASSERT_EQUAL(0, parser.getLineErrors());
+}
+
+
+void test_lineIsCompletedOnlyByTerminator() {
+    feed("XPDR;CO");
+    feed("DE;7");
+    TEST_ASSERT_EQUAL(0, completedLines);
+    feed("000\r");
+    TEST_ASSERT_EQUAL(1, completedLines);
+    assertEvent("XPDR", "CODE", "7000", "");
+}
+
+
+/*********************************************************************************************************//**
+ * Fehlerhafte Zeilen
+ ************************************************************************************************************/
+void test_overlongFieldsDiscardTheLine() {
+    const char *corpus[] = {
+        "XPDRX;CODE;1234\n",            // device 5 Zeichen
+        "XPDR;CODES;1234\n",            // event 5 Zeichen
+        "XPDR;CODE;1234567\n",          // parameter1 7 Zeichen
+        "XPDR;CODE;1;1234567\n",        // parameter2 7 Zeichen
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZ\n", // ohne Trennzeichen
+    };
+    const uint8_t count = sizeof(corpus) / sizeof(corpus[0]);
+    for (uint8_t i = 0; i < count; ++i) {
+        feed(corpus[i]);
+    }
+    TEST_ASSERT_EQUAL(0, completedLines);
+    TEST_ASSERT_EQUAL(count, parser.getLineErrors());
+}
+
+
+void test_parserRecoversAfterDiscardedLine() {
+    feed("XPDR;CODE;12345678901234567890\nXPDR;CODE;4321\n");
+    TEST_ASSERT_EQUAL(1, completedLines);
+    TEST_ASSERT_EQUAL(1, parser.getLineErrors());
+    assertEvent("XPDR", "CODE", "4321", "");
+}
+
+
+void test_veryLongGarbageLineCountsOnce() {
+    std::string line(2000, 'A');
+    line += '\n';
+    feed(line.c_str());
+    TEST_ASSERT_EQUAL(0, completedLines);
+    TEST_ASSERT_EQUAL(1, parser.getLineErrors());
+    TEST_ASSERT_TRUE(strlen(parser.getEvent().device) < MAX_SRC_DEV_LENGTH);
+}
+
+
+void test_invalidCharactersAreIgnoredAndCounted() {
+    const char line[] = "XP\x01" "DR;\tCODE;12\x7f" "34\xff\n";
+    feed(line, sizeof(line) - 1);
+    TEST_ASSERT_EQUAL(1, completedLines);
+    assertEvent("XPDR", "CODE", "1234", "");
+    TEST_ASSERT_EQUAL(4, parser.getInvalidChars());
+    TEST_ASSERT_EQUAL(0, parser.getLineErrors());
+}
+
+
+void test_onlyInvalidCharactersGiveNoEvent() {
+    const char line[] = "\x01\x02\x03\x80\x90\n";
+    feed(line, sizeof(line) - 1);
+    TEST_ASSERT_EQUAL(0, completedLines);
+    TEST_ASSERT_EQUAL(5, parser.getInvalidChars());
+}
+
+
+/**
+ * @brief Zufällige Bytes (reproduzierbar): kein Feld darf je über seine Größe hinaus gefüllt sein.
+ */
+void test_randomBytesNeverOverflowFields() {
+    uint32_t seed = 12345;
+    for (uint32_t i = 0; i < 200000; ++i) {
+        seed = seed * 1103515245 + 12345;
+        const uint8_t value = static_cast<uint8_t>(seed >> 16);
+        // Trennzeichen und Zeilenenden häufiger als bei gleichverteilten Bytes
+        const char inChar = (value < 24) ? ';' : ((value < 32) ? '\n' : static_cast<char>(value));
+        if (parser.receiveChar(inChar)) {
+            ++completedLines;
+            const EventClass &event = parser.getEvent();
+            TEST_ASSERT_TRUE(strlen(event.device) < MAX_SRC_DEV_LENGTH);
+            TEST_ASSERT_TRUE(strlen(event.event) < MAX_SRC_DEV_LENGTH);
+            TEST_ASSERT_TRUE(strlen(event.parameter1) < MAX_PARA_LENGTH);
+            TEST_ASSERT_TRUE(strlen(event.parameter2) < MAX_PARA_LENGTH);
+        }
+    }
+    TEST_ASSERT_GREATER_THAN(0, completedLines);
+    TEST_ASSERT_GREATER_THAN(0, parser.getLineErrors());
+}
+
+
+/*********************************************************************************************************//**
+ * Durchsatz
+ ************************************************************************************************************/
+
+/**
+ * @brief Durchsatz auf dem PC messen. Ausgegeben wird die Zeit je Zeichen für kurze und lange Zeilen;
+ *        da der Parser jedes Zeichen sofort verarbeitet, sollte sie von der Zeilenlänge unabhängig sein.
+ */
+void test_benchmarkThroughput() {
+    const char *lines[] = {"LED;ON;1;2\n", "M803;TIME;123456;654321\n"};
+    const uint32_t repetitions = 200000;
+    for (const char *line : lines) {
+        const size_t length = strlen(line);
+        completedLines = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < repetitions; ++i) {
+            feed(line, length);
+        }
+        const auto end = std::chrono::steady_clock::now();
+        const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        printf("Parser: %2u Zeichen/Zeile, %.1f ns/Zeichen, %.0f Zeilen/s\n", static_cast<unsigned>(length),
+               ns / (static_cast<double>(repetitions) * length), repetitions * 1e9 / ns);
+        TEST_ASSERT_EQUAL(repetitions, completedLines);
+    }
+}
+
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_validLineIsUppercasedAndInterned);
+    RUN_TEST(test_crLfAndEmptyLinesGiveOneEvent);
+    RUN_TEST(test_fieldsOfMaximumLengthAreAccepted);
+    RUN_TEST(test_missingFieldsStayEmpty);
+    RUN_TEST(test_extraFieldsAreIgnored);
+    RUN_TEST(test_lineIsCompletedOnlyByTerminator);
+    RUN_TEST(test_overlongFieldsDiscardTheLine);
+    RUN_TEST(test_parserRecoversAfterDiscardedLine);
+    RUN_TEST(test_veryLongGarbageLineCountsOnce);
+    RUN_TEST(test_invalidCharactersAreIgnoredAndCounted);
+    RUN_TEST(test_onlyInvalidCharactersGiveNoEvent);
+    RUN_TEST(test_randomBytesNeverOverflowFields);
+    RUN_TEST(test_benchmarkThroughput);
+    return UNITY_END();
+}
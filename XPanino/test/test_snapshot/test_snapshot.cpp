@@ -0,0 +1,111 @@
+/*********************************************************************************************************//**
+ * @file test_snapshot.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Momentaufnahme der Schaltermatrix: Bitmap, Änderungsstatus der Schalter und erneuter Versuch.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ * Die Momentaufnahme darf noch nicht übertragene Änderungen nicht verschlucken, und eine volle
+ * Sendewarteschlange verschiebt sie nur, statt sie zu verwerfen.
+ *
+ ************************************************************************************************************/
+
+#include <unity.h>
+#include <Switchmatrix.hpp>
+#include <txqueue.hpp>
+
+extern TxQueueClass txQueue;
+
+
+/// Einen Schalter der Matrix schließen bzw. öffnen.
+static void setSwitch(const uint8_t row, const uint8_t col, const bool isClosed) {
+    hostSetContact(HW_MATRIX_ROWS_LSB_PIN + row, HW_MATRIX_COLS_LSB_PIN + col, isClosed);
+}
+
+
+/// Alles aus der Sendewarteschlange senden und liefern.
+static std::string flushAll() {
+    std::string sent;
+    for (uint8_t i = 0; (i < TX_QUEUE_SIZE) && (txQueue.getCount() > 0); ++i) {
+        txQueue.flush();
+        sent += Serial.hostTakeOutput();
+    }
+    return sent;
+}
+
+
+void setUp() {
+    hostReset();
+    txQueue = TxQueueClass();
+}
+
+
+void tearDown() {}
+
+
+void test_snapshotIsBitmapPerRow() {
+    SwitchMatrix matrix;
+    matrix.initHardware();
+    setSwitch(2, 6, true);
+    setSwitch(3, 7, true);
+    matrix.scanSwitchPins(100);
+    matrix.transmitSnapshot();
+    TEST_ASSERT_EQUAL_STRING("S;M;00004080\r\n", flushAll().c_str());
+}
+
+
+void test_snapshotKeepsPendingChanges() {
+    SwitchMatrix matrix;
+    matrix.initHardware();
+    setSwitch(2, 5, true);
+    matrix.scanSwitchPins(100);
+    matrix.transmitSnapshot();
+    matrix.transmitStatus(TRANSMIT_ONLY_CHANGED_SWITCHES);
+    // Die Änderung geht nach der Momentaufnahme trotzdem als Ereignis an den PC
+    TEST_ASSERT_EQUAL_STRING("S;M;00002000\r\nS;S;ON;2;5\r\n", flushAll().c_str());
+}
+
+
+void test_deviceSwitchesAreMasked() {
+    SwitchMatrix matrix;
+    matrix.initHardware();
+    setSwitch(0, 2, true);      // Taste des Transponders
+    setSwitch(2, 5, true);
+    matrix.scanSwitchPins(100);
+    matrix.transmitSnapshot();
+    TEST_ASSERT_EQUAL_STRING("S;M;00002000\r\n", flushAll().c_str());
+}
+
+
+void test_fullQueueRetriesSnapshot() {
+    SwitchMatrix matrix;
+    matrix.initHardware();
+    setSwitch(3, 5, true);
+    matrix.scanSwitchPins(100);
+    while (! txQueue.isFull()) {
+        txQueue.addTimeSync(0);
+    }
+    matrix.transmitSnapshot();
+    TEST_ASSERT_FALSE(matrix.transmitStatus(TRANSMIT_ONLY_CHANGED_SWITCHES));   // Änderungen warten dahinter
+    TEST_ASSERT_EQUAL(TX_QUEUE_SIZE, txQueue.getCount());
+    flushAll();
+
+    TEST_ASSERT_TRUE(matrix.transmitStatus(TRANSMIT_ONLY_CHANGED_SWITCHES));
+    TEST_ASSERT_EQUAL_STRING("S;M;00000020\r\nS;S;ON;3;5\r\n", flushAll().c_str());
+
+    // Angefordert wird nur einmal
+    TEST_ASSERT_TRUE(matrix.transmitStatus(TRANSMIT_ONLY_CHANGED_SWITCHES));
+    TEST_ASSERT_EQUAL_STRING("", flushAll().c_str());
+}
+
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_snapshotIsBitmapPerRow);
+    RUN_TEST(test_snapshotKeepsPendingChanges);
+    RUN_TEST(test_deviceSwitchesAreMasked);
+    RUN_TEST(test_fullQueueRetriesSnapshot);
+    return UNITY_END();
+}
@@ -0,0 +1,234 @@
+/*********************************************************************************************************//**
+ * @file test_statesync.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Abgleich des Anzeigezustands: Momentaufnahme, Änderungen von Version zu Version und Bericht an den PC.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ * Die Records werden direkt an StateSyncClass übergeben; die Antworten des Arduino werden im
+ * Klartextprotokoll (Z;W und Z;V) gelesen. Zusätzlich wird die Größe eines vollständigen Abgleichs
+ * im Binärprotokoll ausgegeben.
+ *
+ ************************************************************************************************************/
+
+#include <unity.h>
+#include <vector>
+#include <ledmatrix.hpp>
+#include <link.hpp>
+#include <protocol.hpp>
+#include <statesync.hpp>
+#include <txqueue.hpp>
+
+extern LedMatrix leds;
+extern LinkClass linkLayer;
+extern ProtocolClass protocol;
+extern TxQueueClass txQueue;
+
+using Record = std::vector<uint8_t>;
+
+
+/// Einen Record aus zwei Kopfbytes und Einträgen (Index, Wert) aufbauen.
+static Record makeRecord(const uint8_t first, const uint8_t second,
+                         std::initializer_list<std::pair<uint8_t, uint32_t>> entries) {
+    Record record {first, second};
+    for (const auto &entry : entries) {
+        record.push_back(entry.first);
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            record.push_back(static_cast<uint8_t>(entry.second >> shift));
+        }
+    }
+    return record;
+}
+
+
+/// Anstehende Meldungen des Abgleichs senden und als Text liefern.
+static std::string drain(StateSyncClass &sync, const unsigned long now = 0) {
+    std::string sent;
+    for (uint8_t pass = 0; pass < 20; ++pass) {
+        sync.update(now);
+        txQueue.flush();
+        sent += Serial.hostTakeOutput();
+    }
+    return sent;
+}
+
+
+void setUp() {
+    hostReset();
+    txQueue = TxQueueClass();
+    protocol = ProtocolClass();
+    linkLayer = LinkClass();
+    leds = LedMatrix();
+}
+
+
+void tearDown() {}
+
+
+void test_snapshotSetsVersionAndWords() {
+    StateSyncClass sync;
+    TEST_ASSERT_EQUAL(0, sync.getVersion());
+    const Record snapshot = makeRecord(5, STATE_FLAG_FIRST | STATE_FLAG_LAST, {{0, 0x81}, {3, 0x40000000}});
+    sync.receiveSnapshot(snapshot.data(), snapshot.size(), 0);
+    TEST_ASSERT_EQUAL(5, sync.getVersion());
+    TEST_ASSERT_EQUAL_HEX32(0x81, leds.getStateWord(0));
+    TEST_ASSERT_EQUAL_HEX32(0x40000000, leds.getStateWord(3));
+    TEST_ASSERT_EQUAL_STRING("Z;V;5\r\n", drain(sync).c_str());     // Bestätigung
+}
+
+
+void test_snapshotClearsWordsNotSent() {
+    StateSyncClass sync;
+    leds.setStateWord(1, 0xFFFF);
+    const Record snapshot = makeRecord(2, STATE_FLAG_FIRST | STATE_FLAG_LAST, {{0, 1}});
+    sync.receiveSnapshot(snapshot.data(), snapshot.size(), 0);
+    TEST_ASSERT_EQUAL_HEX32(0, leds.getStateWord(1));
+}
+
+
+void test_versionChangesOnlyWithLastRecord() {
+    StateSyncClass sync;
+    const Record first = makeRecord(7, STATE_FLAG_FIRST, {{0, 1}});
+    const Record middle = makeRecord(7, 0, {{1, 2}});
+    const Record last = makeRecord(7, STATE_FLAG_LAST, {{2, 3}});
+    sync.receiveSnapshot(first.data(), first.size(), 0);
+    sync.receiveSnapshot(middle.data(), middle.size(), 10);
+    TEST_ASSERT_EQUAL(0, sync.getVersion());
+    TEST_ASSERT_EQUAL_STRING("", drain(sync, 20).c_str());
+    sync.receiveSnapshot(last.data(), last.size(), 30);
+    TEST_ASSERT_EQUAL(7, sync.getVersion());
+    TEST_ASSERT_EQUAL_HEX32(2, leds.getStateWord(1));
+    TEST_ASSERT_EQUAL(0, sync.getRejected());
+}
+
+
+void test_recordWithoutFirstIsRejected() {
+    StateSyncClass sync;
+    const Record last = makeRecord(7, STATE_FLAG_LAST, {{0, 1}});
+    sync.receiveSnapshot(last.data(), last.size(), 0);
+    TEST_ASSERT_EQUAL(0, sync.getVersion());
+    TEST_ASSERT_EQUAL(1, sync.getRejected());
+    TEST_ASSERT_EQUAL_HEX32(0, leds.getStateWord(0));
+    TEST_ASSERT_EQUAL_STRING("Z;V;0\r\n", drain(sync).c_str());     // der PC soll neu senden
+}
+
+
+void test_incompleteSnapshotTimesOut() {
+    StateSyncClass sync;
+    const Record done = makeRecord(3, STATE_FLAG_FIRST | STATE_FLAG_LAST, {{0, 1}});
+    sync.receiveSnapshot(done.data(), done.size(), 0);
+    drain(sync);
+    const Record first = makeRecord(4, STATE_FLAG_FIRST, {{0, 2}});
+    sync.receiveSnapshot(first.data(), first.size(), 1000);
+    TEST_ASSERT_EQUAL_STRING("", drain(sync, 1000 + STATE_SYNC_TIMEOUT - 1).c_str());
+    TEST_ASSERT_EQUAL_STRING("Z;V;0\r\n", drain(sync, 1000 + STATE_SYNC_TIMEOUT).c_str());
+    TEST_ASSERT_EQUAL(0, sync.getVersion());
+
+    // Ein später Rest der abgebrochenen Momentaufnahme gilt nicht mehr
+    const Record last = makeRecord(4, STATE_FLAG_LAST, {{1, 2}});
+    sync.receiveSnapshot(last.data(), last.size(), 1600);
+    TEST_ASSERT_EQUAL(0, sync.getVersion());
+}
+
+
+void test_deltaRequiresMatchingBaseVersion() {
+    StateSyncClass sync;
+    const Record early = makeRecord(0, 1, {{0, 1}});
+    sync.receiveDelta(early.data(), early.size());          // noch keine Momentaufnahme
+    TEST_ASSERT_EQUAL(0, sync.getVersion());
+    TEST_ASSERT_EQUAL_HEX32(0, leds.getStateWord(0));
+
+    const Record snapshot = makeRecord(10, STATE_FLAG_FIRST | STATE_FLAG_LAST, {{0, 1}});
+    sync.receiveSnapshot(snapshot.data(), snapshot.size(), 0);
+    drain(sync);
+
+    const Record delta = makeRecord(10, 11, {{0, 3}});
+    sync.receiveDelta(delta.data(), delta.size());
+    TEST_ASSERT_EQUAL(11, sync.getVersion());
+    TEST_ASSERT_EQUAL_HEX32(3, leds.getStateWord(0));
+    TEST_ASSERT_EQUAL_STRING("", drain(sync).c_str());      // Änderungen werden nicht bestätigt
+
+    const Record stale = makeRecord(10, 12, {{0, 7}});      // Basis passt nicht mehr
+    sync.receiveDelta(stale.data(), stale.size());
+    TEST_ASSERT_EQUAL(11, sync.getVersion());
+    TEST_ASSERT_EQUAL_HEX32(3, leds.getStateWord(0));
+    TEST_ASSERT_EQUAL(2, sync.getRejected());
+    TEST_ASSERT_EQUAL_STRING("Z;V;11\r\n", drain(sync).c_str());
+}
+
+
+void test_deltaWithInvalidIndexChangesNothing() {
+    StateSyncClass sync;
+    const Record snapshot = makeRecord(1, STATE_FLAG_FIRST | STATE_FLAG_LAST, {});
+    sync.receiveSnapshot(snapshot.data(), snapshot.size(), 0);
+    drain(sync);
+    const Record delta = makeRecord(1, 2, {{0, 5}, {STATE_WORD_COUNT, 1}});
+    sync.receiveDelta(delta.data(), delta.size());
+    TEST_ASSERT_EQUAL(1, sync.getVersion());
+    TEST_ASSERT_EQUAL_HEX32(0, leds.getStateWord(0));       // auch der gültige erste Eintrag nicht
+
+    const Record truncated = makeRecord(1, 2, {{0, 5}});
+    sync.receiveDelta(truncated.data(), truncated.size() - 1);
+    TEST_ASSERT_EQUAL(1, sync.getVersion());
+    TEST_ASSERT_EQUAL(2, sync.getRejected());
+}
+
+
+void test_reportSendsUsedWordsThenVersion() {
+    StateSyncClass sync;
+    const Record snapshot = makeRecord(9, STATE_FLAG_FIRST | STATE_FLAG_LAST,
+                                       {{0, 0x11}, {2, 0x22}, {4, 0x33}, {6, 0x44}, {8, 0x55}, {LED_ROWS + 1, 0x66}});
+    sync.receiveSnapshot(snapshot.data(), snapshot.size(), 0);
+    drain(sync);
+
+    sync.requestReport();
+    sync.update(0);
+    TEST_ASSERT_TRUE(txQueue.getCount() <= TX_QUEUE_SIZE / 2);     // die andere Hälfte bleibt frei
+    const std::string sent = drain(sync);
+    TEST_ASSERT_EQUAL_STRING("Z;W;0;11\r\nZ;W;2;22\r\nZ;W;4;33\r\nZ;W;6;44\r\nZ;W;8;55\r\nZ;W;9;66\r\nZ;V;9\r\n",
+                             sent.c_str());
+}
+
+
+/**
+ * @brief Bytes eines vollständigen Abgleichs im Binärprotokoll: Bericht des Arduino über eine
+ *        typische Anzeige (LEDs einer Zeile und zwei Blink-Worte) und Bestätigung.
+ */
+void test_resyncSizeInBinaryMode() {
+    StateSyncClass sync;
+    const Record snapshot = makeRecord(9, STATE_FLAG_FIRST | STATE_FLAG_LAST,
+                                       {{0, 0x0F0F}, {1, 0xFFFF}, {LED_ROWS, 0x3}, {LED_ROWS + 1, 0x3}});
+    TEST_ASSERT_TRUE(snapshot.size() <= FRAME_MAX_LENGTH);      // eine Momentaufnahme in einem Frame
+    sync.receiveSnapshot(snapshot.data(), snapshot.size(), 0);
+    protocol.setMode(ProtocolMode::BINARY);
+    sync.requestReport();
+    uint8_t passes = 0;
+    std::string sent;
+    do {
+        sync.update(0);
+        txQueue.flush();
+        sent += Serial.hostTakeOutput();
+        ++passes;
+    } while ((txQueue.getCount() > 0) && (passes < 20));
+    TEST_ASSERT_EQUAL(0, txQueue.getCount());
+    printf("Abgleich: PC -> Arduino %u Bytes Nutzdaten, Arduino -> PC %u Bytes in %u loop()-Durchläufen\n",
+           static_cast<unsigned>(snapshot.size()), static_cast<unsigned>(sent.size()), passes);
+    TEST_ASSERT_TRUE(passes <= 3);
+}
+
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_snapshotSetsVersionAndWords);
+    RUN_TEST(test_snapshotClearsWordsNotSent);
+    RUN_TEST(test_versionChangesOnlyWithLastRecord);
+    RUN_TEST(test_recordWithoutFirstIsRejected);
+    RUN_TEST(test_incompleteSnapshotTimesOut);
+    RUN_TEST(test_deltaRequiresMatchingBaseVersion);
+    RUN_TEST(test_deltaWithInvalidIndexChangesNothing);
+    RUN_TEST(test_reportSendsUsedWordsThenVersion);
+    RUN_TEST(test_resyncSizeInBinaryMode);
+    return UNITY_END();
+}
@@ -0,0 +1,176 @@
+/*********************************************************************************************************//**
+ * @file test_switchedge.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Interrupt-Betrieb der Schaltermatrix: eingespeiste Flanken lösen die Abfrage der betroffenen Spalten aus.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ * Die Flanken werden wie von der Interrupt-Routine über onPinChange() bzw. direkt über onColumnEdge()
+ * eingespeist. Die Pin-Zugriffe werden über hostSetPinHook() gezählt.
+ *
+ ************************************************************************************************************/
+
+#include <unity.h>
+#include <Switchmatrix.hpp>
+#include <txqueue.hpp>
+
+extern TxQueueClass txQueue;
+
+static uint16_t pinWrites = 0;      ///< Anzahl der digitalWrite()-Aufrufe
+
+static void countPinWrite(const uint8_t, const uint8_t) { ++pinWrites; }
+
+
+/// Einen Schalter der Matrix schließen bzw. öffnen.
+static void setSwitch(const uint8_t row, const uint8_t col, const bool isClosed) {
+    hostSetContact(HW_MATRIX_ROWS_LSB_PIN + row, HW_MATRIX_COLS_LSB_PIN + col, isClosed);
+}
+
+
+/// Geänderte Schalterstände in die Sendewarteschlange stellen und alles Gesendete liefern.
+static std::string transmit(SwitchMatrix &matrix) {
+    matrix.transmitStatus(TRANSMIT_ONLY_CHANGED_SWITCHES);
+    std::string sent;
+    for (uint8_t i = 0; (i < TX_QUEUE_SIZE) && (txQueue.getCount() > 0); ++i) {
+        txQueue.flush();
+        sent += Serial.hostTakeOutput();
+    }
+    return sent;
+}
+
+
+/// Prüfen, ob alle Matrixzeilen auf dem Pegel level liegen.
+static bool areAllRowsAt(const uint8_t level) {
+    for (uint8_t pin = HW_MATRIX_ROWS_LSB_PIN; pin <= HW_MATRIX_ROWS_MSB_PIN; ++pin) {
+        if (hostGetPinLevel(pin) != level) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+void setUp() {
+    hostReset();
+    txQueue = TxQueueClass();
+    pinWrites = 0;
+    hostSetPinHook(countPinWrite);
+}
+
+
+void tearDown() {}
+
+
+void test_rowsAreLowBetweenScans() {
+    SwitchMatrix matrix;
+    matrix.initHardware();
+    matrix.enableInterruptMode(true);
+    TEST_ASSERT_TRUE(areAllRowsAt(LOW));
+
+    matrix.onColumnEdge(1 << 5);
+    matrix.scanPendingColumns(100);
+    TEST_ASSERT_TRUE(areAllRowsAt(LOW));    // Ruhezustand nach der Abfrage wiederhergestellt
+
+    matrix.enableInterruptMode(false);
+    TEST_ASSERT_TRUE(areAllRowsAt(HIGH));
+}
+
+
+void test_idlePassTouchesNoPins() {
+    SwitchMatrix matrix;
+    matrix.initHardware();
+    matrix.enableInterruptMode(true);
+    pinWrites = 0;
+    for (unsigned long now = 0; now < 1000; ++now) {
+        TEST_ASSERT_FALSE(matrix.scanPendingColumns(now));
+    }
+    TEST_ASSERT_EQUAL(0, pinWrites);
+}
+
+
+void test_pinChangeReportsPressInSamePass() {
+    SwitchMatrix matrix;
+    matrix.initHardware();
+    matrix.enableTimestamps(true, 0);
+    matrix.enableInterruptMode(true);
+
+    setSwitch(3, 6, true);
+    matrix.onPinChange();               // wie die Interrupt-Routine
+    TEST_ASSERT_TRUE(matrix.scanPendingColumns(1234));
+    // Zeitsynchronisation vom Einschalten der Zeitstempel, dann das Ereignis mit Zeitstempel (hex) der Flanke
+    TEST_ASSERT_EQUAL_STRING("S;T;0\r\nS;S;ON;3;6;4D2\r\n", transmit(matrix).c_str());
+
+    setSwitch(3, 6, false);
+    matrix.onPinChange();
+    TEST_ASSERT_TRUE(matrix.scanPendingColumns(1300));
+    TEST_ASSERT_EQUAL_STRING("S;S;OFF;3;6;514\r\n", transmit(matrix).c_str());
+}
+
+
+void test_onlyEdgeColumnsAreScanned() {
+    SwitchMatrix matrix;
+    matrix.initHardware();
+    matrix.enableInterruptMode(true);
+
+    setSwitch(2, 5, true);
+    setSwitch(2, 6, true);
+    matrix.onColumnEdge(1 << 5);        // eingespeiste Flanke nur an Spalte 5
+    TEST_ASSERT_TRUE(matrix.scanPendingColumns(100));
+    TEST_ASSERT_EQUAL_STRING("S;S;ON;2;5\r\n", transmit(matrix).c_str());
+
+    // Spalte 6 erst mit ihrer eigenen Flanke bzw. der nächsten vollständigen Abfrage
+    TEST_ASSERT_FALSE(matrix.scanPendingColumns(101));
+    matrix.scanSwitchPins(150);
+    TEST_ASSERT_EQUAL_STRING("S;S;ON;2;6\r\n", transmit(matrix).c_str());
+}
+
+
+void test_edgeWithoutChangeSendsNothing() {
+    SwitchMatrix matrix;
+    matrix.initHardware();
+    matrix.enableInterruptMode(true);
+
+    matrix.onColumnEdge(0xFF);          // z.B. Störimpuls oder bereits wieder geöffneter Kontakt
+    TEST_ASSERT_TRUE(matrix.scanPendingColumns(100));
+    TEST_ASSERT_EQUAL_STRING("", transmit(matrix).c_str());
+    TEST_ASSERT_FALSE(matrix.scanPendingColumns(101));
+}
+
+
+void test_edgesAreCollectedUntilScan() {
+    SwitchMatrix matrix;
+    matrix.initHardware();
+    matrix.enableInterruptMode(true);
+
+    setSwitch(2, 5, true);
+    matrix.onPinChange();
+    setSwitch(3, 7, true);
+    matrix.onPinChange();
+    TEST_ASSERT_TRUE(matrix.scanPendingColumns(100));
+    TEST_ASSERT_EQUAL_STRING("S;S;ON;2;5\r\nS;S;ON;3;7\r\n", transmit(matrix).c_str());
+}
+
+
+void test_disablingInterruptModeDropsPendingEdges() {
+    SwitchMatrix matrix;
+    matrix.initHardware();
+    matrix.enableInterruptMode(true);
+    matrix.onColumnEdge(1 << 5);
+    matrix.enableInterruptMode(false);
+    TEST_ASSERT_FALSE(matrix.scanPendingColumns(100));
+}
+
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_rowsAreLowBetweenScans);
+    RUN_TEST(test_idlePassTouchesNoPins);
+    RUN_TEST(test_pinChangeReportsPressInSamePass);
+    RUN_TEST(test_onlyEdgeColumnsAreScanned);
+    RUN_TEST(test_edgeWithoutChangeSendsNothing);
+    RUN_TEST(test_edgesAreCollectedUntilScan);
+    RUN_TEST(test_disablingInterruptModeDropsPendingEdges);
+    return UNITY_END();
+}
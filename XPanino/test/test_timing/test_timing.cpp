@@ -0,0 +1,357 @@
+/*********************************************************************************************************//**
+ * @file test_timing.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Zeitverhalten von Entprellen, langem Tastendruck, Blinken und Ablaufsteuerung mit simulierter Uhr.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ * Die Zeit kommt über frameClock.setSource() von einer simulierten Uhr, die nur der Test weiterstellt. Die
+ * Schalter werden über hostSetContact() betätigt; die LED-Matrix wird an den Pins der Schieberegister
+ * mitgelesen (hostSetPinHook()).
+ *
+ ************************************************************************************************************/
+
+#include <unity.h>
+#include <Switchmatrix.hpp>
+#include <frameclock.hpp>
+#include <ledmatrix.hpp>
+#include <scheduler.hpp>
+#include <txqueue.hpp>
+
+extern FrameClockClass frameClock;
+extern TxQueueClass txQueue;
+
+const uint8_t TEST_ROW = 2;         ///< Schalter, der zu keinem Gerät gehört und an den PC geht
+const uint8_t TEST_COL = 5;
+
+static unsigned long simulatedTime = 0;     ///< Zeit der simulierten Uhr in ms
+
+/// Zeitquelle für frameClock.
+static unsigned long simulatedClock() { return simulatedTime; }
+
+
+/// Die simulierte Uhr stellen und den Durchlauf wie in loop() beginnen.
+static unsigned long startPass(const unsigned long now) {
+    simulatedTime = now;
+    return frameClock.tick();
+}
+
+
+/// Den Testschalter schließen bzw. öffnen.
+static void setTestSwitch(const bool isClosed) {
+    hostSetContact(HW_MATRIX_ROWS_LSB_PIN + TEST_ROW, HW_MATRIX_COLS_LSB_PIN + TEST_COL, isClosed);
+}
+
+
+/// Die Schaltermatrix abfragen, geänderte Schalterstände in die Sendewarteschlange stellen und alles Gesendete liefern.
+static std::string scanAndTransmit(SwitchMatrix &matrix, const unsigned long now) {
+    startPass(now);
+    matrix.scanSwitchPins(frameClock.getNow());
+    matrix.transmitStatus(TRANSMIT_ONLY_CHANGED_SWITCHES);
+    std::string sent;
+    for (uint8_t i = 0; (i < TX_QUEUE_SIZE) && (txQueue.getCount() > 0); ++i) {
+        txQueue.flush();
+        sent += Serial.hostTakeOutput();
+    }
+    return sent;
+}
+
+
+/*********************************************************************************************************//**
+ * Nachbildung der Schieberegister der LED-Matrix: 32 Column-Bits, dann 8 Row-Bits; STRB = HIGH übernimmt.
+ ************************************************************************************************************/
+const uint8_t CLOCK = PIN4;     ///< Pins der Schieberegister wie in ledmatrix.cpp
+const uint8_t DATA_IN = PIN5;
+const uint8_t STRB = PIN3;
+
+static uint64_t shiftRegister = 0;          ///< Inhalt der Schieberegister
+static uint8_t lastClockLevel = LOW;        ///< Pegel an CLOCK, um die steigende Flanke zu erkennen
+static uint32_t latchedRows[LED_ROWS];      ///< Zuletzt an die Outputs geschaltete Columns je Row
+
+static void onPinWrite(const uint8_t pin, const uint8_t level) {
+    if ((pin == CLOCK) && (level == HIGH) && (lastClockLevel == LOW)) {
+        shiftRegister = (shiftRegister << 1) | hostGetPinLevel(DATA_IN);
+    }
+    if (pin == CLOCK) {
+        lastClockLevel = level;
+    }
+    if ((pin == STRB) && (level == HIGH)) {
+        const uint8_t rowBits = static_cast<uint8_t>(shiftRegister & 0xFF);
+        for (uint8_t row = 0; row < LED_ROWS; ++row) {
+            if (rowBits == (1U << row)) {
+                latchedRows[row] = static_cast<uint32_t>(shiftRegister >> 8);
+            }
+        }
+    }
+}
+
+
+/// Einen Refresh der LED-Matrix wie refreshLeds() ausführen und die angezeigte LED liefern.
+static bool isLitAfterRefresh(LedMatrix &matrix, const LedMatrixPos pos, const unsigned long now) {
+    startPass(now);
+    matrix.writeToHardware(frameClock.getNow());
+    return (latchedRows[pos.row] & (static_cast<uint32_t>(1) << pos.col)) != 0;
+}
+
+
+void setUp() {
+    hostReset();
+    txQueue = TxQueueClass();
+    simulatedTime = 0;
+    frameClock.setSource(simulatedClock);
+    frameClock.tick();
+    shiftRegister = 0;
+    lastClockLevel = LOW;
+    memset(latchedRows, 0, sizeof(latchedRows));
+    hostSetPinHook(onPinWrite);
+}
+
+
+void tearDown() {
+    frameClock.setSource(nullptr);
+}
+
+
+/*********************************************************************************************************//**
+ * Entprellen und langer Tastendruck
+ ************************************************************************************************************/
+void test_changesWithinDebounceTimeAreHeldBack() {
+    SwitchMatrix matrix;
+    matrix.initHardware();
+    scanAndTransmit(matrix, 50);
+
+    setTestSwitch(true);
+    TEST_ASSERT_EQUAL_STRING("S;S;ON;2;5\r\n", scanAndTransmit(matrix, 100).c_str());
+
+    // Prellen: öffnen und wieder schließen innerhalb der Entprellzeit von 9 ms
+    setTestSwitch(false);
+    TEST_ASSERT_EQUAL_STRING("", scanAndTransmit(matrix, 105).c_str());
+    setTestSwitch(true);
+    TEST_ASSERT_EQUAL_STRING("", scanAndTransmit(matrix, 107).c_str());
+    setTestSwitch(false);
+    TEST_ASSERT_EQUAL_STRING("", scanAndTransmit(matrix, 108).c_str());
+
+    // Nach der Entprellzeit wird der endgültige Stand übernommen
+    TEST_ASSERT_EQUAL_STRING("S;S;OFF;2;5\r\n", scanAndTransmit(matrix, 109).c_str());
+}
+
+
+void test_longPressIsReportedAfterThreeSeconds() {
+    SwitchMatrix matrix;
+    matrix.initHardware();
+    scanAndTransmit(matrix, 500);
+
+    setTestSwitch(true);
+    TEST_ASSERT_EQUAL_STRING("S;S;ON;2;5\r\n", scanAndTransmit(matrix, 1000).c_str());
+    TEST_ASSERT_EQUAL_STRING("", scanAndTransmit(matrix, 3999).c_str());
+    TEST_ASSERT_EQUAL_STRING("S;S;LON;2;5\r\n", scanAndTransmit(matrix, 4000).c_str());
+    TEST_ASSERT_EQUAL_STRING("", scanAndTransmit(matrix, 5000).c_str());
+
+    setTestSwitch(false);
+    TEST_ASSERT_EQUAL_STRING("S;S;OFF;2;5\r\n", scanAndTransmit(matrix, 5100).c_str());
+}
+
+
+void test_switchTimingFollowsFrameClockNotMillis() {
+    SwitchMatrix matrix;
+    matrix.initHardware();
+    scanAndTransmit(matrix, 1000);
+    setTestSwitch(true);
+    scanAndTransmit(matrix, 1000);
+
+    // millis() läuft weiter, die Zeitquelle des Durchlaufs nicht: kein langer Tastendruck
+    hostAdvanceMillis(10000);
+    TEST_ASSERT_EQUAL_STRING("", scanAndTransmit(matrix, 1500).c_str());
+}
+
+
+/*********************************************************************************************************//**
+ * Blinken
+ ************************************************************************************************************/
+void test_blinkPhasesFollowBlinkTimes() {
+    LedMatrix matrix;
+    matrix.initHardware();
+    const LedMatrixPos pos {2, 7};
+    matrix.ledOn(pos);
+    matrix.ledBlinkOn(pos, BLINK_NORMAL);
+    const unsigned long brightTime = blinkTimes[BLINK_NORMAL].getBrightTime();
+    const unsigned long darkTime = blinkTimes[BLINK_NORMAL].getDarkTime();
+
+    // Das Blinken beginnt dunkel; die erste Phase dauert so lange wie die Hellzeit (Initialwert des Intervalls).
+    // Umgeschaltet wird beim ersten Refresh nach Ablauf des Intervalls.
+    TEST_ASSERT_FALSE(isLitAfterRefresh(matrix, pos, 0));
+    for (unsigned long now = 1; now <= brightTime; ++now) {
+        TEST_ASSERT_FALSE(isLitAfterRefresh(matrix, pos, now));
+    }
+    const unsigned long brightStart = brightTime + 1;
+    TEST_ASSERT_TRUE(isLitAfterRefresh(matrix, pos, brightStart));
+
+    // Die Hellphase dauert die Hellzeit, gerechnet ab dem Umschalten; danach die Dunkelphase mit der Dunkelzeit.
+    for (unsigned long now = brightStart + 1; now <= brightStart + brightTime; ++now) {
+        TEST_ASSERT_TRUE(isLitAfterRefresh(matrix, pos, now));
+    }
+    const unsigned long darkStart = brightStart + brightTime + 1;
+    TEST_ASSERT_FALSE(isLitAfterRefresh(matrix, pos, darkStart));
+    for (unsigned long now = darkStart + 1; now <= darkStart + darkTime; ++now) {
+        TEST_ASSERT_FALSE(isLitAfterRefresh(matrix, pos, now));
+    }
+    TEST_ASSERT_TRUE(isLitAfterRefresh(matrix, pos, darkStart + darkTime + 1));
+}
+
+
+void test_blinkStandsStillWhileFrameClockStandsStill() {
+    LedMatrix matrix;
+    matrix.initHardware();
+    const LedMatrixPos pos {0, 0};
+    matrix.ledOn(pos);
+    matrix.ledBlinkOn(pos, BLINK_NORMAL);
+    const bool firstPhase = isLitAfterRefresh(matrix, pos, 0);
+
+    hostAdvanceMillis(5000);
+    TEST_ASSERT_EQUAL(firstPhase, isLitAfterRefresh(matrix, pos, 0));
+    TEST_ASSERT_EQUAL(! firstPhase, isLitAfterRefresh(matrix, pos, 5000));
+}
+
+
+void test_steadyLedIsNotAffectedByBlinking() {
+    LedMatrix matrix;
+    matrix.initHardware();
+    const LedMatrixPos steady {1, 3};
+    const LedMatrixPos blinking {1, 4};
+    matrix.ledOn(steady);
+    matrix.ledOn(blinking);
+    matrix.ledBlinkOn(blinking, BLINK_SLOW);
+    for (unsigned long now = 0; now < 3000; now += 50) {
+        TEST_ASSERT_TRUE(isLitAfterRefresh(matrix, steady, now));
+    }
+}
+
+
+/*********************************************************************************************************//**
+ * Ablaufsteuerung
+ ************************************************************************************************************/
+static uint16_t periodicRuns = 0;           ///< Aufrufe von periodicTask()
+static uint16_t triggeredRuns = 0;          ///< Aufrufe von triggeredTask()
+static unsigned long lastTaskNow = 0;       ///< Zeitstempel des letzten Aufrufs
+static char callOrder[8];                   ///< Reihenfolge der Aufrufe in einem Durchlauf
+static uint8_t callCount = 0;
+
+static void periodicTask(const unsigned long now) {
+    ++periodicRuns;
+    lastTaskNow = now;
+}
+
+static void triggeredTask(const unsigned long) { ++triggeredRuns; }
+
+static void taskA(const unsigned long) { callOrder[callCount++] = 'A'; }
+static void taskB(const unsigned long) { callOrder[callCount++] = 'B'; }
+static void taskC(const unsigned long) { callOrder[callCount++] = 'C'; }
+
+
+/// Einen Durchlauf von loop() zum Zeitpunkt now ausführen.
+static void runPass(SchedulerClass &scheduler, const unsigned long now) {
+    startPass(now);
+    scheduler.runDue();
+}
+
+
+void test_periodicTaskRunsOncePerPeriod() {
+    SchedulerClass scheduler;
+    periodicRuns = 0;
+    scheduler.addTask(periodicTask, 10, 0, LoopStage::SHOW);
+    for (unsigned long now = 0; now < 100; ++now) {
+        runPass(scheduler, now);
+    }
+    TEST_ASSERT_EQUAL(10, periodicRuns);
+    TEST_ASSERT_EQUAL(90, lastTaskNow);
+    TEST_ASSERT_EQUAL(0, scheduler.getOverruns());
+    TEST_ASSERT_EQUAL(0, scheduler.getMaxLateness());
+}
+
+
+void test_triggeredTaskRunsOnlyAfterTrigger() {
+    SchedulerClass scheduler;
+    triggeredRuns = 0;
+    const uint8_t taskId = scheduler.addTask(triggeredTask, TASK_ON_TRIGGER, 0, LoopStage::DISPATCH);
+    runPass(scheduler, 0);
+    runPass(scheduler, 100000);
+    TEST_ASSERT_EQUAL(0, triggeredRuns);
+
+    scheduler.trigger(taskId);
+    runPass(scheduler, 100001);
+    runPass(scheduler, 100002);
+    TEST_ASSERT_EQUAL(1, triggeredRuns);
+}
+
+
+void test_tasksRunInPriorityOrder() {
+    SchedulerClass scheduler;
+    callCount = 0;
+    scheduler.addTask(taskC, TASK_EVERY_PASS, 2, LoopStage::REFRESH);
+    scheduler.addTask(taskA, TASK_EVERY_PASS, 0, LoopStage::SCAN);
+    scheduler.addTask(taskB, TASK_EVERY_PASS, 1, LoopStage::TX);
+    runPass(scheduler, 0);
+    TEST_ASSERT_EQUAL(3, callCount);
+    TEST_ASSERT_EQUAL('A', callOrder[0]);
+    TEST_ASSERT_EQUAL('B', callOrder[1]);
+    TEST_ASSERT_EQUAL('C', callOrder[2]);
+}
+
+
+void test_lateTaskCountsOverrunAndSkipsMissedPeriods() {
+    SchedulerClass scheduler;
+    periodicRuns = 0;
+    scheduler.addTask(periodicTask, 10, 0, LoopStage::SHOW);
+    runPass(scheduler, 0);
+    runPass(scheduler, 10);
+    runPass(scheduler, 20);
+    TEST_ASSERT_EQUAL(3, periodicRuns);
+
+    // Der Durchlauf bei 30 fällt aus (z.B. lange Aufgabe); erst bei 55 geht es weiter
+    runPass(scheduler, 55);
+    TEST_ASSERT_EQUAL(4, periodicRuns);
+    TEST_ASSERT_EQUAL(1, scheduler.getOverruns());
+    TEST_ASSERT_EQUAL(25, scheduler.getMaxLateness());
+
+    // Die versäumten Perioden werden nicht nachgeholt; weiter im Raster ab 55
+    runPass(scheduler, 56);
+    runPass(scheduler, 64);
+    TEST_ASSERT_EQUAL(4, periodicRuns);
+    runPass(scheduler, 65);
+    TEST_ASSERT_EQUAL(5, periodicRuns);
+    TEST_ASSERT_EQUAL(1, scheduler.getOverruns());
+}
+
+
+void test_smallLatenessKeepsTheGrid() {
+    SchedulerClass scheduler;
+    periodicRuns = 0;
+    scheduler.addTask(periodicTask, 10, 0, LoopStage::SHOW);
+    runPass(scheduler, 0);
+    runPass(scheduler, 13);     // 3 ms zu spät
+    runPass(scheduler, 19);
+    TEST_ASSERT_EQUAL(2, periodicRuns);
+    runPass(scheduler, 20);     // planmäßig, nicht 23
+    TEST_ASSERT_EQUAL(3, periodicRuns);
+    TEST_ASSERT_EQUAL(0, scheduler.getOverruns());
+    TEST_ASSERT_EQUAL(3, scheduler.getMaxLateness());
+}
+
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_changesWithinDebounceTimeAreHeldBack);
+    RUN_TEST(test_longPressIsReportedAfterThreeSeconds);
+    RUN_TEST(test_switchTimingFollowsFrameClockNotMillis);
+    RUN_TEST(test_blinkPhasesFollowBlinkTimes);
+    RUN_TEST(test_blinkStandsStillWhileFrameClockStandsStill);
+    RUN_TEST(test_steadyLedIsNotAffectedByBlinking);
+    RUN_TEST(test_periodicTaskRunsOncePerPeriod);
+    RUN_TEST(test_triggeredTaskRunsOnlyAfterTrigger);
+    RUN_TEST(test_tasksRunInPriorityOrder);
+    RUN_TEST(test_lateTaskCountsOverrunAndSkipsMissedPeriods);
+    RUN_TEST(test_smallLatenessKeepsTheGrid);
+    return UNITY_END();
+}
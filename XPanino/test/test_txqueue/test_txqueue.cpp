@@ -0,0 +1,312 @@
+/*********************************************************************************************************//**
+ * @file test_txqueue.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Sendewarteschlange: Reihenfolge, Berichte, Antworten und Umschalten von Protokoll und Baudrate.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ * Berichte (Diagnose, Laufzeiten, Ablaufprotokoll) belegen höchstens @em TX_REPORT_LIMIT Plätze, und beim
+ * Leeren der Warteschlange wird nie auf die serielle Schnittstelle gewartet (hostGetBlockedWrites()).
+ * Ändern sich alle Schalter auf einmal, sendet die Aufgabe transmitSwitches in jedem loop() nur so viel,
+ * wie in die Warteschlange passt, und stößt sich für den Rest erneut an.
+ * Die Umschaltung auf das Binärprotokoll bzw. eine neue Baudrate erfolgt erst, wenn die Bestätigung
+ * gesendet ist.
+ *
+ ************************************************************************************************************/
+
+#include <unity.h>
+#include <control.hpp>
+#include <devices.hpp>
+#include <diagnostics.hpp>
+#include <event.hpp>
+#include <heartbeat.hpp>
+#include <link.hpp>
+#include <linkspeed.hpp>
+#include <looptiming.hpp>
+#include <protocol.hpp>
+#include <scheduler.hpp>
+#include <trace.hpp>
+#include <txqueue.hpp>
+
+extern ControlClass control;
+extern DiagnosticsClass diagnostics;
+extern EventQueueClass eventQueue;
+extern HeartbeatClass heartbeat;
+extern LinkClass linkLayer;
+extern LinkSpeedClass linkSpeed;
+extern LoopTimingClass loopTiming;
+extern ProtocolClass protocol;
+extern SchedulerClass scheduler;
+extern SwitchMatrix switches;
+extern TraceClass trace;
+extern TxQueueClass txQueue;
+extern uint8_t transmitTask;
+
+void setup();
+void loop();
+
+
+/// Ein Steuerkommando wie vom Dispatcher an die ControlClass übergeben.
+static void sendControl(const TokenId eventId, const char *parameter1 = "") {
+    EventClass event;
+    event.deviceId = TokenId::DEV_CTRL;
+    event.eventId = eventId;
+    strncpy(event.parameter1, parameter1, MAX_PARA_LENGTH - 1);
+    control.processEvent(&event);
+}
+
+
+/// Ein loop()-Durchlauf, soweit er die Sendewarteschlange betrifft.
+static void runPass() {
+    diagnostics.transmit();
+    loopTiming.transmit();
+    trace.update();
+    TEST_ASSERT_TRUE(txQueue.getCount() <= TX_REPORT_LIMIT);
+    txQueue.flush();
+}
+
+
+/// Anzahl Zeilen in text, die mit prefix beginnen.
+static uint16_t countLines(const std::string &text, const char *prefix) {
+    uint16_t lines = 0;
+    size_t start = 0;
+    while (start < text.size()) {
+        if (text.compare(start, strlen(prefix), prefix) == 0) {
+            ++lines;
+        }
+        const size_t end = text.find('\n', start);
+        start = (end == std::string::npos) ? text.size() : end + 1;
+    }
+    return lines;
+}
+
+
+void setUp() {
+    hostReset();
+    txQueue = TxQueueClass();
+    protocol = ProtocolClass();
+    linkLayer = LinkClass();
+    linkSpeed = LinkSpeedClass();
+    diagnostics = DiagnosticsClass();
+    loopTiming = LoopTimingClass();
+    trace = TraceClass();
+    linkSpeed.begin();
+}
+
+
+void tearDown() {}
+
+
+void test_messagesAreSentInOrder() {
+    const uint8_t rowBits[] = {0x00, 0x40, 0x00, 0x80};
+    TEST_ASSERT_TRUE(txQueue.addSwitchEvent(1, 6, 1, false, 0));
+    TEST_ASSERT_TRUE(txQueue.addTimeSync(0x1234));
+    TEST_ASSERT_TRUE(txQueue.addSnapshot(rowBits, sizeof(rowBits)));
+    TEST_ASSERT_EQUAL(3, txQueue.getCount());
+
+    txQueue.flush();
+    const std::string sent = Serial.hostTakeOutput();
+    TEST_ASSERT_EQUAL_STRING("S;S;ON;1;6\r\nS;T;1234\r\nS;M;00400080\r\n", sent.c_str());
+    TEST_ASSERT_EQUAL(0, txQueue.getCount());
+}
+
+
+void test_fullQueueDropsAndCounts() {
+    for (uint8_t i = 0; i < TX_QUEUE_SIZE; ++i) {
+        TEST_ASSERT_TRUE(txQueue.addTimeSync(i));
+    }
+    TEST_ASSERT_TRUE(txQueue.isFull());
+    TEST_ASSERT_FALSE(txQueue.addSwitchEvent(0, 0, 1, false, 0));
+    TEST_ASSERT_EQUAL(1, txQueue.getDropped());
+    TEST_ASSERT_EQUAL(TX_QUEUE_SIZE, txQueue.getHighWater());
+}
+
+
+void test_reportsLeaveRoomForSwitchEvents() {
+    trace.start();
+    for (uint8_t i = 0; i < 20; ++i) {
+        trace.record(TracePoint::DUMP_END, i);
+    }
+    sendControl(TokenId::EV_DIAG);
+    sendControl(TokenId::EV_PERF);
+    sendControl(TokenId::EV_TRC, "D");
+    TEST_ASSERT_EQUAL_STRING("", Serial.hostTakeOutput().c_str());     // Antworten nur über die Warteschlange
+
+    std::string sent;
+    for (uint8_t pass = 0; pass < 100; ++pass) {
+        diagnostics.transmit();
+        loopTiming.transmit();
+        trace.update();
+        TEST_ASSERT_TRUE(txQueue.getCount() <= TX_REPORT_LIMIT);
+        TEST_ASSERT_TRUE(txQueue.canAddSwitchEvent());
+        txQueue.flush();
+        sent += Serial.hostTakeOutput();
+    }
+    TEST_ASSERT_EQUAL(0, txQueue.getCount());
+    TEST_ASSERT_EQUAL(0, txQueue.getDropped());
+    TEST_ASSERT_TRUE(countLines(sent, "D;") > 0);
+    TEST_ASSERT_EQUAL(LOOP_STAGE_COUNT, countLines(sent, "P;"));
+    TEST_ASSERT_EQUAL(LOOP_STAGE_COUNT, countLines(sent, "H;"));
+    TEST_ASSERT_TRUE(countLines(sent, "T;") > 0);
+    TEST_ASSERT_EQUAL(0, Serial.hostGetBlockedWrites());
+}
+
+
+void test_fullSerialBufferNeverBlocks() {
+    sendControl(TokenId::EV_DIAG);
+    sendControl(TokenId::EV_PERF);
+    // Der PC liest nicht: der Sendepuffer läuft voll, die Warteschlange behält den Rest
+    for (uint8_t pass = 0; pass < 50; ++pass) {
+        runPass();
+    }
+    TEST_ASSERT_TRUE(txQueue.getCount() > 0);
+    TEST_ASSERT_EQUAL(0, Serial.availableForWrite());
+    TEST_ASSERT_EQUAL(0, Serial.hostGetBlockedWrites());
+
+    std::string sent = Serial.hostTakeOutput();
+    for (uint8_t pass = 0; pass < 50; ++pass) {
+        runPass();
+        sent += Serial.hostTakeOutput();
+    }
+    TEST_ASSERT_EQUAL(0, txQueue.getCount());
+    TEST_ASSERT_EQUAL(LOOP_STAGE_COUNT, countLines(sent, "P;"));
+    TEST_ASSERT_EQUAL('\n', sent[sent.size() - 1]);         // nur ganze Zeilen
+    TEST_ASSERT_EQUAL(0, Serial.hostGetBlockedWrites());
+}
+
+
+void test_binaryFlushSendsOneFrame() {
+    protocol.setMode(ProtocolMode::BINARY);
+    txQueue.addSwitchEvent(1, 6, 1, false, 0);
+    txQueue.addTimeSync(0x1234);
+
+    txQueue.flush();
+    const std::string frame = Serial.hostTakeOutput();
+    TEST_ASSERT_EQUAL(0, txQueue.getCount());
+    TEST_ASSERT_EQUAL(frame.size() - 1, frame.find('\0'));  // nur das Trennzeichen am Ende
+}
+
+
+void test_textRepliesAreDroppedInBinaryMode() {
+    TEST_ASSERT_TRUE(txQueue.addReply(TxReply::HELLO));
+    txQueue = TxQueueClass();
+    protocol.setMode(ProtocolMode::BINARY);
+
+    TEST_ASSERT_FALSE(txQueue.addReply(TxReply::HELLO));
+    TEST_ASSERT_FALSE(txQueue.addReply(TxReply::BAUD_FAIL));
+    sendControl(TokenId::EV_BIN);
+    sendControl(TokenId::EV_BAUD, "123");       // nicht unterstützt; FAIL nur im Klartext
+    TEST_ASSERT_EQUAL(0, txQueue.getCount());
+    TEST_ASSERT_EQUAL(0, txQueue.getDropped());
+}
+
+
+void test_binaryModeStartsAfterBinOkIsSent() {
+    sendControl(TokenId::EV_BIN);
+    TEST_ASSERT_FALSE(protocol.isBinary());
+    txQueue.addTimeSync(0x1234);                // steht hinter der Bestätigung
+
+    txQueue.flush();
+    TEST_ASSERT_EQUAL_STRING("CTRL;BIN;OK\r\n", Serial.hostTakeOutput().c_str());
+    TEST_ASSERT_TRUE(protocol.isBinary());
+    TEST_ASSERT_EQUAL(1, txQueue.getCount());
+
+    txQueue.flush();                            // die folgende Nachricht schon als Frame
+    const std::string frame = Serial.hostTakeOutput();
+    TEST_ASSERT_TRUE(frame.size() > 0);
+    TEST_ASSERT_EQUAL('\0', frame[frame.size() - 1]);
+    TEST_ASSERT_EQUAL(std::string::npos, frame.find("S;T;"));
+}
+
+
+void test_baudSwitchWaitsUntilReplyIsSent() {
+    sendControl(TokenId::EV_BAUD, "500");
+    txQueue.addTimeSync(1);
+
+    txQueue.flush();
+    TEST_ASSERT_TRUE(linkSpeed.isSwitching());
+    TEST_ASSERT_EQUAL(1, txQueue.getCount());
+
+    // Solange die Bestätigung im Sendepuffer steht, wird weder umgeschaltet noch weiter gesendet
+    linkSpeed.update(10);
+    txQueue.flush();
+    TEST_ASSERT_TRUE(linkSpeed.isSwitching());
+    TEST_ASSERT_EQUAL(SERIAL_DEFAULT_BAUDRATE, Serial.hostGetBaudRate());
+    TEST_ASSERT_EQUAL_STRING("CTRL;BAUD;500\r\n", Serial.hostTakeOutput().c_str());
+
+    linkSpeed.update(20);
+    TEST_ASSERT_FALSE(linkSpeed.isSwitching());
+    TEST_ASSERT_TRUE(linkSpeed.isVerifying());
+    TEST_ASSERT_EQUAL(500000UL, Serial.hostGetBaudRate());
+    txQueue.flush();
+    TEST_ASSERT_EQUAL_STRING("S;T;1\r\nCTRL;TEST;U*U*U*\r\n", Serial.hostTakeOutput().c_str());
+    TEST_ASSERT_EQUAL(0, Serial.hostGetBlockedWrites());
+}
+
+
+void test_switchStormIsRetriedOverSeveralPasses() {
+    scheduler = SchedulerClass();
+    eventQueue = EventQueueClass();
+    heartbeat = HeartbeatClass();
+    setup();
+    switches.setDiodesFitted(true);             // sonst würden die meisten Schalter als Geisterschaltungen zurückgehalten
+    txQueue.flush();
+    Serial.hostTakeOutput();
+
+    // Alle 32 Schalter schließen und in einer einzigen Abfrage erfassen
+    uint16_t expected = 0;
+    for (uint8_t row = 0; row < SWITCH_MATRIX_ROWS; ++row) {
+        for (uint8_t col = 0; col < SWITCH_MATRIX_COLS; ++col) {
+            hostSetContact(HW_MATRIX_ROWS_LSB_PIN + row, HW_MATRIX_COLS_LSB_PIN + col, true);
+            expected += devices.ownsSwitch(row, col) ? 0 : 1;  // Tasten der Geräte verarbeitet das Gerät selbst
+        }
+    }
+    TEST_ASSERT_GREATER_THAN(TX_QUEUE_SIZE, expected);
+    hostAdvanceMillis(100);
+    switches.scanSwitchPins(millis());
+    TEST_ASSERT_FALSE(switches.transmitStatus(TRANSMIT_ONLY_CHANGED_SWITCHES));
+    TEST_ASSERT_FALSE(txQueue.canAddSwitchEvent());
+    TEST_ASSERT_EQUAL(0, txQueue.getDropped());
+    scheduler.trigger(transmitTask);            // wie scanSwitches() nach der Abfrage
+
+    // Der PC liest nicht: je Durchlauf wird nur nachgefüllt, was frei ist; gewartet wird nie
+    for (uint8_t pass = 0; pass < 50; ++pass) {
+        loop();
+        hostAdvanceMicros(250);
+        TEST_ASSERT_EQUAL(0, Serial.hostGetBlockedWrites());
+    }
+    TEST_ASSERT_LESS_THAN(static_cast<int>(strlen("S;S;ON;0;0\r\n")), Serial.availableForWrite());   // keine ganze Zeile passt mehr
+    TEST_ASSERT_TRUE(txQueue.isFull());
+    TEST_ASSERT_EQUAL(0, txQueue.getDropped());
+
+    // Der PC liest wieder: der Rest kommt über die erneut angestoßene Aufgabe nach
+    std::string sent = Serial.hostTakeOutput();
+    uint16_t passes = 0;
+    while ((countLines(sent, "S;S;ON;") < expected) && (passes < 1000)) {
+        loop();
+        hostAdvanceMicros(250);
+        sent += Serial.hostTakeOutput();
+        ++passes;
+    }
+    TEST_ASSERT_EQUAL(expected, countLines(sent, "S;S;ON;"));
+    TEST_ASSERT_GREATER_THAN(1, passes);
+    TEST_ASSERT_EQUAL(0, txQueue.getDropped());
+    TEST_ASSERT_EQUAL(0, Serial.hostGetBlockedWrites());
+}
+
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_messagesAreSentInOrder);
+    RUN_TEST(test_fullQueueDropsAndCounts);
+    RUN_TEST(test_reportsLeaveRoomForSwitchEvents);
+    RUN_TEST(test_fullSerialBufferNeverBlocks);
+    RUN_TEST(test_switchStormIsRetriedOverSeveralPasses);
+    RUN_TEST(test_binaryFlushSendsOneFrame);
+    RUN_TEST(test_textRepliesAreDroppedInBinaryMode);
+    RUN_TEST(test_binaryModeStartsAfterBinOkIsSent);
+    RUN_TEST(test_baudSwitchWaitsUntilReplyIsSent);
+    return UNITY_END();
+}
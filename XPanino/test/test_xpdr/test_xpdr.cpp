@@ -0,0 +1,354 @@
+/*********************************************************************************************************//**
+ * @file test_xpdr.cpp
+ * @author Christian Harraeus <christian@harraeus.de>
+ * @brief Szenarien der Bedienung des Transponders KT76C (siehe KT76C.md) mit simulierter Zeit.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ *
+ * Die Tasten werden direkt per onSwitch() betätigt, die Zeit läuft über die Zeitstempel von onSwitch() und
+ * tick(). Die Meldungen an den PC werden im Klartextprotokoll aus der Sendewarteschlange gelesen.
+ *
+ ************************************************************************************************************/
+
+#include <unity.h>
+#include <devices.hpp>
+#include <txqueue.hpp>
+
+extern LedMatrix leds;
+extern SwitchMatrix switches;
+extern TxQueueClass txQueue;
+
+const uint8_t SELECTOR_ROW = 0;     ///< Matrixzeile des Betriebsmodus-Wahlschalters
+const uint8_t SELECTOR_COL = 3;     ///< Matrixspalte der Stellung OFF, die weiteren Stellungen folgen
+const uint8_t DIGIT_ROW = 1;        ///< Matrixzeile der Code-Entry-Tasten 0 bis 7
+const uint8_t VFR_ROW = 0;          ///< Position der Taste VFR
+const uint8_t VFR_COL = 1;
+const uint8_t IDT_ROW = 0;          ///< Position der Taste IDT
+const uint8_t IDT_COL = 0;
+
+
+/// Den Betriebsmodus-Wahlschalter in eine Stellung drehen: die alte Stellung öffnet, die neue schließt.
+static void turnSelector(TransponderKT76C &xpdr, const XpdrMode mode, const unsigned long now) {
+    for (uint8_t col = SELECTOR_COL; col < XPDR_KEY_COLS; ++col) {
+        xpdr.onSwitch(SELECTOR_ROW, col, 0, now);
+    }
+    xpdr.onSwitch(SELECTOR_ROW, SELECTOR_COL + static_cast<uint8_t>(mode), 1, now);
+}
+
+
+/// Eine Taste kurz drücken.
+static void tap(TransponderKT76C &xpdr, const uint8_t row, const uint8_t col, const unsigned long now) {
+    xpdr.onSwitch(row, col, 1, now);
+    xpdr.onSwitch(row, col, 0, now);
+}
+
+
+/// Ziffern über die Code-Entry-Tasten eingeben (0 bis 7 in Zeile 1, Spalten 0 bis 7).
+static void enterDigits(TransponderKT76C &xpdr, const char *digits, const unsigned long now) {
+    for (const char *digit = digits; *digit != '\0'; ++digit) {
+        const uint8_t value = static_cast<uint8_t>(*digit - '0');
+        tap(xpdr, DIGIT_ROW, value, now);
+    }
+}
+
+
+/// Ein Event vom PC an den Transponder übergeben.
+static void receive(TransponderKT76C &xpdr, const TokenId eventId, const char *parameter) {
+    EventClass event;
+    event.deviceId = TokenId::DEV_XPDR;
+    event.eventId = eventId;
+    strcpy(event.parameter1, parameter);
+    xpdr.processEvent(&event);
+}
+
+
+/// Die Sendewarteschlange leeren und alles Gesendete liefern.
+static std::string transmitted() {
+    std::string sent;
+    for (uint8_t i = 0; (i < TX_QUEUE_SIZE) && (txQueue.getCount() > 0); ++i) {
+        txQueue.flush();
+        sent += Serial.hostTakeOutput();
+    }
+    return sent;
+}
+
+
+/// Prüfen, ob ein Display-Feld des Transponders (je Stelle eine Zeile der LED-Matrix ab Col 8) den Text
+/// ohne Dezimalpunkte zeigt.
+static bool isDisplayed(const uint8_t firstRow, const char *text) {
+    const Led7SegmentCharMap charMap;
+    for (uint8_t i = 0; text[i] != '\0'; ++i) {
+        if (((leds.getStateWord(firstRow + i) >> 8) & 0x7F) != charMap.get7SegBitMap(text[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+static bool contains(const std::string &text, const char *part) { return text.find(part) != std::string::npos; }
+
+
+void setUp() {
+    hostReset();
+    txQueue = TxQueueClass();
+}
+
+void tearDown() {}
+
+
+/*********************************************************************************************************//**
+ * Eingabe des Codes
+ ************************************************************************************************************/
+
+void test_codeBecomesActiveWithFourthDigit() {
+    TransponderKT76C xpdr;
+    turnSelector(xpdr, XpdrMode::SBY, 0);
+    xpdr.tick(0);
+    transmitted();
+
+    enterDigits(xpdr, "123", 1000);
+    xpdr.tick(1000);
+    TEST_ASSERT_EQUAL_STRING("7000", xpdr.getCode());
+    enterDigits(xpdr, "4", 4999);   // jede Taste startet die 4 Sekunden neu
+    xpdr.tick(4999);
+    TEST_ASSERT_EQUAL_STRING("1234", xpdr.getCode());
+    TEST_ASSERT_TRUE(contains(transmitted(), "X;CODE;1234\r\n"));
+}
+
+
+void test_incompleteEntryRevertsAfterFourSeconds() {
+    TransponderKT76C xpdr;
+    turnSelector(xpdr, XpdrMode::SBY, 0);
+
+    enterDigits(xpdr, "12", 1000);
+    xpdr.tick(4999);
+    xpdr.show();
+    TEST_ASSERT_TRUE(isDisplayed(3, "12--"));
+    xpdr.tick(5000);
+    xpdr.show();
+    TEST_ASSERT_TRUE(isDisplayed(3, "7000"));
+
+    // Die verworfenen Stellen zählen nicht mehr mit
+    enterDigits(xpdr, "4321", 6000);
+    TEST_ASSERT_EQUAL_STRING("4321", xpdr.getCode());
+}
+
+
+/*********************************************************************************************************//**
+ * VFR-Taste
+ ************************************************************************************************************/
+
+void test_vfrShortSetsVfrCode() {
+    TransponderKT76C xpdr;
+    turnSelector(xpdr, XpdrMode::SBY, 0);
+    enterDigits(xpdr, "1234", 1000);
+    xpdr.tick(1000);
+    transmitted();
+
+    xpdr.onSwitch(VFR_ROW, VFR_COL, 1, 2000);
+    xpdr.tick(2500);
+    TEST_ASSERT_EQUAL_STRING("1234", xpdr.getCode());   // VFR kurz löst erst beim Loslassen aus
+    xpdr.onSwitch(VFR_ROW, VFR_COL, 0, 2500);
+    xpdr.tick(2500);
+    TEST_ASSERT_EQUAL_STRING("7000", xpdr.getCode());
+    TEST_ASSERT_TRUE(contains(transmitted(), "X;CODE;7000\r\n"));
+}
+
+
+void test_vfrLongRestoresPreviousCode() {
+    TransponderKT76C xpdr;
+    turnSelector(xpdr, XpdrMode::SBY, 0);
+    enterDigits(xpdr, "1234", 1000);
+    tap(xpdr, VFR_ROW, VFR_COL, 2000);
+    TEST_ASSERT_EQUAL_STRING("7000", xpdr.getCode());
+
+    xpdr.onSwitch(VFR_ROW, VFR_COL, 1, 10000);
+    xpdr.tick(11999);
+    TEST_ASSERT_EQUAL_STRING("7000", xpdr.getCode());
+    xpdr.tick(12000);
+    TEST_ASSERT_EQUAL_STRING("1234", xpdr.getCode());
+    xpdr.onSwitch(VFR_ROW, VFR_COL, 0, 12500);  // Loslassen nach VFR lang: nicht zusätzlich VFR kurz
+    xpdr.tick(12500);
+    TEST_ASSERT_EQUAL_STRING("1234", xpdr.getCode());
+}
+
+
+void test_vfrLongIsTimedFromThePressWhileKeysAreLocked() {
+    TransponderKT76C xpdr;
+    turnSelector(xpdr, XpdrMode::SBY, 0);
+    receive(xpdr, TokenId::EV_CODE, "1234");    // vom PC: der vorherige Code bleibt 7000
+    xpdr.setLinkUp(false);
+
+    xpdr.onSwitch(VFR_ROW, VFR_COL, 1, 10000);  // ohne Flugsimulator gedrückt und festgehalten
+    xpdr.setLinkUp(true);
+    xpdr.tick(11999);
+    TEST_ASSERT_EQUAL_STRING("1234", xpdr.getCode());
+    xpdr.tick(12000);
+    TEST_ASSERT_EQUAL_STRING("7000", xpdr.getCode());
+}
+
+
+/*********************************************************************************************************//**
+ * IDT, Lampentest und Flightlevel
+ ************************************************************************************************************/
+
+void test_identLightsReplyIndicatorForEighteenSeconds() {
+    TransponderKT76C xpdr;
+    turnSelector(xpdr, XpdrMode::ON, 0);
+    xpdr.tick(0);
+    xpdr.show();
+    TEST_ASSERT_FALSE(leds.isLedOn(XPDR_LED_R));
+    transmitted();
+
+    tap(xpdr, IDT_ROW, IDT_COL, 1000);
+    xpdr.tick(1000);
+    xpdr.show();
+    TEST_ASSERT_TRUE(leds.isLedOn(XPDR_LED_R));
+    TEST_ASSERT_TRUE(contains(transmitted(), "X;IDT\r\n"));
+    xpdr.tick(18999);
+    xpdr.show();
+    TEST_ASSERT_TRUE(leds.isLedOn(XPDR_LED_R));
+    xpdr.tick(19000);
+    xpdr.show();
+    TEST_ASSERT_FALSE(leds.isLedOn(XPDR_LED_R));
+}
+
+
+void test_identIsIgnoredInStandby() {
+    TransponderKT76C xpdr;
+    turnSelector(xpdr, XpdrMode::SBY, 0);
+    xpdr.tick(0);
+    transmitted();
+
+    tap(xpdr, IDT_ROW, IDT_COL, 1000);
+    xpdr.tick(1000);
+    TEST_ASSERT_FALSE(contains(transmitted(), "X;IDT"));
+}
+
+
+void test_lampTestFallsBackToStandbyAfterFourSeconds() {
+    TransponderKT76C xpdr;
+    turnSelector(xpdr, XpdrMode::SBY, 0);
+    xpdr.tick(0);
+    transmitted();
+
+    turnSelector(xpdr, XpdrMode::TST, 1000);
+    xpdr.tick(1000);
+    TEST_ASSERT_EQUAL(XpdrMode::TST, xpdr.getMode());
+    TEST_ASSERT_TRUE(contains(transmitted(), "X;MODE;TST\r\n"));
+    xpdr.show();
+    TEST_ASSERT_TRUE(isDisplayed(3, "8888"));
+    xpdr.tick(4999);
+    TEST_ASSERT_EQUAL(XpdrMode::TST, xpdr.getMode());
+    xpdr.tick(5000);
+    TEST_ASSERT_EQUAL(XpdrMode::SBY, xpdr.getMode());
+    TEST_ASSERT_TRUE(contains(transmitted(), "X;MODE;SBY\r\n"));
+}
+
+
+void test_powerOnInTestPositionStartsInStandby() {
+    TransponderKT76C xpdr;
+    xpdr.setBusPower(false, false, false);
+    turnSelector(xpdr, XpdrMode::TST, 0);
+    TEST_ASSERT_EQUAL(XpdrMode::OFF, xpdr.getMode());
+    xpdr.setBusPower(true, true, true);
+    TEST_ASSERT_EQUAL(XpdrMode::SBY, xpdr.getMode());
+}
+
+
+void test_flightLevelIsClamped() {
+    TransponderKT76C xpdr;
+    turnSelector(xpdr, XpdrMode::ALT, 0);
+
+    receive(xpdr, TokenId::EV_F, "85");
+    xpdr.show();
+    TEST_ASSERT_TRUE(isDisplayed(0, "085"));
+    receive(xpdr, TokenId::EV_F, "1500");
+    xpdr.show();
+    TEST_ASSERT_TRUE(isDisplayed(0, "999"));
+    receive(xpdr, TokenId::EV_F, "-50");
+    xpdr.show();
+    TEST_ASSERT_TRUE(isDisplayed(0, "-10"));
+}
+
+
+/*********************************************************************************************************//**
+ * Meldungen an den PC und Start
+ ************************************************************************************************************/
+
+void test_reportWaitsForQueueSpaceAndCarriesCurrentValue() {
+    TransponderKT76C xpdr;
+    turnSelector(xpdr, XpdrMode::SBY, 0);
+    xpdr.tick(0);
+    transmitted();
+    while (! txQueue.isFull()) {
+        txQueue.addTimeSync(0);
+    }
+
+    enterDigits(xpdr, "1234", 1000);
+    xpdr.tick(1000);
+    enterDigits(xpdr, "5670", 1100);
+    xpdr.tick(1100);
+    TEST_ASSERT_EQUAL(0, txQueue.getDropped());
+    const std::string blocked = transmitted();
+    TEST_ASSERT_FALSE(contains(blocked, "X;CODE"));
+
+    xpdr.tick(1200);
+    const std::string sent = transmitted();
+    TEST_ASSERT_TRUE(contains(sent, "X;CODE;5670\r\n"));
+    TEST_ASSERT_FALSE(contains(sent, "X;CODE;1234"));
+}
+
+
+void test_reportsAreRepeatedAfterReconnect() {
+    TransponderKT76C xpdr;
+    turnSelector(xpdr, XpdrMode::ON, 0);
+    xpdr.tick(0);
+    transmitted();
+
+    xpdr.setLinkUp(false);
+    xpdr.tick(100);
+    TEST_ASSERT_EQUAL(0, txQueue.getCount());
+    xpdr.setLinkUp(true);
+    xpdr.tick(200);
+    const std::string sent = transmitted();
+    TEST_ASSERT_TRUE(contains(sent, "X;MODE;ON\r\n"));
+    TEST_ASSERT_TRUE(contains(sent, "X;CODE;7000\r\n"));
+}
+
+
+void test_bootSelectorPositionReachesTransponderAndIsMaskedInSnapshot() {
+    // Wahlschalter in Stellung ON (Zeile 0, Spalte 6) und ein Schalter, der nicht zum Transponder gehört
+    hostSetContact(HW_MATRIX_ROWS_LSB_PIN + SELECTOR_ROW,
+                   HW_MATRIX_COLS_LSB_PIN + SELECTOR_COL + static_cast<uint8_t>(XpdrMode::ON), true);
+    hostSetContact(HW_MATRIX_ROWS_LSB_PIN + 3, HW_MATRIX_COLS_LSB_PIN + 0, true);
+    switches.initHardware();
+    switches.scanSwitchPins(1000);
+    switches.feedDevices(1000);
+    TEST_ASSERT_EQUAL(XpdrMode::ON, devices.get<TransponderKT76C>().getMode());
+
+    switches.transmitSnapshot();
+    TEST_ASSERT_TRUE(contains(transmitted(), "S;M;00000001\r\n"));
+}
+
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_codeBecomesActiveWithFourthDigit);
+    RUN_TEST(test_incompleteEntryRevertsAfterFourSeconds);
+    RUN_TEST(test_vfrShortSetsVfrCode);
+    RUN_TEST(test_vfrLongRestoresPreviousCode);
+    RUN_TEST(test_vfrLongIsTimedFromThePressWhileKeysAreLocked);
+    RUN_TEST(test_identLightsReplyIndicatorForEighteenSeconds);
+    RUN_TEST(test_identIsIgnoredInStandby);
+    RUN_TEST(test_lampTestFallsBackToStandbyAfterFourSeconds);
+    RUN_TEST(test_powerOnInTestPositionStartsInStandby);
+    RUN_TEST(test_flightLevelIsClamped);
+    RUN_TEST(test_reportWaitsForQueueSpaceAndCarriesCurrentValue);
+    RUN_TEST(test_reportsAreRepeatedAfterReconnect);
+    RUN_TEST(test_bootSelectorPositionReachesTransponderAndIsMaskedInSnapshot);
+    return UNITY_END();
+}
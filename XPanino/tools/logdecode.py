@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""Log-Meldungen des XPanino lesbar machen.
+
+Der Arduino sendet von jeder Log-Meldung nur die ID und zwei Argumente:
+im Klartextprotokoll als Zeile ``L;<ID>;<Arg0 hex>;<Arg1 hex>``, im Binärprotokoll
+als Record ``LOG_MESSAGE`` (0x1F03). Dieses Programm liest das Wörterbuch
+``src/logdict.hpp`` und setzt die Texte wieder ein.
+
+Aufrufe::
+
+    logdecode.py mitschnitt.txt             # Klartext-Mitschnitt
+    logdecode.py --binary mitschnitt.bin    # Rohdaten im Binärprotokoll
+    logdecode.py --dict                     # Wörterbuch als JSON ausgeben
+
+Ohne Datei wird von der Standardeingabe gelesen.
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+
+LOG_MESSAGE = 0x1F03
+DEFAULT_DICT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "src", "logdict.hpp")
+ENTRY = re.compile(r'X\((\w+),\s*LOG_LEVEL_(\w+),\s*"((?:[^"\\]|\\.)*)"\)')
+
+
+def load_dictionary(path):
+    """Die Meldungen aus logdict.hpp lesen; die ID ist die Position in der Liste."""
+    with open(path, encoding="utf-8") as file:
+        text = file.read()
+    return [{"id": index, "name": name, "level": level, "text": message}
+            for index, (name, level, message) in enumerate(ENTRY.findall(text))]
+
+
+def format_message(dictionary, log_id, arg0, arg1):
+    if log_id >= len(dictionary):
+        return "?????  unbekannte Meldung {} ({}, {})".format(log_id, arg0, arg1)
+    entry = dictionary[log_id]
+    return "{:<5}  {:<17}  {}".format(entry["level"], entry["name"], entry["text"].format(arg0, arg1))
+
+
+def decode_ascii(stream, dictionary):
+    """Zeilen ``L;id;a;b`` ersetzen, alle anderen Zeilen unverändert ausgeben."""
+    for raw in stream:
+        line = raw.decode("latin-1").rstrip("\r\n")
+        fields = line.split(";")
+        if len(fields) == 4 and fields[0] == "L":
+            try:
+                yield format_message(dictionary, int(fields[1]), int(fields[2], 16), int(fields[3], 16))
+                continue
+            except ValueError:
+                pass
+        yield line
+
+
+def crc8(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def cobs_decode(frame):
+    out = bytearray()
+    pos = 0
+    while pos < len(frame):
+        code = frame[pos]
+        pos += 1
+        if code == 0 or pos + code - 1 > len(frame):
+            return None
+        out += frame[pos:pos + code - 1]
+        pos += code - 1
+        if code != 0xFF and pos < len(frame):
+            out.append(0)
+    return bytes(out)
+
+
+def decode_binary(data, dictionary):
+    """Frames (COBS, CRC-8) zerlegen und die Records LOG_MESSAGE ausgeben."""
+    for frame in data.split(b"\x00"):
+        if not frame:
+            continue
+        decoded = cobs_decode(frame)
+        if not decoded or crc8(decoded[:-1]) != decoded[-1]:
+            yield "-----  Frame fehlerhaft ({} Bytes)".format(len(frame))
+            continue
+        records = decoded[:-1]
+        pos = 0
+        while pos + 3 <= len(records):
+            opcode = (records[pos] << 8) | records[pos + 1]
+            length = records[pos + 2]
+            payload = records[pos + 3:pos + 3 + length]
+            pos += 3 + length
+            if opcode == LOG_MESSAGE and len(payload) == 5:
+                yield format_message(dictionary, payload[0], (payload[1] << 8) | payload[2],
+                                     (payload[3] << 8) | payload[4])
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Log-Meldungen des XPanino dekodieren.")
+    parser.add_argument("file", nargs="?", help="Mitschnitt der seriellen Schnittstelle (sonst stdin)")
+    parser.add_argument("--binary", action="store_true", help="Mitschnitt im Binärprotokoll")
+    parser.add_argument("--dict", action="store_true", help="Wörterbuch als JSON ausgeben")
+    parser.add_argument("--logdict", default=DEFAULT_DICT, help="Pfad zu logdict.hpp")
+    args = parser.parse_args()
+
+    dictionary = load_dictionary(args.logdict)
+    if args.dict:
+        json.dump(dictionary, sys.stdout, ensure_ascii=False, indent=2)
+        print()
+        return
+
+    stream = open(args.file, "rb") if args.file else sys.stdin.buffer
+    with stream:
+        lines = decode_binary(stream.read(), dictionary) if args.binary else decode_ascii(stream, dictionary)
+        for line in lines:
+            print(line)
+
+
+if __name__ == "__main__":
+    main()
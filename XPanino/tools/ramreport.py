@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""Statischen RAM (.data und .bss) der XPanino-Firmware je Objekt bzw. Klasse auflisten.
+
+Die globalen Objekte aus src/main.cpp (z.B. ``LedMatrix leds;``) werden ihrer Klasse zugeordnet,
+alle anderen Symbole ihrer Quelldatei (nur mit Debug-Informationen) oder dem Arduino-Core.
+
+Als PlatformIO-Skript läuft es nach jedem Bauen (``extra_scripts = post:tools/ramreport.py``),
+von Hand mit::
+
+    ramreport.py .pio/build/unodebug/firmware.elf [--nm avr-nm]
+"""
+
+import os
+import re
+import subprocess
+import sys
+from collections import defaultdict
+
+RAM_SIZE = 2048
+GLOBAL_OBJECT = re.compile(r"^(\w+)\s+(\w+)\s*;", re.MULTILINE)
+
+
+def load_global_objects(path):
+    """Name des globalen Objekts -> Klasse, aus main.cpp."""
+    try:
+        with open(path, encoding="utf-8") as file:
+            return {name: cls for cls, name in GLOBAL_OBJECT.findall(file.read())}
+    except OSError:
+        return {}
+
+
+def read_symbols(elf, nm):
+    """Symbole in .data und .bss: (Name, Größe, Quelldatei oder None)."""
+    output = subprocess.run([nm, "-C", "-S", "-l", "--size-sort", elf], check=True,
+                            capture_output=True, text=True).stdout
+    for line in output.splitlines():
+        parts = line.split(None, 3)
+        if len(parts) < 4 or parts[2] not in "bBdD":
+            continue
+        name, _, location = parts[3].partition("\t")
+        source = os.path.basename(location.rsplit(":", 1)[0]) if location else None
+        yield name.strip(), int(parts[1], 16), source
+
+
+def report(elf, nm, main_cpp):
+    objects = load_global_objects(main_cpp)
+    groups = defaultdict(int)
+    for name, size, source in read_symbols(elf, nm):
+        if name in objects:
+            group = "{} ({})".format(objects[name], name)
+        elif source and not source.startswith(("wiring", "HardwareSerial", "hooks", "new")):
+            group = source
+        else:
+            group = "Arduino-Core/Sonstige"
+        groups[group] += size
+    total = sum(groups.values())
+    print("Statischer RAM je Objekt bzw. Quelldatei (.data + .bss):")
+    for group, size in sorted(groups.items(), key=lambda item: -item[1]):
+        print("  {:<40} {:5d} Bytes".format(group, size))
+    print("  {:<40} {:5d} Bytes von {} ({} frei für Heap und Stack)".format(
+        "Summe", total, RAM_SIZE, RAM_SIZE - total))
+
+
+def platformio_hook(env):
+    """Als PlatformIO-Skript: den Bericht nach dem Linken ausgeben."""
+    toolchain = env.PioPlatform().get_package_dir("toolchain-atmelavr")
+    nm = os.path.join(toolchain, "bin", "avr-nm")
+    main_cpp = os.path.join(env.subst("$PROJECT_SRC_DIR"), "main.cpp")
+
+    def after_link(target, source, env):
+        report(str(target[0]), nm, main_cpp)
+
+    env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", after_link)
+
+
+if __name__ == "__main__":
+    arguments = sys.argv[1:]
+    nm_tool = "avr-nm"
+    if "--nm" in arguments:
+        index = arguments.index("--nm")
+        nm_tool = arguments[index + 1]
+        del arguments[index:index + 2]
+    if len(arguments) != 1:
+        sys.exit(__doc__)
+    report(arguments[0], nm_tool, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "src", "main.cpp"))
+else:
+    Import("env")   # noqa: F821 - wird von PlatformIO (SCons) bereitgestellt
+    platformio_hook(env)    # noqa: F821
@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""Ablaufprotokoll des XPanino in das JSON-Format von Chrome-Tracing umwandeln.
+
+Der Mitschnitt wird mit ``CTRL;TRC;1`` gestartet und mit ``CTRL;TRC;D`` angefordert.
+Der Arduino sendet die Einträge im Klartextprotokoll als ``T;<Punkt>;<Argument>;<Zeit hex>``,
+im Binärprotokoll als Record ``TRACE_ENTRY`` (0x1F04). Die Zeit zählt in Einheiten von 4 µs
+und läuft nach 262 ms über; aufeinanderfolgende Einträge liegen im loop() weit enger beieinander.
+
+Die Ausgabe lässt sich in chrome://tracing oder https://ui.perfetto.dev öffnen::
+
+    trace2json.py mitschnitt.txt > trace.json
+    trace2json.py --binary mitschnitt.bin > trace.json
+
+Ohne Datei wird von der Standardeingabe gelesen.
+"""
+
+import argparse
+import json
+import sys
+
+from logdecode import cobs_decode, crc8
+
+TRACE_ENTRY = 0x1F04
+TIME_UNIT_US = 4
+
+# Trace-Punkte in der Reihenfolge von TracePoint (src/trace.hpp)
+POINTS = ["LOOP", "SCAN_START", "SCAN_END", "PARSE", "DISPATCH_START", "DISPATCH_END",
+          "TX_DEPTH", "REFRESH_START", "REFRESH_END", "OVERFLOW", "DUMP_END"]
+SLICES = {"SCAN_START": ("scan", "B"), "SCAN_END": ("scan", "E"),
+          "DISPATCH_START": ("dispatch", "B"), "DISPATCH_END": ("dispatch", "E"),
+          "REFRESH_START": ("refresh", "B"), "REFRESH_END": ("refresh", "E")}
+OVERFLOW_QUEUES = ["Eventqueue", "Sendewarteschlange"]
+
+
+def read_ascii(stream):
+    for raw in stream:
+        fields = raw.decode("latin-1").strip().split(";")
+        if len(fields) == 4 and fields[0] == "T":
+            try:
+                yield int(fields[1]), int(fields[2]), int(fields[3], 16)
+            except ValueError:
+                pass
+
+
+def read_binary(data):
+    for frame in data.split(b"\x00"):
+        decoded = cobs_decode(frame) if frame else None
+        if not decoded or crc8(decoded[:-1]) != decoded[-1]:
+            continue
+        records = decoded[:-1]
+        pos = 0
+        while pos + 3 <= len(records):
+            opcode = (records[pos] << 8) | records[pos + 1]
+            length = records[pos + 2]
+            payload = records[pos + 3:pos + 3 + length]
+            pos += 3 + length
+            if opcode == TRACE_ENTRY and len(payload) == 4:
+                yield payload[0], payload[1], (payload[2] << 8) | payload[3]
+
+
+def to_chrome(entries):
+    """Einträge in Chrome-Trace-Events umwandeln; die Zeit wird fortlaufend in µs gezählt."""
+    events = []
+    overwritten = 0
+    last_raw = None
+    time_us = 0
+    loop_start = None
+    for point_id, arg, raw in entries:
+        point = POINTS[point_id] if point_id < len(POINTS) else "POINT_{}".format(point_id)
+        if point == "DUMP_END":
+            overwritten = arg
+            break
+        if last_raw is not None:
+            time_us += ((raw - last_raw) & 0xFFFF) * TIME_UNIT_US
+        last_raw = raw
+        base = {"pid": 1, "tid": 1, "ts": time_us}
+        if point in SLICES:
+            name, phase = SLICES[point]
+            events.append(dict(base, name=name, ph=phase))
+        elif point == "LOOP":
+            if loop_start is not None:
+                events.append({"pid": 1, "tid": 0, "ts": loop_start, "dur": time_us - loop_start,
+                               "name": "loop", "ph": "X"})
+            loop_start = time_us
+        elif point == "TX_DEPTH":
+            events.append(dict(base, name="TX-Warteschlange", ph="C", args={"Nachrichten": arg}))
+        elif point == "OVERFLOW":
+            queue = OVERFLOW_QUEUES[arg] if arg < len(OVERFLOW_QUEUES) else str(arg)
+            events.append(dict(base, name="Überlauf " + queue, ph="i", s="g"))
+        else:
+            events.append(dict(base, name=point.lower(), ph="i", s="t", args={"arg": arg}))
+    events.append({"pid": 1, "tid": 0, "name": "thread_name", "ph": "M", "args": {"name": "loop()"}})
+    events.append({"pid": 1, "tid": 1, "name": "thread_name", "ph": "M", "args": {"name": "Abschnitte"}})
+    return {"traceEvents": events, "displayTimeUnit": "ms",
+            "otherData": {"Quelle": "XPanino", "überschriebene Einträge": overwritten}}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Ablaufprotokoll des XPanino nach Chrome-Trace-JSON wandeln.")
+    parser.add_argument("file", nargs="?", help="Mitschnitt der seriellen Schnittstelle (sonst stdin)")
+    parser.add_argument("--binary", action="store_true", help="Mitschnitt im Binärprotokoll")
+    args = parser.parse_args()
+
+    stream = open(args.file, "rb") if args.file else sys.stdin.buffer
+    with stream:
+        entries = list(read_binary(stream.read()) if args.binary else read_ascii(stream))
+    json.dump(to_chrome(entries), sys.stdout, ensure_ascii=False, indent=1)
+    print()
+
+
+if __name__ == "__main__":
+    main()